@@ -0,0 +1,235 @@
+// ─── native8080_macrobench ────────────────────────────────────────────────────
+// Runs the self-checking workload corpus (bench/workloads/*.asm, assembled by
+// native8080_asm at build time) under the CP/M shim and reports emulated MIPS
+// and MHz per workload.
+//
+// Instruction and cycle counts are deterministic; the reported time is the
+// median of several repetitions.  Every workload run starts from a freshly
+// loaded machine.  A workload
+// whose console output is not exactly "PASS" fails the run.
+//
+// --track-writes N also runs every workload with the last-writer index
+// (writes.h) recording N writers per byte, reported as engine "tracked" next
+// to the plain run together with the slowdown.
+//
+// --aot also runs every workload on its ahead-of-time translation (aot.h;
+// the build translates the corpus and links it in), reported as engine "aot"
+// together with the speed-up.  Counts must match the interpreted run.
+
+#include "aot.h"
+#include "cpm.h"
+#include "cpu8080.h"
+#include "report.h"
+#include "runner.h"
+#include "writes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef NATIVE8080_WORKLOAD_DIR
+#define NATIVE8080_WORKLOAD_DIR "workloads"
+#endif
+
+namespace {
+
+struct Outcome {
+    uint64_t    instructions = 0;      // per workload run
+    uint64_t    cycles       = 0;
+    double      seconds      = 0.0;    // median seconds per workload run
+    bool        passed       = false;
+    std::string output;
+    std::vector<double> samples;       // seconds per workload run, per repetition
+};
+
+// Safety net: no workload comes close to this, so hitting it means a hang.
+constexpr uint64_t MAX_CYCLES = 10'000'000'000ULL;
+
+// How a workload is run: plain, with the write index, or translated.
+struct Variant {
+    const char* engine;
+    unsigned    track_depth;
+    bool        aot;
+};
+
+// Load and run the workload once on a fresh machine; returns the run time.
+double run_once(const std::string& path, const Variant& v, Outcome& out) {
+    State8080 state;
+    IOBus     io;
+    CpmShim   cpm(nullptr);
+    std::string console;
+    cpm.capture_to(&console);
+    cpm.setup(state);
+    LoadBinary(state, path.c_str(), CpmShim::TPA);
+    state.PC = CpmShim::TPA;
+
+    Runner runner(state, io);
+    cpm.attach(runner);
+
+    std::optional<WriteIndex>   index;
+    std::optional<WriteTracker> tracker;
+    if (v.track_depth) {
+        index.emplace(v.track_depth);
+        tracker.emplace(runner, *index);
+    }
+    if (v.aot) {
+        const AotProgram* program = FindAotProgram(state);
+        if (!program) throw std::runtime_error("no translation linked in");
+        runner.set_translation(program);
+    }
+
+    RunLimits limits;
+    limits.max_cycles = MAX_CYCLES;
+
+    auto t0 = std::chrono::steady_clock::now();
+    StopReason reason = runner.run(limits);
+    auto t1 = std::chrono::steady_clock::now();
+
+    out.instructions = runner.instructions();
+    out.cycles       = runner.cycles();
+    out.output       = console;
+    out.passed       = reason == StopReason::Trap && console == "PASS\n";
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+// Each repetition re-runs the workload until `min_seconds` of execution time
+// has accumulated, so short workloads still produce stable samples.
+Outcome run_workload(const std::string& path, int reps, double min_seconds, const Variant& v) {
+    Outcome out;
+    std::vector<double> samples;
+
+    for (int r = 0; r < reps && (r == 0 || out.passed); ++r) {
+        double total = 0.0;
+        int    runs  = 0;
+        do {
+            total += run_once(path, v, out);
+            ++runs;
+        } while (out.passed && total < min_seconds);
+        samples.push_back(total / runs);
+    }
+    out.samples = samples;
+    std::sort(samples.begin(), samples.end());
+    out.seconds = samples[samples.size() / 2];
+    return out;
+}
+
+void usage(const char* argv0) {
+    std::fprintf(stderr, "Usage: %s [--dir DIR] [--filter SUBSTR] [--reps N] [--min-time SECONDS]\n"
+                         "          [--json FILE] [--track-writes N] [--aot] [workload.com ...]\n", argv0);
+    std::fprintf(stderr, "  DIR defaults to %s\n", NATIVE8080_WORKLOAD_DIR);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string dir    = NATIVE8080_WORKLOAD_DIR;
+    const char* filter = nullptr;
+    const char* json   = nullptr;
+    int         reps   = 5;
+    double      min_seconds = 0.1;
+    unsigned    track_depth = 0;
+    bool        aot         = false;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--", 2) != 0) { files.push_back(argv[i]); continue; }
+        if (std::strcmp(argv[i], "--aot") == 0) { aot = true; continue; }
+        if (i + 1 >= argc) { usage(argv[0]); return 1; }
+        if      (std::strcmp(argv[i], "--dir")    == 0) dir    = argv[++i];
+        else if (std::strcmp(argv[i], "--filter") == 0) filter = argv[++i];
+        else if (std::strcmp(argv[i], "--reps")   == 0) reps   = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--json")   == 0) json   = argv[++i];
+        else if (std::strcmp(argv[i], "--min-time") == 0) min_seconds = std::strtod(argv[++i], nullptr);
+        else if (std::strcmp(argv[i], "--track-writes") == 0)
+            track_depth = std::clamp(unsigned(std::atoi(argv[++i])), 1u, WriteIndex::MAX_DEPTH);
+        else { usage(argv[0]); return 1; }
+    }
+
+    if (files.empty()) {
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(dir, ec))
+            if (entry.path().extension() == ".com") files.push_back(entry.path().string());
+        if (ec || files.empty()) {
+            std::fprintf(stderr, "No workloads found in %s\n", dir.c_str());
+            return 1;
+        }
+        std::sort(files.begin(), files.end());
+    }
+
+    const int name_width = track_depth ? 21 : aot ? 17 : 12;
+    std::printf("%-*s %14s %14s %10s %10s %12s %6s\n", name_width,
+                "workload", "instructions", "cycles", "time ms", "MIPS", "emul. MHz", "check");
+
+    std::vector<Variant> variants = {{"reference", 0, false}};
+    if (track_depth) variants.push_back({"tracked", track_depth, false});
+    if (aot)         variants.push_back({"aot", 0, true});
+
+    int failures = 0;
+    std::vector<BenchRecord> records;
+    for (const std::string& path : files) {
+        std::string name = std::filesystem::path(path).stem().string();
+        if (filter && name.find(filter) == std::string::npos) continue;
+
+        double   plain_seconds = 0.0;
+        uint64_t plain_insns = 0, plain_cycles = 0;
+        for (const Variant& v : variants) {
+            Outcome o;
+            try {
+                o = run_workload(path, reps, min_seconds, v);
+            } catch (const std::exception& e) {
+                std::fprintf(stderr, "%s: %s\n", path.c_str(), e.what());
+                ++failures;
+                break;
+            }
+
+            const bool        plain = &v == &variants.front();
+            const std::string label = plain ? name : name + " [" + v.engine + "]";
+            std::printf("%-*s %14llu %14llu %10.2f %10.1f %12.1f %6s", name_width,
+                        label.c_str(),
+                        static_cast<unsigned long long>(o.instructions),
+                        static_cast<unsigned long long>(o.cycles),
+                        o.seconds * 1e3,
+                        double(o.instructions) / o.seconds / 1e6,
+                        double(o.cycles) / o.seconds / 1e6,
+                        o.passed ? "PASS" : "FAIL");
+            if (v.track_depth) std::printf("  x%.2f", o.seconds / plain_seconds);
+            if (v.aot)         std::printf("  %.1fx faster", plain_seconds / o.seconds);
+            std::printf("\n");
+            std::fflush(stdout);
+            if (!o.passed) {
+                std::fprintf(stderr, "%s: unexpected output: %s\n", name.c_str(), o.output.c_str());
+                ++failures;
+                break;
+            }
+            if (plain) {
+                plain_seconds = o.seconds;
+                plain_insns   = o.instructions;
+                plain_cycles  = o.cycles;
+            } else if (o.instructions != plain_insns || o.cycles != plain_cycles) {
+                std::fprintf(stderr, "%s: %s run counts differ from the plain run\n", name.c_str(), v.engine);
+                ++failures;
+                break;
+            }
+
+            BenchRecord rec;
+            rec.workload             = name;
+            rec.engine               = v.engine;
+            rec.instructions         = o.instructions;
+            rec.cycles               = o.cycles;
+            rec.instructions_per_sec = double(o.instructions) / o.seconds;
+            rec.cycles_per_sec       = double(o.cycles) / o.seconds;
+            for (double sec : o.samples) rec.samples.push_back(double(o.instructions) / sec);
+            records.push_back(std::move(rec));
+        }
+    }
+
+    if (json && !WriteBenchJson(json, "macro", records)) return 1;
+    return failures ? 1 : 0;
+}
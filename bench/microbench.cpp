@@ -0,0 +1,217 @@
+// ─── native8080_bench ─────────────────────────────────────────────────────────
+// Per-instruction-group microbenchmarks for Step8080.
+//
+// Each benchmark fills memory at 0x0100 with many copies of a short
+// instruction sequence followed by a JMP back to the start, then times a
+// fixed number of Step8080 calls.  The JMP executes once per ~1 KB of body,
+// so its share of the reported time is negligible.  Results are reported as
+// host nanoseconds per emulated instruction (median of several repetitions).
+
+#include "cpu8080.h"
+#include "report.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint16_t BODY_ORG  = 0x0100;
+constexpr size_t   BODY_SIZE = 1024;      // bytes of repeated sequence
+constexpr uint16_t SUB_ORG   = 0x8000;    // subroutine target for CALL tests
+constexpr uint16_t DATA_ORG  = 0x4000;    // HL target for M-operand tests
+
+struct Bench {
+    std::string          name;
+    std::vector<uint8_t> seq;                        // repeated sequence
+    void               (*setup)(State8080&) = nullptr;
+    bool                 chain = false;              // jump operand -> next insn
+};
+
+// ── Initial states ──────────────────────────────────────────────────────────
+void setup_default(State8080& s) {
+    s.A = 0x5A; s.B = 0x12; s.C = 0x34; s.D = 0x56; s.E = 0x78;
+    s.setHL(DATA_ORG);
+    s.SP = 0xF000;
+    s.F  = FLAG_FIXED;                   // NZ, NC, PO, P
+    s.mem[DATA_ORG] = 0x3C;
+    s.mem[SUB_ORG]  = 0xC9;              // RET
+}
+
+void setup_flags_set(State8080& s) {
+    setup_default(s);
+    s.F = FLAG_FIXED | FLAG_Z | FLAG_CY | FLAG_P | FLAG_S;
+}
+
+// ── Benchmark table ─────────────────────────────────────────────────────────
+std::vector<Bench> make_benches() {
+    std::vector<Bench> v;
+
+    // Data transfer
+    v.push_back({"MOV r,r",   {0x41}, setup_default});                   // MOV B,C
+    v.push_back({"MOV r,M",   {0x46}, setup_default});                   // MOV B,M
+    v.push_back({"MOV M,r",   {0x70}, setup_default});                   // MOV M,B
+    v.push_back({"MVI r,#",   {0x06, 0x42}, setup_default});             // MVI B,42
+    v.push_back({"LXI rp,#",  {0x01, 0x34, 0x12}, setup_default});       // LXI B,1234
+    v.push_back({"LDA/STA",   {0x3A, 0x00, 0x40, 0x32, 0x01, 0x40}, setup_default});
+    v.push_back({"LHLD/SHLD", {0x2A, 0x00, 0x40, 0x22, 0x02, 0x40}, setup_default});
+    v.push_back({"XCHG",      {0xEB}, setup_default});
+
+    // ALU, register / memory / immediate forms
+    static const char* const alu[8] = {"ADD", "ADC", "SUB", "SBB", "ANA", "XRA", "ORA", "CMP"};
+    for (uint8_t op = 0; op < 8; ++op)
+        v.push_back({std::string(alu[op]) + " r", {uint8_t(0x80 | (op << 3) | 0)}, setup_default});
+    for (uint8_t op = 0; op < 8; ++op)
+        v.push_back({std::string(alu[op]) + " M", {uint8_t(0x80 | (op << 3) | 6)}, setup_default});
+    static const char* const alui[8] = {"ADI", "ACI", "SUI", "SBI", "ANI", "XRI", "ORI", "CPI"};
+    for (uint8_t op = 0; op < 8; ++op)
+        v.push_back({std::string(alui[op]) + " #", {uint8_t(0xC6 | (op << 3)), 0x3B}, setup_default});
+
+    // Increment / decrement
+    v.push_back({"INR r",  {0x04}, setup_default});
+    v.push_back({"DCR r",  {0x05}, setup_default});
+    v.push_back({"INR M",  {0x34}, setup_default});
+    v.push_back({"DCR M",  {0x35}, setup_default});
+    v.push_back({"INX rp", {0x03}, setup_default});
+    v.push_back({"DCX rp", {0x0B}, setup_default});
+
+    // 16-bit add
+    v.push_back({"DAD B",  {0x09}, setup_default});
+    v.push_back({"DAD H",  {0x29}, setup_default});
+
+    // Accumulator / rotate / decimal
+    v.push_back({"RLC",    {0x07}, setup_default});
+    v.push_back({"RAR",    {0x1F}, setup_default});
+    v.push_back({"DAA",    {0x27}, setup_default});
+
+    // Conditional branches.  Taken jumps target the next instruction so that
+    // control flow stays linear; the setup decides whether they are taken.
+    // The jump target is patched in by fill_body().
+    v.push_back({"JNZ taken",     {0xC2, 0x00, 0x00}, setup_default,   true});
+    v.push_back({"JNZ not taken", {0xC2, 0x00, 0x00}, setup_flags_set, true});
+    v.push_back({"JC taken",      {0xDA, 0x00, 0x00}, setup_flags_set, true});
+    v.push_back({"JC not taken",  {0xDA, 0x00, 0x00}, setup_default,   true});
+
+    // Subroutines: the target at SUB_ORG returns immediately.
+    v.push_back({"CALL/RET",           {0xCD, SUB_ORG & 0xFF, SUB_ORG >> 8}, setup_default});
+    v.push_back({"CNZ/RET taken",      {0xC4, SUB_ORG & 0xFF, SUB_ORG >> 8}, setup_default});
+    v.push_back({"CNZ not taken",      {0xC4, SUB_ORG & 0xFF, SUB_ORG >> 8}, setup_flags_set});
+    v.push_back({"RNZ not taken",      {0xC0}, setup_flags_set});
+
+    // Stack
+    v.push_back({"PUSH/POP B",   {0xC5, 0xC1}, setup_default});
+    v.push_back({"PUSH/POP PSW", {0xF5, 0xF1}, setup_default});
+    v.push_back({"XTHL",         {0xE3}, setup_default});
+
+    // I/O through the IOBus callbacks
+    v.push_back({"IN p",  {0xDB, 0x10}, setup_default});
+    v.push_back({"OUT p", {0xD3, 0x10}, setup_default});
+
+    v.push_back({"NOP",   {0x00}, setup_default});
+    return v;
+}
+
+// Fill the body with copies of the sequence and close it with a JMP back to
+// the start.  Chained benchmarks get their jump operand pointed at the
+// following copy.
+void fill_body(State8080& s, const Bench& b) {
+    const std::vector<uint8_t>& seq = b.seq;
+    uint16_t pc = BODY_ORG;
+    while (pc + seq.size() + 3 <= BODY_ORG + BODY_SIZE) {
+        for (size_t i = 0; i < seq.size(); ++i) s.mem[pc + i] = seq[i];
+        if (b.chain) {
+            uint16_t next = uint16_t(pc + 3);
+            s.mem[pc + 1] = next & 0xFF;
+            s.mem[pc + 2] = next >> 8;
+        }
+        pc = uint16_t(pc + seq.size());
+    }
+    s.mem[pc]     = 0xC3;                 // JMP BODY_ORG
+    s.mem[pc + 1] = BODY_ORG & 0xFF;
+    s.mem[pc + 2] = BODY_ORG >> 8;
+}
+
+struct Result {
+    double              ns_per_insn;       // median
+    double              cycles_per_insn;
+    std::vector<double> samples;           // ns per instruction, per repetition
+};
+
+Result run_bench(const Bench& b, double min_seconds, int reps) {
+    State8080 s;
+    IOBus io;
+    volatile uint8_t sink = 0;
+    io.in_handler  = [](uint8_t port) -> uint8_t { return port; };
+    io.out_handler = [&sink](uint8_t, uint8_t v) { sink = v; };
+
+    std::vector<double> samples;
+    uint64_t batch  = 1 << 16;
+    uint64_t cycles = 0, steps = 0;
+
+    for (int r = 0; r < reps; ++r) {
+        b.setup(s);
+        fill_body(s, b);
+        s.PC = BODY_ORG;
+
+        uint64_t n = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        double elapsed = 0.0;
+        do {
+            for (uint64_t i = 0; i < batch; ++i) cycles += Step8080(s, io);
+            n += batch;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        } while (elapsed < min_seconds);
+        steps += n;
+        samples.push_back(elapsed * 1e9 / double(n));
+    }
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    return {sorted[sorted.size() / 2], double(cycles) / double(steps), samples};
+}
+
+void usage(const char* argv0) {
+    std::fprintf(stderr, "Usage: %s [--filter SUBSTR] [--min-time SECONDS] [--reps N] [--json FILE]\n", argv0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* filter = nullptr;
+    const char* json   = nullptr;
+    double min_seconds = 0.1;
+    int    reps        = 5;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) { usage(argv[0]); return 1; }
+        if      (std::strcmp(argv[i], "--filter")   == 0) filter      = argv[++i];
+        else if (std::strcmp(argv[i], "--min-time") == 0) min_seconds = std::strtod(argv[++i], nullptr);
+        else if (std::strcmp(argv[i], "--reps")     == 0) reps        = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--json")     == 0) json        = argv[++i];
+        else { usage(argv[0]); return 1; }
+    }
+
+    std::vector<BenchRecord> records;
+    std::printf("%-16s %12s %10s %12s\n", "benchmark", "ns/insn", "MIPS", "cycles/insn");
+    for (const Bench& b : make_benches()) {
+        if (filter && b.name.find(filter) == std::string::npos) continue;
+        Result r = run_bench(b, min_seconds, reps);
+        std::printf("%-16s %12.2f %10.1f %12.2f\n",
+                    b.name.c_str(), r.ns_per_insn, 1e3 / r.ns_per_insn, r.cycles_per_insn);
+        std::fflush(stdout);
+
+        BenchRecord rec;
+        rec.workload             = b.name;
+        rec.engine               = "reference";
+        rec.instructions_per_sec = 1e9 / r.ns_per_insn;
+        rec.cycles_per_sec       = rec.instructions_per_sec * r.cycles_per_insn;
+        for (double ns : r.samples) rec.samples.push_back(1e9 / ns);
+        records.push_back(std::move(rec));
+    }
+
+    if (json && !WriteBenchJson(json, "micro", records)) return 1;
+    return 0;
+}
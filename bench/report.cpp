@@ -0,0 +1,94 @@
+#include "report.h"
+
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+#ifndef NATIVE8080_BUILD_TYPE
+#define NATIVE8080_BUILD_TYPE ""
+#endif
+#ifndef NATIVE8080_BUILD_FLAGS
+#define NATIVE8080_BUILD_FLAGS ""
+#endif
+
+namespace {
+
+std::string compiler_name() {
+#if defined(__clang__)
+    return "Clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "GCC " __VERSION__;
+#else
+    return "unknown";
+#endif
+}
+
+// Minimal JSON string escaping: quotes, backslashes and control characters.
+void put_string(std::FILE* f, const std::string& s) {
+    std::fputc('"', f);
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') { std::fputc('\\', f); std::fputc(c, f); }
+        else if (c < 0x20)         std::fprintf(f, "\\u%04x", c);
+        else                       std::fputc(c, f);
+    }
+    std::fputc('"', f);
+}
+
+} // namespace
+
+std::string HostCpuName() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 10, "model name") != 0) continue;
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) break;
+        size_t b = line.find_first_not_of(' ', colon + 1);
+        return b == std::string::npos ? std::string() : line.substr(b);
+    }
+    return "unknown";
+}
+
+bool WriteBenchJson(const char* path, const char* suite, const std::vector<BenchRecord>& records) {
+    std::FILE* f = std::fopen(path, "w");
+    if (!f) {
+        std::perror(path);
+        return false;
+    }
+
+    std::fprintf(f, "{\n  \"schema\": 1,\n  \"suite\": ");
+    put_string(f, suite);
+    std::fprintf(f, ",\n  \"host\": { \"cpu\": ");
+    put_string(f, HostCpuName());
+    std::fprintf(f, ", \"threads\": %u },\n", std::thread::hardware_concurrency());
+    std::fprintf(f, "  \"build\": { \"compiler\": ");
+    put_string(f, compiler_name());
+    std::fprintf(f, ", \"build_type\": ");
+    put_string(f, NATIVE8080_BUILD_TYPE);
+    std::fprintf(f, ", \"flags\": ");
+    put_string(f, NATIVE8080_BUILD_FLAGS);
+    std::fprintf(f, " },\n  \"results\": [");
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        const BenchRecord& r = records[i];
+        std::fprintf(f, "%s\n    { \"workload\": ", i ? "," : "");
+        put_string(f, r.workload);
+        std::fprintf(f, ", \"engine\": ");
+        put_string(f, r.engine);
+        std::fprintf(f, ",\n      \"instructions\": %llu, \"cycles\": %llu,\n",
+                     static_cast<unsigned long long>(r.instructions),
+                     static_cast<unsigned long long>(r.cycles));
+        std::fprintf(f, "      \"instructions_per_sec\": %.6g, \"cycles_per_sec\": %.6g,\n",
+                     r.instructions_per_sec, r.cycles_per_sec);
+        std::fprintf(f, "      \"samples\": [");
+        for (size_t k = 0; k < r.samples.size(); ++k)
+            std::fprintf(f, "%s%.6g", k ? ", " : "", r.samples[k]);
+        std::fprintf(f, "] }");
+    }
+    std::fprintf(f, "\n  ]\n}\n");
+
+    bool ok = std::ferror(f) == 0;
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) std::fprintf(stderr, "%s: write failed\n", path);
+    return ok;
+}
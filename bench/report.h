@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ─── Benchmark result records ─────────────────────────────────────────────────
+// Both benchmark drivers can write their results as JSON so that runs can be
+// archived and compared with native8080_benchcmp.  Layout:
+//
+//   { "schema": 1, "suite": "micro" | "macro",
+//     "host":  { "cpu": "...", "threads": N },
+//     "build": { "compiler": "...", "build_type": "...", "flags": "..." },
+//     "results": [ { "workload": "...", "engine": "...",
+//                    "instructions": N, "cycles": N,
+//                    "instructions_per_sec": X, "cycles_per_sec": X,
+//                    "samples": [ instructions/s per repetition, ... ] } ] }
+//
+// The per-repetition samples let the comparison tool estimate run-to-run noise.
+
+struct BenchRecord {
+    std::string         workload;
+    std::string         engine;
+    uint64_t            instructions = 0;   // per repetition (0 = not tracked)
+    uint64_t            cycles       = 0;
+    double              instructions_per_sec = 0.0;  // median
+    double              cycles_per_sec       = 0.0;  // median
+    std::vector<double> samples;            // instructions/s per repetition
+};
+
+// Host CPU model name (from /proc/cpuinfo where available).
+std::string HostCpuName();
+
+// Write `records` to `path`; returns false (after printing why) on I/O error.
+bool WriteBenchJson(const char* path, const char* suite, const std::vector<BenchRecord>& records);
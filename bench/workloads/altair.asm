@@ -0,0 +1,153 @@
+; ─── altair: serial console program for the Altair profile ──────────────────
+; An original program for `native8080 --machine altair`.  It talks to the
+; 88-2SIO the way Altair BASIC does, polling status before every byte, and
+; runs a line-at-a-time command loop:
+;   T          print a 2000-line table of N and the running sum of 1..N
+;   Q          halt
+;   otherwise  echo the line reversed
+; With the console input at its end, the emulator stops it at the prompt.
+
+SIOS    EQU     10H             ; 2SIO channel A status/control
+SIOD    EQU     11H             ; 2SIO channel A data
+RDRF    EQU     01H
+TDRE    EQU     02H
+
+LINE    EQU     1000H           ; input line, up to 80 characters
+N       EQU     1080H
+SUM     EQU     1082H
+STACK   EQU     1100H
+
+        ORG     0
+start:  LXI     SP,STACK
+        MVI     A,03H           ; ACIA master reset
+        OUT     SIOS
+        MVI     A,15H           ; 8 data bits, 1 stop bit, clock / 16
+        OUT     SIOS
+        LXI     H,banner
+        CALL    puts
+
+; ─── Command loop ────────────────────────────────────────────────────────────
+prompt: LXI     H,prmsg
+        CALL    puts
+        LXI     H,LINE
+        MVI     B,0             ; B = length
+read:   CALL    getc
+        CPI     0DH
+        JZ      eol
+        MOV     M,A
+        INX     H
+        INR     B
+        CALL    putc            ; echo
+        MOV     A,B
+        CPI     80
+        JNZ     read
+eol:    CALL    crlf
+        MOV     A,B
+        ORA     A
+        JZ      prompt
+        CPI     1
+        JNZ     rev
+        LDA     LINE
+        CPI     'T'
+        JZ      table
+        CPI     'Q'
+        JNZ     rev
+        HLT
+
+rev:    DCX     H               ; the line backwards
+        MOV     A,M
+        CALL    putc
+        DCR     B
+        JNZ     rev
+        CALL    crlf
+        JMP     prompt
+
+table:  LXI     H,0
+        SHLD    SUM
+        INX     H
+tab1:   SHLD    N
+        CALL    pdec
+        MVI     A,' '
+        CALL    putc
+        LHLD    SUM
+        XCHG
+        LHLD    N
+        DAD     D
+        SHLD    SUM
+        CALL    pdec
+        CALL    crlf
+        LHLD    N
+        INX     H
+        MOV     A,H
+        CPI     HIGH(2001)
+        JNZ     tab1
+        MOV     A,L
+        CPI     LOW(2001)
+        JNZ     tab1
+        JMP     prompt
+
+; ─── Console ─────────────────────────────────────────────────────────────────
+getc:   IN      SIOS            ; wait for a byte
+        RRC
+        JNC     getc
+        IN      SIOD
+        ANI     7FH
+        RET
+
+putc:   PUSH    PSW             ; wait until the transmitter is free
+putc1:  IN      SIOS
+        ANI     TDRE
+        JZ      putc1
+        POP     PSW
+        OUT     SIOD
+        RET
+
+crlf:   MVI     A,0DH
+        CALL    putc
+        MVI     A,0AH
+        JMP     putc
+
+puts:   MOV     A,M             ; zero-terminated string at HL
+        ORA     A
+        RZ
+        CALL    putc
+        INX     H
+        JMP     puts
+
+; ─── pdec: print HL in decimal without leading zeros ─────────────────────────
+pdec:   MVI     C,0             ; C = a digit has been printed
+        LXI     D,10000
+        CALL    digit
+        LXI     D,1000
+        CALL    digit
+        LXI     D,100
+        CALL    digit
+        LXI     D,10
+        CALL    digit
+        MOV     A,L
+        ADI     '0'
+        JMP     putc
+
+digit:  MVI     B,'0'-1         ; B = '0' + how many DE fit into HL
+dig1:   INR     B
+        MOV     A,L
+        SUB     E
+        MOV     L,A
+        MOV     A,H
+        SBB     D
+        MOV     H,A
+        JNC     dig1
+        DAD     D               ; one subtraction too many
+        MOV     A,B
+        CPI     '0'
+        JNZ     dig2
+        MOV     A,C
+        ORA     A
+        RZ
+dig2:   MVI     C,1
+        MOV     A,B
+        JMP     putc
+
+banner: DB      'NATIVE8080 88-2SIO CONSOLE', 0DH, 0AH, 0
+prmsg:  DB      '> ', 0
+        END
@@ -0,0 +1,136 @@
+; ─── bcd: packed-BCD arithmetic with DAA ─────────────────────────────────────
+; Sums the BCD counter 0001..9999 into an 8-digit BCD accumulator, checks the
+; total (49995000), then subtracts the same values back via ten's-complement
+; addition and checks for zero.  Repeated four times.
+
+N       EQU     9999
+ITER    EQU     4
+
+        ORG     100H
+        MVI     A,ITER
+        STA     iter
+
+again:  LXI     H,0
+        SHLD    acc
+        SHLD    acc+2
+        SHLD    ctr
+
+        LXI     B,N
+addlp:  LDA     ctr                 ; ctr += 1
+        ADI     1
+        DAA
+        STA     ctr
+        LDA     ctr+1
+        ACI     0
+        DAA
+        STA     ctr+1
+        LXI     H,acc               ; acc += ctr
+        LXI     D,ctr
+        LDAX    D
+        ADD     M
+        DAA
+        MOV     M,A
+        INX     H
+        INX     D
+        LDAX    D
+        ADC     M
+        DAA
+        MOV     M,A
+        INX     H
+        MVI     A,0
+        ADC     M
+        DAA
+        MOV     M,A
+        INX     H
+        MVI     A,0
+        ADC     M
+        DAA
+        MOV     M,A
+        DCX     B
+        MOV     A,B
+        ORA     C
+        JNZ     addlp
+
+        LHLD    acc+2               ; acc == 49995000 ?
+        LXI     D,4999H
+        MOV     A,H
+        CMP     D
+        JNZ     FAIL
+        MOV     A,L
+        CMP     E
+        JNZ     FAIL
+        LHLD    acc
+        LXI     D,5000H
+        MOV     A,H
+        CMP     D
+        JNZ     FAIL
+        MOV     A,L
+        CMP     E
+        JNZ     FAIL
+
+        LXI     B,N
+sublp:  MVI     A,99H               ; comp = nines' complement of ctr
+        LXI     H,ctr
+        SUB     M
+        STA     comp
+        MVI     A,99H
+        INX     H
+        SUB     M
+        STA     comp+1
+        LXI     H,acc               ; acc += comp + 1  (i.e. acc -= ctr)
+        LXI     D,comp
+        STC
+        LDAX    D
+        ADC     M
+        DAA
+        MOV     M,A
+        INX     H
+        INX     D
+        LDAX    D
+        ADC     M
+        DAA
+        MOV     M,A
+        INX     H
+        MVI     A,99H
+        ADC     M
+        DAA
+        MOV     M,A
+        INX     H
+        MVI     A,99H
+        ADC     M
+        DAA
+        MOV     M,A
+        LDA     ctr                 ; ctr -= 1  (ctr += 9999)
+        ADI     99H
+        DAA
+        STA     ctr
+        LDA     ctr+1
+        ACI     99H
+        DAA
+        STA     ctr+1
+        DCX     B
+        MOV     A,B
+        ORA     C
+        JNZ     sublp
+
+        LHLD    acc                 ; acc == 0 ?
+        MOV     A,H
+        ORA     L
+        JNZ     FAIL
+        LHLD    acc+2
+        MOV     A,H
+        ORA     L
+        JNZ     FAIL
+
+        LDA     iter
+        DCR     A
+        STA     iter
+        JNZ     again
+        JMP     PASS
+
+        INCLUDE "common.inc"
+
+iter:   DS      1
+acc:    DS      4
+ctr:    DS      2
+comp:   DS      2
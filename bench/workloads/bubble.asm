@@ -0,0 +1,103 @@
+; ─── bubble: bubble sort of 512 bytes ────────────────────────────────────────
+; Sorts 512 pseudo-random bytes in place, twice (regenerating the data each
+; time), then checks that the array is ordered and that its sum survived.
+
+N       EQU     512
+ITER    EQU     2
+
+        ORG     100H
+        MVI     A,ITER
+        STA     iter
+
+again:  CALL    SRAND
+        LXI     H,0
+        SHLD    sum
+        LXI     B,arr
+gen:    CALL    RAND
+        MOV     A,H
+        STAX    B
+        LHLD    sum                 ; sum += byte
+        ADD     L
+        MOV     L,A
+        JNC     gen1
+        INR     H
+gen1:   SHLD    sum
+        INX     B
+        MOV     A,C
+        CPI     LOW(arrend)
+        JNZ     gen
+        MOV     A,B
+        CPI     HIGH(arrend)
+        JNZ     gen
+
+        LXI     D,arr+N-1           ; DE = last
+outer:  LXI     H,arr               ; HL = p
+inner:  MOV     A,M
+        INX     H
+        CMP     M
+        JC      noswap
+        JZ      noswap
+        MOV     B,M                 ; p[0] > p[1]: swap
+        MOV     M,A
+        DCX     H
+        MOV     M,B
+        INX     H
+noswap: MOV     A,L                 ; until p + 1 == last
+        CMP     E
+        JNZ     inner
+        MOV     A,H
+        CMP     D
+        JNZ     inner
+        DCX     D
+        MOV     A,E
+        CPI     LOW(arr)
+        JNZ     outer
+        MOV     A,D
+        CPI     HIGH(arr)
+        JNZ     outer
+
+        CALL    VERIFY
+        LDA     iter
+        DCR     A
+        STA     iter
+        JNZ     again
+        JMP     PASS
+
+; VERIFY: FAIL unless arr is non-decreasing and sums to `sum`.
+VERIFY: LXI     H,arr
+        LXI     D,0
+        LXI     B,N-1
+chk:    MOV     A,M
+        ADD     E
+        MOV     E,A
+        JNC     chk1
+        INR     D
+chk1:   MOV     A,M
+        INX     H
+        CMP     M
+        JZ      chk2
+        JNC     FAIL                ; HL points past the first bad pair
+chk2:   DCX     B
+        MOV     A,B
+        ORA     C
+        JNZ     chk
+        MOV     A,M                 ; last element
+        ADD     E
+        MOV     E,A
+        JNC     chk3
+        INR     D
+chk3:   LHLD    sum
+        MOV     A,H
+        CMP     D
+        JNZ     FAIL
+        MOV     A,L
+        CMP     E
+        JNZ     FAIL
+        RET
+
+        INCLUDE "common.inc"
+
+iter:   DS      1
+sum:    DS      2
+arr:    DS      N
+arrend  EQU     arr+N
@@ -0,0 +1,61 @@
+; ─── crc16: bitwise CRC-16/CCITT-FALSE ───────────────────────────────────────
+; Polynomial 0x1021, initial value 0xFFFF, over 2 KB of pseudo-random data,
+; recomputed eight times.  Expected CRC: 0x6C7A.
+
+LEN     EQU     2048
+ITER    EQU     8
+
+        ORG     100H
+        CALL    SRAND               ; buf[i] = high byte of RAND
+        LXI     B,buf
+gen:    CALL    RAND
+        MOV     A,H
+        STAX    B
+        INX     B
+        MOV     A,C
+        CPI     LOW(bufend)
+        JNZ     gen
+        MOV     A,B
+        CPI     HIGH(bufend)
+        JNZ     gen
+
+        MVI     A,ITER
+        STA     iter
+again:  LXI     H,0FFFFH            ; HL = crc
+        LXI     D,buf               ; DE = ptr
+crcbyte:
+        LDAX    D
+        XRA     H
+        MOV     H,A
+        MVI     B,8
+crcbit: DAD     H
+        JNC     crcnx
+        MOV     A,H
+        XRI     10H
+        MOV     H,A
+        MOV     A,L
+        XRI     21H
+        MOV     L,A
+crcnx:  DCR     B
+        JNZ     crcbit
+        INX     D
+        MOV     A,E
+        CPI     LOW(bufend)
+        JNZ     crcbyte
+        MOV     A,D
+        CPI     HIGH(bufend)
+        JNZ     crcbyte
+
+        LDA     iter
+        DCR     A
+        STA     iter
+        JNZ     again
+
+        LXI     D,6C7AH
+        JMP     EXPECT
+
+        INCLUDE "common.inc"
+
+iter:   DS      1
+buf:    DS      LEN
+bufend  EQU     buf+LEN
@@ -0,0 +1,106 @@
+; ─── crc32: bitwise CRC-32 (IEEE 802.3, reflected) ───────────────────────────
+; Polynomial 0xEDB88320, initial value and final XOR 0xFFFFFFFF, over the same
+; 2 KB of pseudo-random data as crc16, recomputed four times.
+; Expected CRC: 0x7872CC4E.  The CRC lives in B:C:D:E (B = bits 31..24).
+
+LEN     EQU     2048
+ITER    EQU     4
+
+        ORG     100H
+        CALL    SRAND
+        LXI     B,buf
+gen:    CALL    RAND
+        MOV     A,H
+        STAX    B
+        INX     B
+        MOV     A,C
+        CPI     LOW(bufend)
+        JNZ     gen
+        MOV     A,B
+        CPI     HIGH(bufend)
+        JNZ     gen
+
+        MVI     A,ITER
+        STA     iter
+again:  LXI     B,0FFFFH
+        LXI     D,0FFFFH
+        LXI     H,buf
+crcbyte:
+        MOV     A,E
+        XRA     M
+        MOV     E,A
+        MVI     A,8
+        STA     bits
+crcbit: ORA     A                   ; clear carry, shift BCDE right
+        MOV     A,B
+        RAR
+        MOV     B,A
+        MOV     A,C
+        RAR
+        MOV     C,A
+        MOV     A,D
+        RAR
+        MOV     D,A
+        MOV     A,E
+        RAR
+        MOV     E,A
+        JNC     crcnx
+        MOV     A,B
+        XRI     0EDH
+        MOV     B,A
+        MOV     A,C
+        XRI     0B8H
+        MOV     C,A
+        MOV     A,D
+        XRI     83H
+        MOV     D,A
+        MOV     A,E
+        XRI     20H
+        MOV     E,A
+crcnx:  LDA     bits
+        DCR     A
+        STA     bits
+        JNZ     crcbit
+        INX     H
+        MOV     A,L
+        CPI     LOW(bufend)
+        JNZ     crcbyte
+        MOV     A,H
+        CPI     HIGH(bufend)
+        JNZ     crcbyte
+
+        LDA     iter
+        DCR     A
+        STA     iter
+        JNZ     again
+
+        MOV     A,B                 ; final XOR, then check the high word
+        CMA
+        MOV     H,A
+        MOV     A,C
+        CMA
+        MOV     L,A
+        PUSH    D
+        LXI     D,7872H
+        MOV     A,H
+        CMP     D
+        JNZ     FAIL
+        MOV     A,L
+        CMP     E
+        JNZ     FAIL
+        POP     D                   ; low word
+        MOV     A,D
+        CMA
+        MOV     H,A
+        MOV     A,E
+        CMA
+        MOV     L,A
+        LXI     D,0CC4EH
+        JMP     EXPECT
+
+        INCLUDE "common.inc"
+
+iter:   DS      1
+bits:   DS      1
+buf:    DS      LEN
+bufend  EQU     buf+LEN
@@ -0,0 +1,313 @@
+; ─── invaders: video stress program for the Space Invaders profile ──────────
+; An original program (not the game) for `native8080 --machine invaders`,
+; organised like the game: all drawing happens in the interrupt handlers.
+;   RST 1 (mid-frame)  erases and redraws one alien of an 11x5 formation that
+;                      marches across the screen and steps down at the edges
+;   RST 2 (VBlank)     counts the frame, moves the player's ship (port 1
+;                      left/right, otherwise it patrols) and its shot
+;   main loop          LFSR busy work once per frame, then polls for the next
+; Sprites are drawn through the port 2/3/4 shift register, as in the game.
+;
+; Screen coordinates are raster ones: line X (0-223, left to right upright)
+; and bit position P (0-255, bottom to top upright); byte P/8 of line X is
+; at VRAM + 32*X.
+
+VRAM    EQU     2400H
+STACK   EQU     2400H
+
+FRAMES  EQU     2000H           ; frame counter (VBlanks)
+LASTF   EQU     2001H           ; frame counter seen by the main loop
+ALIEN   EQU     2002H           ; next alien to redraw, 0-54
+FX      EQU     2003H           ; formation left line
+FDX     EQU     2004H           ; formation step per pass: +1 or -1
+FP      EQU     2005H           ; formation bottom row bit position
+SHIPX   EQU     2006H
+SHIPDX  EQU     2007H
+SHOTX   EQU     2008H
+SHOTP   EQU     2009H
+SEED    EQU     200AH           ; 16-bit LFSR state
+OLDX    EQU     2010H           ; where each alien was last drawn (55 bytes)
+OLDP    EQU     2050H
+ACOL    EQU     2090H           ; line offset of each alien in the formation
+AROW    EQU     20D0H           ; bit offset of each alien in the formation
+
+NALIENS EQU     55
+FXMAX   EQU     224-(10*16+8)   ; rightmost formation position
+FPTOP   EQU     168
+FPLOW   EQU     80
+SHIPP   EQU     16
+
+        ORG     0
+        JMP     start
+
+        ORG     8               ; RST 1: mid-frame
+        PUSH    PSW
+        PUSH    B
+        PUSH    D
+        PUSH    H
+        JMP     midirq
+
+        ORG     10H             ; RST 2: VBlank
+        PUSH    PSW
+        PUSH    B
+        PUSH    D
+        PUSH    H
+        JMP     vblirq
+
+irqend: POP     H
+        POP     D
+        POP     B
+        POP     PSW
+        EI
+        RET
+
+; ─── Start-up ────────────────────────────────────────────────────────────────
+start:  LXI     SP,STACK
+        LXI     H,2000H         ; clear RAM and video RAM
+clear:  MVI     M,0
+        INX     H
+        MOV     A,H
+        CPI     40H
+        JNZ     clear
+
+        LXI     H,ACOL          ; formation offsets: 5 rows of 11
+        LXI     D,AROW
+        MVI     B,0             ; B = row offset
+rows:   MVI     C,0             ; C = column offset
+cols:   MOV     M,C
+        MOV     A,B
+        STAX    D
+        INX     H
+        INX     D
+        MOV     A,C
+        ADI     16
+        MOV     C,A
+        CPI     11*16
+        JNZ     cols
+        MOV     A,B
+        ADI     16
+        MOV     B,A
+        CPI     5*16
+        JNZ     rows
+
+        MVI     A,1
+        STA     FDX
+        STA     SHIPDX
+        MVI     A,FPTOP
+        STA     FP
+        MVI     A,100
+        STA     SHIPX
+        MVI     A,SHIPP+8
+        STA     SHOTP
+        LXI     H,0ACE1H
+        SHLD    SEED
+        EI
+
+; ─── Main loop ───────────────────────────────────────────────────────────────
+main:   LHLD    SEED            ; 200 steps of a Galois LFSR
+        MVI     B,200
+lfsr:   MOV     A,H
+        ORA     A
+        RAR
+        MOV     H,A
+        MOV     A,L
+        RAR
+        MOV     L,A
+        JNC     lfsr1
+        MOV     A,H
+        XRI     0B4H
+        MOV     H,A
+lfsr1:  DCR     B
+        JNZ     lfsr
+        SHLD    SEED
+
+wait:   LDA     LASTF           ; spin until the next VBlank
+        MOV     B,A
+        LDA     FRAMES
+        CMP     B
+        JZ      wait
+        STA     LASTF
+        JMP     main
+
+; ─── RST 1: one alien per interrupt ──────────────────────────────────────────
+midirq: LDA     ALIEN
+        MOV     E,A
+        MVI     D,0
+        LXI     H,OLDX          ; erase it where it was
+        DAD     D
+        MOV     B,M
+        LXI     H,OLDP
+        DAD     D
+        MOV     C,M
+        LXI     H,blank8
+        CALL    sprite
+
+        LXI     H,ACOL          ; B = FX + column offset
+        DAD     D
+        LDA     FX
+        ADD     M
+        MOV     B,A
+        LXI     H,AROW          ; C = FP + row offset
+        DAD     D
+        LDA     FP
+        ADD     M
+        MOV     C,A
+        LXI     H,OLDX
+        DAD     D
+        MOV     M,B
+        LXI     H,OLDP
+        DAD     D
+        MOV     M,C
+        LXI     H,alien1        ; two animation frames
+        LDA     FX
+        ANI     1
+        JZ      draw
+        LXI     H,alien2
+draw:   CALL    sprite
+
+        LDA     ALIEN           ; next alien; after the last, step the formation
+        INR     A
+        CPI     NALIENS
+        JNZ     midend
+        LDA     FDX
+        MOV     B,A
+        LDA     FX
+        ADD     B
+        CPI     FXMAX+1
+        JNC     edge            ; also catches 0 - 1 = 0FFH
+        STA     FX
+        XRA     A
+        JMP     midend
+edge:   MOV     A,B             ; reverse and step down
+        CMA
+        INR     A
+        STA     FDX
+        LDA     FP
+        SUI     8
+        CPI     FPLOW
+        JNC     edge1
+        MVI     A,FPTOP
+edge1:  STA     FP
+        XRA     A
+midend: STA     ALIEN
+        JMP     irqend
+
+; ─── RST 2: frame count, ship and shot ───────────────────────────────────────
+vblirq: LXI     H,FRAMES
+        INR     M
+
+        IN      1               ; left/right override the patrol
+        MOV     C,A
+        LDA     SHIPX
+        MOV     B,A
+        LDA     SHIPDX
+        MOV     D,A
+        MOV     A,C
+        ANI     20H
+        JZ      vbl1
+        MVI     D,0FFH
+vbl1:   MOV     A,C
+        ANI     40H
+        JZ      vbl2
+        MVI     D,1
+vbl2:   MOV     A,B
+        ADD     D
+        CPI     224-16+1
+        JC      vbl3
+        MOV     A,D             ; at an edge: turn round
+        CMA
+        INR     A
+        MOV     D,A
+        MOV     A,B
+vbl3:   STA     SHIPX
+        MOV     B,A
+        MOV     A,D
+        STA     SHIPDX
+        MVI     C,SHIPP
+        LXI     H,ship
+        CALL    sprite
+
+        LDA     SHOTX           ; erase the shot, move it up, redraw it
+        MOV     B,A
+        LDA     SHOTP
+        MOV     C,A
+        LXI     H,blank1
+        CALL    sprite
+        MOV     A,C
+        ADI     4
+        CPI     240
+        JC      vbl4
+        LDA     SHIPX           ; off the top: fire again from the ship
+        ADI     8
+        STA     SHOTX
+        MVI     A,SHIPP+8
+vbl4:   STA     SHOTP
+        MOV     C,A
+        LDA     SHOTX
+        MOV     B,A
+        LXI     H,shot
+        CALL    sprite
+        JMP     irqend
+
+; ─── sprite: draw the sprite at HL at line B, bit position C ─────────────────
+; The sprite is a line count followed by one byte per line; each byte is
+; shifted into place across two bytes of video RAM.  Preserves BC and DE.
+sprite: PUSH    B
+        PUSH    D
+        PUSH    H
+        MOV     L,B             ; HL = VRAM + 32 * B + C / 8
+        MVI     H,0
+        DAD     H
+        DAD     H
+        DAD     H
+        DAD     H
+        DAD     H
+        MOV     A,C
+        RRC
+        RRC
+        RRC
+        ANI     1FH
+        MOV     E,A
+        MVI     D,HIGH(VRAM)
+        DAD     D
+        MOV     A,C
+        ANI     7
+        OUT     2
+        XCHG                    ; DE = screen
+        POP     H               ; HL = sprite
+        MOV     B,M
+        INX     H
+spr1:   XRA     A
+        OUT     4
+        MOV     A,M
+        OUT     4
+        IN      3
+        STAX    D
+        INX     D
+        XRA     A
+        OUT     4
+        IN      3
+        STAX    D
+        MOV     A,E             ; next line: DE += 31
+        ADI     31
+        MOV     E,A
+        MOV     A,D
+        ACI     0
+        MOV     D,A
+        INX     H
+        DCR     B
+        JNZ     spr1
+        POP     D
+        POP     B
+        RET
+
+; ─── Sprites ─────────────────────────────────────────────────────────────────
+; One byte per raster line, i.e. per upright column, bit 0 at the bottom.
+alien1: DB      8, 19H, 3AH, 6DH, 0FAH, 0FAH, 6DH, 3AH, 19H
+alien2: DB      8, 1AH, 3DH, 68H, 0FCH, 0FCH, 68H, 3DH, 1AH
+ship:   DB      16, 0, 0FH, 1FH, 1FH, 1FH, 1FH, 7FH, 0FFH
+        DB      0FFH, 7FH, 1FH, 1FH, 1FH, 1FH, 0FH, 0
+shot:   DB      1, 0FH
+blank8: DB      8, 0, 0, 0, 0, 0, 0, 0, 0
+blank1: DB      1, 0
+        END
@@ -0,0 +1,257 @@
+; ─── isbc: interrupt-driven console program for the iSBC profile ────────────
+; An original program for `native8080 --machine isbc`.  It runs on
+; interrupts through the 8259: the 8253 ticks 100 times a second on IR2, and
+; the 8251 raises IR6 for each character received, which the handler queues
+; in a ring.  The main loop sleeps in HLT between interrupts.  One-letter
+; commands:
+;   T          print the ticks since start (hundredths of a second)
+;   W          wait one second on the timer
+;   C          latch counter 1 (free running, mode 2) and print it
+;   Q          halt
+;   otherwise  echo
+; Output polls TxRDY.  With the console input at its end the program just
+; keeps sleeping, so end its input with Q (or use a limit).
+
+USARTD  EQU     0ECH            ; 8251 data
+USARTC  EQU     0EDH            ; 8251 control/status
+TXRDY   EQU     01H
+PIT0    EQU     0DCH            ; 8253 counter 0
+PIT1    EQU     0DDH            ; 8253 counter 1
+PITC    EQU     0DFH            ; 8253 control word
+PIC0    EQU     0DAH            ; 8259 ICW1/OCW2/OCW3
+PIC1    EQU     0DBH            ; 8259 ICW2/OCW1
+EOI     EQU     20H             ; OCW2: non-specific end of interrupt
+
+RXBUF   EQU     1000H           ; 16-byte receive ring (page aligned)
+RXHEAD  EQU     1010H           ; next slot the handler fills
+RXTAIL  EQU     1011H           ; next slot the main loop reads
+TICKS   EQU     1012H
+STACK   EQU     1100H
+
+        ORG     0
+start:  DI
+        LXI     SP,STACK
+        JMP     init
+
+; ─── Vector table: ICW1 56H / ICW2 00H put IRn at 0040H + 4n ─────────────────
+        ORG     48H             ; IR2: timer
+        JMP     tick
+        ORG     58H             ; IR6: receiver
+        JMP     rxint
+
+; ─── Set-up ──────────────────────────────────────────────────────────────────
+init:   XRA     A               ; USART: three zeros and an internal reset
+        OUT     USARTC          ; reach the mode register from any state
+        OUT     USARTC
+        OUT     USARTC
+        MVI     A,40H
+        OUT     USARTC
+        MVI     A,4EH           ; asynchronous, 8 bits, no parity, 1 stop, x16
+        OUT     USARTC
+        MVI     A,37H           ; RTS, error reset, RxE, DTR, TxEN
+        OUT     USARTC
+
+        MVI     A,56H           ; ICW1: table at 0040H, 4-byte entries, single, edge
+        OUT     PIC0
+        XRA     A               ; ICW2: table page 00H
+        OUT     PIC1
+        MVI     A,0BBH          ; OCW1: only IR2 and IR6
+        OUT     PIC1
+
+        MVI     A,34H           ; counter 0: LSB then MSB, mode 2
+        OUT     PITC
+        MVI     A,LOW(12288)    ; 1.2288 MHz / 12288 = 100 Hz
+        OUT     PIT0
+        MVI     A,HIGH(12288)
+        OUT     PIT0
+        MVI     A,74H           ; counter 1: LSB then MSB, mode 2, 65536
+        OUT     PITC
+        XRA     A
+        OUT     PIT1
+        OUT     PIT1
+
+        STA     RXHEAD
+        STA     RXTAIL
+        LXI     H,0
+        SHLD    TICKS
+        LXI     H,banner
+        CALL    puts
+        EI
+
+; ─── Command loop ────────────────────────────────────────────────────────────
+main:   CALL    getc
+        CPI     'T'
+        JZ      cmdt
+        CPI     'W'
+        JZ      cmdw
+        CPI     'C'
+        JZ      cmdc
+        CPI     'Q'
+        JZ      cmdq
+        CPI     0DH
+        JZ      newln
+        CALL    putc
+        JMP     main
+newln:  CALL    crlf
+        JMP     main
+
+cmdt:   LXI     H,tmsg
+        CALL    puts
+        LHLD    TICKS
+        CALL    pdec
+        CALL    crlf
+        JMP     main
+
+cmdw:   LHLD    TICKS           ; DE = the tick to wait for
+        LXI     D,100
+        DAD     D
+        XCHG
+cmdw1:  HLT                     ; until the next interrupt
+        LHLD    TICKS
+        MOV     A,L
+        CMP     E
+        JNZ     cmdw1
+        MOV     A,H
+        CMP     D
+        JNZ     cmdw1
+        LXI     H,wmsg
+        CALL    puts
+        JMP     main
+
+cmdc:   MVI     A,40H           ; latch counter 1
+        OUT     PITC
+        IN      PIT1
+        MOV     L,A
+        IN      PIT1
+        MOV     H,A
+        PUSH    H
+        LXI     H,cmsg
+        CALL    puts
+        POP     H
+        CALL    pdec
+        CALL    crlf
+        JMP     main
+
+cmdq:   LXI     H,qmsg
+        CALL    puts
+        DI
+        HLT
+
+; ─── Interrupt handlers ──────────────────────────────────────────────────────
+tick:   PUSH    PSW
+        PUSH    H
+        LHLD    TICKS
+        INX     H
+        SHLD    TICKS
+        MVI     A,EOI
+        OUT     PIC0
+        POP     H
+        POP     PSW
+        EI
+        RET
+
+rxint:  PUSH    PSW
+        PUSH    B
+        PUSH    H
+        IN      USARTD
+        ANI     7FH
+        MOV     C,A
+        LDA     RXHEAD
+        MOV     L,A
+        MVI     H,HIGH(RXBUF)
+        INR     A
+        ANI     0FH
+        MOV     B,A
+        LDA     RXTAIL
+        CMP     B
+        JZ      rxint1          ; ring full: drop the character
+        MOV     M,C
+        MOV     A,B
+        STA     RXHEAD
+rxint1: MVI     A,EOI
+        OUT     PIC0
+        POP     H
+        POP     B
+        POP     PSW
+        EI
+        RET
+
+; ─── Console ─────────────────────────────────────────────────────────────────
+getc:   DI                      ; the next queued character, sleeping until one comes
+        LDA     RXHEAD
+        MOV     B,A
+        LDA     RXTAIL
+        CMP     B
+        JNZ     getc1
+        EI                      ; EI; HLT: the interrupt can only come after the HLT
+        HLT
+        JMP     getc
+getc1:  MOV     L,A
+        MVI     H,HIGH(RXBUF)
+        INR     A
+        ANI     0FH
+        STA     RXTAIL
+        MOV     A,M
+        EI
+        RET
+
+putc:   PUSH    PSW             ; wait until the transmitter is free
+putc1:  IN      USARTC
+        ANI     TXRDY
+        JZ      putc1
+        POP     PSW
+        OUT     USARTD
+        RET
+
+crlf:   MVI     A,0DH
+        CALL    putc
+        MVI     A,0AH
+        JMP     putc
+
+puts:   MOV     A,M             ; zero-terminated string at HL
+        ORA     A
+        RZ
+        CALL    putc
+        INX     H
+        JMP     puts
+
+; ─── pdec: print HL in decimal without leading zeros ─────────────────────────
+pdec:   MVI     C,0             ; C = a digit has been printed
+        LXI     D,10000
+        CALL    digit
+        LXI     D,1000
+        CALL    digit
+        LXI     D,100
+        CALL    digit
+        LXI     D,10
+        CALL    digit
+        MOV     A,L
+        ADI     '0'
+        JMP     putc
+
+digit:  MVI     B,'0'-1         ; B = '0' + how many DE fit into HL
+dig1:   INR     B
+        MOV     A,L
+        SUB     E
+        MOV     L,A
+        MOV     A,H
+        SBB     D
+        MOV     H,A
+        JNC     dig1
+        DAD     D               ; one subtraction too many
+        MOV     A,B
+        CPI     '0'
+        JNZ     dig2
+        MOV     A,C
+        ORA     A
+        RZ
+dig2:   MVI     C,1
+        MOV     A,B
+        JMP     putc
+
+banner: DB      'NATIVE8080 ISBC: 8251 USART, 8253 PIT, 8259 PIC', 0DH, 0AH, 0
+tmsg:   DB      'TICKS ', 0
+wmsg:   DB      'ONE SECOND', 0DH, 0AH, 0
+cmsg:   DB      'COUNTER 1 ', 0
+qmsg:   DB      'BYE', 0DH, 0AH, 0
+        END
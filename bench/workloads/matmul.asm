@@ -0,0 +1,132 @@
+; ─── matmul: 16x16 byte matrix multiply ──────────────────────────────────────
+; C = A x B with 8x8->16 bit shift-and-add multiplies and 16-bit accumulation
+; (mod 65536), four times over.  Expected sum of all C elements: 0xFE4A.
+
+DIM     EQU     16
+ITER    EQU     4
+
+        ORG     100H
+        CALL    SRAND               ; A then B, row-major
+        LXI     B,mata
+gen:    CALL    RAND
+        MOV     A,H
+        STAX    B
+        INX     B
+        MOV     A,C
+        CPI     LOW(matc)
+        JNZ     gen
+        MOV     A,B
+        CPI     HIGH(matc)
+        JNZ     gen
+
+        MVI     A,ITER
+        STA     iter
+again:  LXI     H,0
+        SHLD    csum
+        LXI     H,matc
+        SHLD    pc
+        LXI     H,mata
+        SHLD    rowa
+        MVI     A,DIM
+        STA     mi
+
+iloop:  LXI     H,matb
+        SHLD    colb
+        MVI     A,DIM
+        STA     mj
+
+jloop:  LXI     H,0
+        SHLD    acc
+        LHLD    rowa
+        SHLD    pa
+        LHLD    colb
+        SHLD    pb
+        MVI     C,DIM
+kloop:  LHLD    pb                  ; b = *pb, pb += DIM
+        MOV     B,M
+        LXI     D,DIM
+        DAD     D
+        SHLD    pb
+        LHLD    pa                  ; a = *pa++
+        MOV     A,M
+        INX     H
+        SHLD    pa
+        MOV     E,B
+        CALL    MUL8
+        XCHG                        ; acc += a * b
+        LHLD    acc
+        DAD     D
+        SHLD    acc
+        DCR     C
+        JNZ     kloop
+
+        XCHG                        ; *pc++ = acc, csum += acc
+        LHLD    pc
+        MOV     M,E
+        INX     H
+        MOV     M,D
+        INX     H
+        SHLD    pc
+        LHLD    csum
+        DAD     D
+        SHLD    csum
+
+        LHLD    colb
+        INX     H
+        SHLD    colb
+        LDA     mj
+        DCR     A
+        STA     mj
+        JNZ     jloop
+
+        LHLD    rowa
+        LXI     D,DIM
+        DAD     D
+        SHLD    rowa
+        LDA     mi
+        DCR     A
+        STA     mi
+        JNZ     iloop
+
+        LHLD    csum
+        LXI     D,0FE4AH
+        MOV     A,H
+        CMP     D
+        JNZ     FAIL
+        MOV     A,L
+        CMP     E
+        JNZ     FAIL
+
+        LDA     iter
+        DCR     A
+        STA     iter
+        JNZ     again
+        JMP     PASS
+
+; MUL8: HL = A * E.  Clobbers A, B, D.
+MUL8:   LXI     H,0
+        MVI     D,0
+        MVI     B,8
+m8loop: DAD     H
+        RAL
+        JNC     m8next
+        DAD     D
+m8next: DCR     B
+        JNZ     m8loop
+        RET
+
+        INCLUDE "common.inc"
+
+iter:   DS      1
+mi:     DS      1
+mj:     DS      1
+acc:    DS      2
+csum:   DS      2
+pa:     DS      2
+pb:     DS      2
+pc:     DS      2
+rowa:   DS      2
+colb:   DS      2
+mata:   DS      DIM*DIM
+matb:   DS      DIM*DIM
+matc:   DS      2*DIM*DIM
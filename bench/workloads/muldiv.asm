@@ -0,0 +1,142 @@
+; ─── muldiv: 16-bit shift-and-add multiply and restoring divide ──────────────
+; For 2000 pseudo-random pairs (a, b) with b odd and below 0x8000: accumulates
+; the 32-bit products a*b, divides a by b and checks q*b + r == a.
+; Expected product sum: 0x5BA572D0.
+
+N       EQU     2000
+
+        ORG     100H
+        CALL    SRAND
+        LXI     H,0
+        SHLD    sum
+        SHLD    sum+2
+        LXI     H,N
+        SHLD    left
+
+loop:   CALL    RAND
+        SHLD    opa
+        CALL    RAND
+        MOV     A,H
+        ANI     7FH
+        MOV     H,A
+        MOV     A,L
+        ORI     1
+        MOV     L,A
+        SHLD    opb
+
+        LHLD    opa                 ; sum += a * b
+        MOV     B,H
+        MOV     C,L
+        LHLD    opb
+        XCHG
+        CALL    MUL16
+        PUSH    D
+        XCHG
+        LHLD    sum
+        DAD     D
+        SHLD    sum
+        POP     D
+        LHLD    sum+2
+        JNC     nocy
+        INX     H
+nocy:   DAD     D
+        SHLD    sum+2
+
+        LHLD    opa                 ; q, r = a / b
+        MOV     B,H
+        MOV     C,L
+        LHLD    opb
+        XCHG
+        CALL    DIV16
+        SHLD    rem
+        LHLD    opb                 ; q * b + r must give back a
+        XCHG
+        CALL    MUL16
+        MOV     A,D
+        ORA     E
+        JNZ     FAIL
+        XCHG
+        LHLD    rem
+        DAD     D
+        XCHG
+        LHLD    opa
+        MOV     A,L
+        CMP     E
+        JNZ     FAIL
+        MOV     A,H
+        CMP     D
+        JNZ     FAIL
+
+        LHLD    left
+        DCX     H
+        SHLD    left
+        MOV     A,H
+        ORA     L
+        JNZ     loop
+
+        LHLD    sum+2
+        LXI     D,5BA5H
+        MOV     A,H
+        CMP     D
+        JNZ     FAIL
+        MOV     A,L
+        CMP     E
+        JNZ     FAIL
+        LHLD    sum
+        LXI     D,72D0H
+        JMP     EXPECT
+
+; MUL16: DE:HL = BC * DE.  DE doubles as multiplier and high result word.
+MUL16:  LXI     H,0
+        MVI     A,16
+mloop:  DAD     H                   ; shift DE:HL left one bit
+        XCHG
+        JNC     mnc
+        DAD     H
+        INX     H
+        JMP     mbit
+mnc:    DAD     H                   ; CY = next multiplier bit
+mbit:   XCHG
+        JNC     mnext
+        DAD     B
+        JNC     mnext
+        INX     D
+mnext:  DCR     A
+        JNZ     mloop
+        RET
+
+; DIV16: BC = BC / DE, HL = BC % DE.  DE must be below 0x8000.
+DIV16:  LXI     H,0
+        MVI     A,16
+dloop:  PUSH    PSW
+        DAD     H                   ; remainder:quotient <<= 1
+        MOV     A,C
+        ADD     A
+        MOV     C,A
+        MOV     A,B
+        RAL
+        MOV     B,A
+        JNC     dsub
+        INX     H
+dsub:   MOV     A,L                 ; trial subtract
+        SUB     E
+        MOV     L,A
+        MOV     A,H
+        SBB     D
+        MOV     H,A
+        JNC     dfit
+        DAD     D                   ; restore
+        JMP     dnext
+dfit:   INX     B
+dnext:  POP     PSW
+        DCR     A
+        JNZ     dloop
+        RET
+
+        INCLUDE "common.inc"
+
+left:   DS      2
+opa:    DS      2
+opb:    DS      2
+rem:    DS      2
+sum:    DS      4
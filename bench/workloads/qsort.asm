@@ -0,0 +1,210 @@
+; ─── qsort: recursive quicksort of 2048 16-bit words ─────────────────────────
+; Hoare-partition quicksort on unsigned words, eight times over freshly
+; generated data, then checks ordering and the 16-bit sum of the array.
+
+N       EQU     2048
+ITER    EQU     8
+
+        ORG     100H
+        MVI     A,ITER
+        STA     iter
+
+again:  CALL    SRAND
+        LXI     H,0
+        SHLD    sum
+        LXI     B,arr
+gen:    CALL    RAND
+        MOV     A,L
+        STAX    B
+        INX     B
+        MOV     A,H
+        STAX    B
+        INX     B
+        XCHG                        ; sum += word
+        LHLD    sum
+        DAD     D
+        SHLD    sum
+        MOV     A,C
+        CPI     LOW(arrend)
+        JNZ     gen
+        MOV     A,B
+        CPI     HIGH(arrend)
+        JNZ     gen
+
+        LXI     H,arr
+        LXI     D,arr+2*(N-1)
+        CALL    QSORT
+
+        CALL    VERIFY
+        LDA     iter
+        DCR     A
+        STA     iter
+        JNZ     again
+        JMP     PASS
+
+; QSORT: sort the words from HL (lo) to DE (hi), both inclusive.
+QSORT:  MOV     A,L                 ; return unless lo < hi
+        SUB     E
+        MOV     A,H
+        SBB     D
+        RNC
+        SHLD    qlo
+        XCHG
+        SHLD    qhi
+        MOV     A,L                 ; HL = (hi - lo) / 2, word aligned
+        SUB     E
+        MOV     L,A
+        MOV     A,H
+        SBB     D
+        ORA     A
+        RAR
+        MOV     H,A
+        MOV     A,L
+        RAR
+        ANI     0FEH
+        MOV     L,A
+        DAD     D                   ; HL = mid
+        MOV     C,M                 ; BC = pivot
+        INX     H
+        MOV     B,M
+        LHLD    qlo
+        SHLD    qi
+        LHLD    qhi
+        SHLD    qj
+
+ploop:  LHLD    qi                  ; while *i < pivot: i++
+iscan:  MOV     E,M
+        INX     H
+        MOV     D,M
+        INX     H
+        MOV     A,E
+        SUB     C
+        MOV     A,D
+        SBB     B
+        JC      iscan
+        DCX     H
+        DCX     H
+        SHLD    qi
+
+        LHLD    qj                  ; while *j > pivot: j--
+jscan:  MOV     E,M
+        INX     H
+        MOV     D,M
+        DCX     H
+        MOV     A,C
+        SUB     E
+        MOV     A,B
+        SBB     D
+        JNC     jdone
+        DCX     H
+        DCX     H
+        JMP     jscan
+jdone:  SHLD    qj
+
+        XCHG                        ; if i > j: partition done
+        LHLD    qi
+        MOV     A,E
+        SUB     L
+        MOV     A,D
+        SBB     H
+        JC      pdone
+
+        PUSH    B                   ; swap *i, *j
+        MOV     C,M
+        LDAX    D
+        MOV     M,A
+        MOV     A,C
+        STAX    D
+        INX     H
+        INX     D
+        MOV     C,M
+        LDAX    D
+        MOV     M,A
+        MOV     A,C
+        STAX    D
+        POP     B
+        INX     H                   ; i++
+        SHLD    qi
+        XCHG                        ; j--
+        DCX     H
+        DCX     H
+        DCX     H
+        SHLD    qj
+        XCHG                        ; loop while i <= j
+        LHLD    qi
+        MOV     A,E
+        SUB     L
+        MOV     A,D
+        SBB     H
+        JNC     ploop
+
+pdone:  LHLD    qi                  ; QSORT(lo, j), then tail-call QSORT(i, hi)
+        PUSH    H
+        LHLD    qhi
+        PUSH    H
+        LHLD    qj
+        XCHG
+        LHLD    qlo
+        CALL    QSORT
+        POP     D
+        POP     H
+        JMP     QSORT
+
+; VERIFY: FAIL unless arr is non-decreasing and sums to `sum`.
+VERIFY: LXI     H,arr
+        LXI     B,0                 ; BC = running sum
+        MVI     A,LOW(N-1)
+        STA     left
+        MVI     A,HIGH(N-1)
+        STA     left+1
+chk:    MOV     E,M
+        INX     H
+        MOV     D,M
+        INX     H
+        MOV     A,M                 ; next word - this word must not borrow
+        SUB     E
+        INX     H
+        MOV     A,M
+        DCX     H
+        SBB     D
+        JC      FAIL
+        PUSH    H
+        XCHG                        ; sum += word
+        DAD     B
+        MOV     B,H
+        MOV     C,L
+        POP     H
+        PUSH    H
+        LHLD    left
+        DCX     H
+        SHLD    left
+        MOV     A,H
+        ORA     L
+        POP     H
+        JNZ     chk
+        MOV     E,M                 ; last word
+        INX     H
+        MOV     D,M
+        XCHG
+        DAD     B
+        XCHG
+        LHLD    sum
+        MOV     A,H
+        CMP     D
+        JNZ     FAIL
+        MOV     A,L
+        CMP     E
+        JNZ     FAIL
+        RET
+
+        INCLUDE "common.inc"
+
+iter:   DS      1
+sum:    DS      2
+left:   DS      2
+qlo:    DS      2
+qhi:    DS      2
+qi:     DS      2
+qj:     DS      2
+arr:    DS      2*N
+arrend  EQU     arr+2*N
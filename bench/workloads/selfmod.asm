@@ -0,0 +1,48 @@
+; ─── selfmod: code patched by code that is only reached indirectly ───────────
+; A routine entered through PCHL rewrites the immediate of an MVI in another
+; routine, which is then called to read it back; the sum of the values read
+; over 200 rounds must be 1+2+...+200.  Translated (native8080_aot), the
+; patching routine is interpreted while the patched one is translated, so
+; this checks that stores from either side reach the other.  Expected sum:
+; 20100.
+
+ITER    EQU     200
+
+        ORG     100H
+        LXI     H,0
+        SHLD    sum
+        MVI     A,ITER
+        STA     iter
+
+again:  LXI     H,patch             ; get's immediate = iter
+        CALL    callhl
+        CALL    get                 ; sum += get()
+        MOV     E,A
+        MVI     D,0
+        LHLD    sum
+        DAD     D
+        SHLD    sum
+
+        LDA     iter
+        DCR     A
+        STA     iter
+        JNZ     again
+
+        LHLD    sum
+        LXI     D,20100
+        JMP     EXPECT
+
+callhl: PCHL
+
+get:    MVI     A,0                 ; immediate patched before each call
+        RET
+
+; Never reached by a direct jump or call, so not found by the translator.
+patch:  LDA     iter
+        STA     get+1
+        RET
+
+        INCLUDE "common.inc"
+
+sum:    DS      2
+iter:   DS      1
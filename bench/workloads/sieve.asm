@@ -0,0 +1,76 @@
+; ─── sieve: Sieve of Eratosthenes (BYTE benchmark variant) ───────────────────
+; Flags odd numbers 3..16383 in an 8191-byte array and counts the primes,
+; ten times over.  Expected count: 1899.
+
+SIZE    EQU     8190
+ITER    EQU     10
+
+        ORG     100H
+        MVI     A,ITER
+        STA     iter
+
+again:  LXI     H,flags             ; flags[0..SIZE] = 1
+        LXI     B,SIZE+1
+fill:   MVI     M,1
+        INX     H
+        DCX     B
+        MOV     A,B
+        ORA     C
+        JNZ     fill
+
+        LXI     H,0
+        SHLD    count
+        LXI     B,0                 ; BC = i
+
+scan:   LXI     H,flags
+        DAD     B
+        MOV     A,M
+        ORA     A
+        JZ      next
+
+        MOV     H,B                 ; DE = prime = i + i + 3
+        MOV     L,C
+        DAD     H
+        INX     H
+        INX     H
+        INX     H
+        XCHG
+        LXI     H,flags             ; HL = &flags[i + prime]
+        DAD     B
+        DAD     D
+strike: MOV     A,L                 ; while HL < fend
+        SUI     LOW(fend)
+        MOV     A,H
+        SBI     HIGH(fend)
+        JNC     counted
+        MVI     M,0
+        DAD     D
+        JMP     strike
+
+counted:
+        LHLD    count
+        INX     H
+        SHLD    count
+
+next:   INX     B
+        MOV     A,C
+        SUI     LOW(SIZE+1)
+        MOV     A,B
+        SBI     HIGH(SIZE+1)
+        JC      scan
+
+        LDA     iter
+        DCR     A
+        STA     iter
+        JNZ     again
+
+        LHLD    count
+        LXI     D,1899
+        JMP     EXPECT
+
+        INCLUDE "common.inc"
+
+iter:   DS      1
+count:  DS      2
+flags:  DS      SIZE+1
+fend    EQU     flags+SIZE+1
@@ -0,0 +1,73 @@
+; ─── strsearch: naive substring search ───────────────────────────────────────
+; Counts occurrences of "abca" in 4 KB of pseudo-random text over the
+; alphabet a-d, eight times over.  Expected count: 16.
+
+T       EQU     4096
+PLEN    EQU     4
+ITER    EQU     8
+
+        ORG     100H
+        CALL    SRAND
+        LXI     B,text
+gen:    CALL    RAND
+        MOV     A,H
+        ANI     3
+        ADI     'a'
+        STAX    B
+        INX     B
+        MOV     A,C
+        CPI     LOW(textend)
+        JNZ     gen
+        MOV     A,B
+        CPI     HIGH(textend)
+        JNZ     gen
+
+        MVI     A,ITER
+        STA     iter
+again:  LXI     H,text
+        LXI     B,0                 ; BC = matches
+sloop:  PUSH    H
+        LXI     D,pat
+scmp:   LDAX    D
+        ORA     A
+        JZ      found
+        CMP     M
+        JNZ     nomatch
+        INX     H
+        INX     D
+        JMP     scmp
+found:  INX     B
+nomatch:
+        POP     H
+        INX     H
+        MOV     A,L
+        CPI     LOW(last)
+        JNZ     sloop
+        MOV     A,H
+        CPI     HIGH(last)
+        JNZ     sloop
+
+        MOV     H,B
+        MOV     L,C
+        LXI     D,16
+        MOV     A,H
+        CMP     D
+        JNZ     FAIL
+        MOV     A,L
+        CMP     E
+        JNZ     FAIL
+
+        LDA     iter
+        DCR     A
+        STA     iter
+        JNZ     again
+        JMP     PASS
+
+pat:    DB      'abca', 0
+
+        INCLUDE "common.inc"
+
+iter:   DS      1
+text:   DS      T
+textend EQU     text+T
+last    EQU     textend-PLEN+1
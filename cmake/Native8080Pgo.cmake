@@ -0,0 +1,149 @@
+# ─── Profile-guided optimisation ──────────────────────────────────────────────
+# Included from the top-level CMakeLists.txt after native8080_core exists.
+#
+#   NATIVE8080_PGO=ON
+#       Automatic two-phase build.  Before native8080_core is compiled, a nested
+#       instrumented build of this tree (under <build>/pgo/train) runs the
+#       bundled workload corpus through native8080_macrobench; the collected
+#       profile then drives the optimisation of native8080_core.  The training
+#       reruns whenever a core source, header or workload changes.
+#
+#   NATIVE8080_PGO_PHASE=GENERATE|USE  with  NATIVE8080_PGO_DIR=<dir>
+#       The individual phases, for manual training runs (and used internally
+#       by the nested build).
+#
+# Target native8080_pgo_report builds an otherwise identical non-PGO tree and
+# compares both with native8080_benchcmp, printing the speedup per workload
+# and engine.
+
+set(NATIVE8080_PGO_PHASE "" CACHE STRING "Single PGO phase: GENERATE or USE (with NATIVE8080_PGO_DIR)")
+set(NATIVE8080_PGO_DIR   "" CACHE PATH   "Profile data directory for NATIVE8080_PGO_PHASE")
+
+if(NATIVE8080_PGO AND NATIVE8080_PGO_PHASE)
+    message(FATAL_ERROR "NATIVE8080_PGO and NATIVE8080_PGO_PHASE are mutually exclusive")
+endif()
+
+if(NOT NATIVE8080_PGO AND NOT NATIVE8080_PGO_PHASE)
+    return()
+endif()
+
+if(NOT CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")
+    message(FATAL_ERROR "Profile-guided optimisation needs GCC or Clang")
+endif()
+
+if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    find_program(NATIVE8080_LLVM_PROFDATA NAMES llvm-profdata
+                 HINTS ${CMAKE_CXX_COMPILER_DIR} $ENV{LLVM_DIR}/bin)
+    if(NOT NATIVE8080_LLVM_PROFDATA)
+        message(FATAL_ERROR "Clang PGO needs llvm-profdata")
+    endif()
+endif()
+
+# Apply one phase to native8080_core.  GCC names .gcda files after the object
+# path, so the build directory prefix is stripped to let the training build
+# and the optimised build share profiles.
+function(native8080_pgo_flags phase dir)
+    if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+        if(phase STREQUAL "GENERATE")
+            set(compile -fprofile-generate=${dir})
+            set(link    -fprofile-generate=${dir})
+        else()
+            set(compile -fprofile-use=${dir} -Wno-missing-profile)
+            set(link)
+        endif()
+        list(APPEND compile -fprofile-prefix-path=${CMAKE_CURRENT_BINARY_DIR})
+    else()
+        if(phase STREQUAL "GENERATE")
+            set(compile -fprofile-instr-generate=${dir}/%m.profraw)
+            set(link    -fprofile-instr-generate=${dir}/%m.profraw)
+        else()
+            set(compile -fprofile-instr-use=${dir}/native8080.profdata -Wno-profile-instr-unprofiled)
+            set(link)
+        endif()
+    endif()
+    target_compile_options(native8080_core PRIVATE ${compile})
+    target_link_options(native8080_core PUBLIC $<BUILD_INTERFACE:${link}>)
+    string(REPLACE ";" " " desc "${compile}")
+    set(NATIVE8080_PGO_DESCRIPTION "${desc}" PARENT_SCOPE)
+endfunction()
+
+# ── Manual phase ──────────────────────────────────────────────────────────────
+if(NATIVE8080_PGO_PHASE)
+    if(NOT NATIVE8080_PGO_PHASE MATCHES "^(GENERATE|USE)$" OR NOT NATIVE8080_PGO_DIR)
+        message(FATAL_ERROR "NATIVE8080_PGO_PHASE must be GENERATE or USE, with NATIVE8080_PGO_DIR set")
+    endif()
+    native8080_pgo_flags(${NATIVE8080_PGO_PHASE} ${NATIVE8080_PGO_DIR})
+    return()
+endif()
+
+# ── Automatic two-phase build ─────────────────────────────────────────────────
+set(pgo_root  ${CMAKE_CURRENT_BINARY_DIR}/pgo)
+set(pgo_train ${pgo_root}/train)
+set(pgo_data  ${pgo_root}/data)
+set(pgo_stamp ${pgo_root}/profile.stamp)
+
+# Settings forwarded to the nested builds so they compile the same code.
+set(pgo_forward
+    -G "${CMAKE_GENERATOR}"
+    -DCMAKE_CXX_COMPILER=${CMAKE_CXX_COMPILER}
+    -DCMAKE_BUILD_TYPE=${CMAKE_BUILD_TYPE}
+    "-DCMAKE_CXX_FLAGS=${CMAKE_CXX_FLAGS}"
+    -DNATIVE8080_LTO=${NATIVE8080_LTO}
+    -DNATIVE8080_BUILD_BENCH=ON
+    -DNATIVE8080_BUILD_FUZZ=OFF
+    -DNATIVE8080_INSTALL=OFF
+)
+
+if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+    set(pgo_merge)
+else()
+    set(pgo_merge COMMAND ${CMAKE_COMMAND} -DPROFDATA=${NATIVE8080_LLVM_PROFDATA} -DDIR=${pgo_data}
+                          -P ${CMAKE_CURRENT_SOURCE_DIR}/cmake/Native8080ProfMerge.cmake)
+endif()
+
+file(GLOB pgo_inputs
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/*.h
+    ${CMAKE_CURRENT_SOURCE_DIR}/src/*.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/bench/*.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/bench/workloads/*
+)
+
+add_custom_command(
+    OUTPUT  ${pgo_stamp}
+    COMMAND ${CMAKE_COMMAND} -E remove_directory ${pgo_data}
+    COMMAND ${CMAKE_COMMAND} -E make_directory ${pgo_data}
+    COMMAND ${CMAKE_COMMAND} -S ${CMAKE_CURRENT_SOURCE_DIR} -B ${pgo_train} ${pgo_forward}
+            -DNATIVE8080_PGO=OFF -DNATIVE8080_PGO_PHASE=GENERATE -DNATIVE8080_PGO_DIR=${pgo_data}
+    COMMAND ${CMAKE_COMMAND} --build ${pgo_train} --target native8080_macrobench
+    COMMAND ${pgo_train}/native8080_macrobench --reps 1 --min-time 0.2
+    ${pgo_merge}
+    COMMAND ${CMAKE_COMMAND} -E touch ${pgo_stamp}
+    DEPENDS ${pgo_inputs}
+    COMMENT "PGO: training native8080_core on the workload corpus"
+    VERBATIM
+)
+add_custom_target(native8080_pgo_training DEPENDS ${pgo_stamp})
+add_dependencies(native8080_core native8080_pgo_training)
+
+# Recompile the core whenever the profile changes.
+foreach(source IN LISTS NATIVE8080_CORE_SOURCES)
+    set_property(SOURCE ${source} APPEND PROPERTY OBJECT_DEPENDS ${pgo_stamp})
+endforeach()
+
+native8080_pgo_flags(USE ${pgo_data})
+
+# ── Speedup report ────────────────────────────────────────────────────────────
+if(NATIVE8080_BUILD_BENCH)
+    set(pgo_base ${pgo_root}/baseline)
+    add_custom_target(native8080_pgo_report
+        COMMAND ${CMAKE_COMMAND} -S ${CMAKE_CURRENT_SOURCE_DIR} -B ${pgo_base} ${pgo_forward}
+                -DNATIVE8080_PGO=OFF
+        COMMAND ${CMAKE_COMMAND} --build ${pgo_base} --target native8080_macrobench
+        COMMAND ${pgo_base}/native8080_macrobench --json ${pgo_root}/baseline.json
+        COMMAND $<TARGET_FILE:native8080_macrobench> --json ${pgo_root}/pgo.json
+        COMMAND $<TARGET_FILE:native8080_benchcmp> ${pgo_root}/baseline.json ${pgo_root}/pgo.json
+        DEPENDS native8080_macrobench native8080_benchcmp
+        COMMENT "PGO: comparing against a build without profile data"
+        VERBATIM
+    )
+endif()
@@ -0,0 +1,12 @@
+# Merge the raw Clang profiles of a training run: cmake -DPROFDATA=... -DDIR=... -P
+file(GLOB raw ${DIR}/*.profraw)
+if(NOT raw)
+    message(FATAL_ERROR "PGO: the training run produced no profiles in ${DIR}")
+endif()
+execute_process(
+    COMMAND ${PROFDATA} merge -output=${DIR}/native8080.profdata ${raw}
+    RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "PGO: llvm-profdata merge failed")
+endif()
@@ -0,0 +1,106 @@
+// ─── native8080_aot_corpus ────────────────────────────────────────────────────
+// Writes a random 8080 program image for the translation check
+// (fuzz_aot.cpp): random bytes loaded at 0x0100, with most jump, call and
+// 16-bit operands pointed back into the image so that the translator finds
+// real control flow.  The seed picks one of three flavours:
+//
+//   seed % 3 == 0  plain: stores may hit the program's own code
+//   seed % 3 == 1  no stores into memory except through PUSH, CALL and RST
+//   seed % 3 == 2  data-heavy: LXI, LDA, STA and friends address a small
+//                  data area, with LXI H,data followed by an access through M
+//
+//   native8080_aot_corpus SEED OUT.com [SIZE]
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr uint16_t ORIGIN = 0x0100;
+constexpr uint16_t DATA   = 0x3000;         // 64 bytes, outside any image
+
+int length(uint8_t op) {
+    switch (op) {
+        case 0x01: case 0x11: case 0x21: case 0x31:
+        case 0x22: case 0x2A: case 0x32: case 0x3A:
+        case 0xC3: case 0xCB: case 0xCD: case 0xDD: case 0xED: case 0xFD:
+            return 3;
+        case 0xD3: case 0xDB:
+            return 2;
+    }
+    if ((op & 0xC7) == 0xC2 || (op & 0xC7) == 0xC4) return 3;   // Jcc, Ccc
+    if ((op & 0xC7) == 0x06 || (op & 0xC7) == 0xC6) return 2;   // MVI, ALU immediate
+    return 1;
+}
+
+bool is_lxi(uint8_t op) { return (op & 0xCF) == 0x01; }
+
+// STAX, MOV M,r, INR/DCR/MVI M, XTHL and SPHL, and LXI SP.
+bool stores(uint8_t op) {
+    return op == 0x02 || op == 0x12 || op == 0x34 || op == 0x35 || op == 0x36 || op == 0xE3 ||
+           op == 0xF9 || op == 0x31 || (op >= 0x70 && op < 0x78 && op != 0x76);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::fprintf(stderr, "Usage: %s SEED OUT.com [SIZE]\n", argv[0]);
+        return 1;
+    }
+    const uint64_t seed   = std::strtoull(argv[1], nullptr, 0);
+    const size_t   size   = argc > 3 ? std::strtoul(argv[3], nullptr, 0) : 400;
+    const int      flavor = int(seed % 3);
+    if (size < 8 || size > 0x2000) {
+        std::fprintf(stderr, "%s: SIZE must be 8..8192\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937 rng(static_cast<uint32_t>(seed));
+    const auto chance = [&](double p) { return std::uniform_real_distribution<double>(0, 1)(rng) < p; };
+    std::vector<uint8_t> image(size);
+    for (uint8_t& b : image) b = uint8_t(rng());
+
+    if (flavor == 2)                                // LXI H,data then M
+        for (size_t k = 0; k < size / 8; ++k) {
+            static const uint8_t ACCESS[] = {0x77, 0x7E, 0x34, 0x36, 0x86, 0x70, 0x46};
+            const size_t i = rng() % (size - 6);
+            image[i]     = 0x21;
+            image[i + 1] = uint8_t(rng() % 64);
+            image[i + 2] = DATA >> 8;
+            image[i + 3] = ACCESS[rng() % sizeof ACCESS];
+            if (chance(0.3)) {                      // MVI L,n
+                image[i + 4] = 0x2E;
+                image[i + 5] = uint8_t(rng() % 64);
+            }
+        }
+
+    for (size_t i = 0; i < size;) {
+        uint8_t& op = image[i];
+        if (flavor == 1) {
+            if (stores(op)) op = 0x00;
+            if (op == 0x22 || op == 0x32) op = 0x3A;            // SHLD, STA -> LDA
+        }
+        const int len = length(op);
+        if (len == 3 && i + 2 < size && (!is_lxi(op) || chance(0.5))) {
+            uint16_t t = chance(0.9) ? uint16_t(ORIGIN + rng() % size) : uint16_t(rng());
+            if (flavor == 2 && (is_lxi(op) || op == 0x22 || op == 0x2A || op == 0x32 || op == 0x3A) && chance(0.7))
+                t = uint16_t(DATA + rng() % 64);
+            image[i + 1] = uint8_t(t);
+            image[i + 2] = uint8_t(t >> 8);
+        }
+        i += size_t(len);
+    }
+
+    std::ofstream out(argv[2], std::ios::binary);
+    out.write(reinterpret_cast<const char*>(image.data()), std::streamsize(image.size()));
+    if (!out) {
+        std::perror(argv[2]);
+        return 1;
+    }
+    return 0;
+}
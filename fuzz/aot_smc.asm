@@ -0,0 +1,38 @@
+; ─── aot_smc: self-modifying code and computed jumps ──────────────────────────
+; Translation-check case for native8080_fuzz_aot.  Each round rewrites the
+; immediate of an MVI that is translated code, then leaves through a PCHL on
+; a jump table, so stores into code and jumps to addresses only known at run
+; time are both exercised on the same path.  Ends by jumping to 0000H with
+; the patched immediate in A (10) and the running total in C.
+
+        ORG     0100H
+        LXI     SP,0F000H
+        MVI     B,10
+loop:   LDA     patch+1
+        INR     A
+        STA     patch+1             ; modify the immediate below
+patch:  MVI     C,0
+        MOV     A,C
+        ADD     B
+        MOV     C,A
+        MOV     A,B                 ; DE = (B & 1) * 2
+        ANI     1
+        ADD     A
+        MOV     E,A
+        MVI     D,0
+        LXI     H,table
+        DAD     D
+        MOV     A,M
+        INX     H
+        MOV     H,M
+        MOV     L,A
+        PCHL
+back:   DCR     B
+        JNZ     loop
+        LDA     patch+1
+        JMP     0
+even:   INR     C
+        JMP     back
+odd:    DCR     C
+        JMP     back
+table:  DW      even, odd
@@ -0,0 +1,157 @@
+// ─── native8080_fuzz_aot ──────────────────────────────────────────────────────
+// Differential check of translated code (aot.h) against the interpreter.
+//
+// Translation needs a C++ compiler, so unlike the engines in engine.h it
+// cannot be done per test case: the build generates random program images
+// (aot_corpus.cpp) plus the hand-written aot_smc.asm, translates them with
+// native8080_aot and links them all in here.  Each program is then run
+// RUNS times from differently seeded memory, once interpreted and once
+// translated, with varying slice lengths, periodic events, IN handlers that
+// change registers or raise interrupts, and the run cut into chunks by
+// instruction limits.  The I/O and event traffic (with the counters and
+// registers seen by each handler), every stop reason and the final registers,
+// counters and 64 KB of memory must match.
+//
+//   native8080_fuzz_aot [RUNS] [--verbose]
+
+#include "aot.h"
+#include "runner.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+
+constexpr int CHUNKS = 20;
+
+struct Outcome {
+    State8080   s;
+    std::string log;
+    uint64_t    cycles = 0, instructions = 0;
+};
+
+void run(const AotProgram& p, uint64_t seed, bool translated, Outcome& o) {
+    State8080& s = o.s;
+    std::mt19937 rng(static_cast<uint32_t>(seed));
+    for (auto& b : s.mem) b = uint8_t(rng());
+    std::memcpy(&s.mem[p.origin], p.image, p.size);
+    s.PC = p.origin;
+    s.SP = 0xF000;
+
+    IOBus  io;
+    Runner r(s, io);
+    // instructions() is only exact at slice boundaries, not in I/O handlers.
+    const auto note = [&](const char* what, unsigned a, unsigned b, bool boundary = true) {
+        char line[128];
+        std::snprintf(line, sizeof line, "%s %02X %02X @%llu/%lld [%04X %02X%02X %02X%02X %02X%02X %02X%02X %04X]\n",
+                      what, a, b, (unsigned long long)r.cycles(), boundary ? (long long)r.instructions() : -1LL,
+                      s.PC, s.A, s.F, s.B, s.C, s.D, s.E, s.H, s.L, s.SP);
+        o.log += line;
+    };
+    io.in_handler = [&](uint8_t port) {
+        note("IN ", port, 0, false);
+        if (port == 5) s.B ^= 0x5A;                 // handlers may change registers
+        if (port == 7) r.interrupt(0xFF);
+        return uint8_t(port * 3 + r.cycles());
+    };
+    io.out_handler = [&](uint8_t port, uint8_t val) { note("OUT", port, val, false); };
+
+    r.set_slice_cycles(1 + seed % 500);
+    r.traps.arm(0x0000);
+    r.traps.handler = [](State8080&) { return TrapAction::Stop; };
+    if (seed % 3 == 0)
+        r.events.every(97, 97 + seed % 50, [&](uint64_t due) {
+            note("EVT", unsigned(due & 0xFF), 0);
+            if (due % 5 == 0) r.interrupt(0xC7 | uint8_t((due & 7) << 3));
+        });
+    if (translated) r.set_translation(&p);
+
+    for (int chunk = 0; chunk < CHUNKS; ++chunk) {
+        RunLimits limits;
+        limits.max_cycles       = 50'000;
+        limits.max_instructions = 1 + (seed * 7 + uint64_t(chunk) * 13) % 997;
+        const StopReason reason = r.run(limits);
+        note(StopReasonName(reason), 0, 0);
+        if (reason == StopReason::Halted) s.halted = false;
+        if (reason == StopReason::Trap) break;
+    }
+    o.cycles       = r.cycles();
+    o.instructions = r.instructions();
+}
+
+bool same(const Outcome& a, const Outcome& b) {
+    const State8080& x = a.s;
+    const State8080& y = b.s;
+    return a.log == b.log && a.cycles == b.cycles && a.instructions == b.instructions &&
+           x.A == y.A && x.F == y.F && x.B == y.B && x.C == y.C && x.D == y.D && x.E == y.E &&
+           x.H == y.H && x.L == y.L && x.SP == y.SP && x.PC == y.PC && x.inte == y.inte &&
+           x.halted == y.halted && x.mem == y.mem;
+}
+
+// The first line where the two logs part, or where memory first differs.
+void report(const AotProgram& p, uint64_t seed, const Outcome& a, const Outcome& b) {
+    std::printf("MISMATCH %s run %llu: %llu/%llu instructions, %llu/%llu cycles, PC %04X/%04X "
+                "(interpreted/translated)\n",
+                p.name, (unsigned long long)seed, (unsigned long long)a.instructions,
+                (unsigned long long)b.instructions, (unsigned long long)a.cycles,
+                (unsigned long long)b.cycles, a.s.PC, b.s.PC);
+    std::istringstream x(a.log), y(b.log);
+    std::string        lx, ly;
+    while (true) {
+        const bool more_x = bool(std::getline(x, lx)), more_y = bool(std::getline(y, ly));
+        if (!more_x && !more_y) break;
+        if (!more_x || !more_y || lx != ly) {
+            std::printf("  interpreted: %s\n  translated:  %s\n", more_x ? lx.c_str() : "(end)",
+                        more_y ? ly.c_str() : "(end)");
+            break;
+        }
+    }
+    for (size_t addr = 0; addr < a.s.mem.size(); ++addr)
+        if (a.s.mem[addr] != b.s.mem[addr]) {
+            std::printf("  memory first differs at %04zX: %02X/%02X\n", addr, a.s.mem[addr], b.s.mem[addr]);
+            break;
+        }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    uint64_t runs    = 8;
+    bool     verbose = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else if (argv[i][0] != '-') {
+            runs = std::strtoull(argv[i], nullptr, 0);
+        } else {
+            std::fprintf(stderr, "Usage: %s [RUNS] [--verbose]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int      failures = 0;
+    uint64_t total    = 0;
+    for (const AotProgram* p : AotPrograms()) {
+        for (uint64_t seed = 1; seed <= runs; ++seed) {
+            Outcome interpreted, translated;
+            run(*p, seed, false, interpreted);
+            run(*p, seed, true, translated);
+            total += interpreted.instructions;
+            if (!same(interpreted, translated)) {
+                report(*p, seed, interpreted, translated);
+                ++failures;
+            } else if (verbose) {
+                std::printf("ok %s run %llu: %llu instructions\n", p->name, (unsigned long long)seed,
+                            (unsigned long long)interpreted.instructions);
+            }
+        }
+    }
+    std::printf("%zu programs x %llu runs, %llu instructions each way: %s\n", AotPrograms().size(),
+                (unsigned long long)runs, (unsigned long long)total,
+                failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
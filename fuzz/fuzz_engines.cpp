@@ -0,0 +1,345 @@
+// ─── native8080_fuzz ──────────────────────────────────────────────────────────
+// Differential fuzzer for the execution engines registered in engine.h.
+//
+// A test case is an initial CPU state, a short instruction stream placed at
+// PC and a seed for the rest of memory.  Every engine runs the case in blocks
+// of BLOCK instructions; after each block registers, flags, halt/interrupt
+// state, a hash of all 64 KB of memory, a hash of the I/O traffic and the
+// cycle count must match the reference engine.  A mismatch is minimised
+// automatically (fewer steps, zeroed memory, NOP-ed code, zeroed registers)
+// and written out as a reproducer file.
+//
+// Case file / libFuzzer input layout (little-endian, missing bytes read as 0):
+//   [0..7]   A F B C D E H L
+//   [8..9]   SP        [10..11] PC        [12] INTE
+//   [13..16] memory seed (0 = all-zero memory)
+//   [17..18] instruction count
+//   [19..]   code bytes placed at PC
+//
+// Built with -DNATIVE8080_LIBFUZZER=ON (Clang) this file provides
+// LLVMFuzzerTestOneInput; otherwise it is a standalone random fuzzer that
+// also replays case files given on the command line.
+
+#include "cpu8080.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t   HEADER_SIZE = 19;
+constexpr size_t   MAX_CODE    = 256;
+constexpr uint16_t MAX_STEPS   = 4096;
+constexpr uint64_t BLOCK       = 16;
+
+struct Case {
+    uint8_t  regs[8] = {0, FLAG_FIXED, 0, 0, 0, 0, 0, 0};   // A F B C D E H L
+    uint16_t SP = 0, PC = 0;
+    bool     inte = false;
+    uint32_t mem_seed = 0;
+    uint16_t steps = 0;
+    std::vector<uint8_t> code;
+};
+
+Case decode(const uint8_t* data, size_t size) {
+    uint8_t h[HEADER_SIZE] = {};
+    std::memcpy(h, data, std::min(size, HEADER_SIZE));
+    Case c;
+    std::memcpy(c.regs, h, 8);
+    c.SP       = uint16_t(h[8]  | (h[9]  << 8));
+    c.PC       = uint16_t(h[10] | (h[11] << 8));
+    c.inte     = h[12] & 1;
+    c.mem_seed = uint32_t(h[13]) | (uint32_t(h[14]) << 8) | (uint32_t(h[15]) << 16) | (uint32_t(h[16]) << 24);
+    c.steps    = std::min<uint16_t>(uint16_t(h[17] | (h[18] << 8)), MAX_STEPS);
+    if (size > HEADER_SIZE)
+        c.code.assign(data + HEADER_SIZE, data + std::min(size, HEADER_SIZE + MAX_CODE));
+    return c;
+}
+
+std::vector<uint8_t> encode(const Case& c) {
+    std::vector<uint8_t> out(HEADER_SIZE);
+    std::memcpy(out.data(), c.regs, 8);
+    out[8]  = c.SP & 0xFF;  out[9]  = c.SP >> 8;
+    out[10] = c.PC & 0xFF;  out[11] = c.PC >> 8;
+    out[12] = c.inte;
+    for (int i = 0; i < 4; ++i) out[13 + i] = uint8_t(c.mem_seed >> (8 * i));
+    out[17] = c.steps & 0xFF; out[18] = c.steps >> 8;
+    out.insert(out.end(), c.code.begin(), c.code.end());
+    return out;
+}
+
+// ─── Deterministic machine setup ──────────────────────────────────────────────
+void prepare(const Case& c, State8080& s) {
+    uint32_t x = c.mem_seed;
+    for (auto& b : s.mem) {
+        if (x) { x ^= x << 13; x ^= x >> 17; x ^= x << 5; b = uint8_t(x); }
+        else   { b = 0; }
+    }
+    for (size_t i = 0; i < c.code.size(); ++i) s.mem[uint16_t(c.PC + i)] = c.code[i];
+    s.A = c.regs[0]; s.F = uint8_t((c.regs[1] & 0xD5) | FLAG_FIXED);
+    s.B = c.regs[2]; s.C = c.regs[3];
+    s.D = c.regs[4]; s.E = c.regs[5];
+    s.H = c.regs[6]; s.L = c.regs[7];
+    s.SP = c.SP; s.PC = c.PC;
+    s.inte = c.inte;
+    s.halted = false;
+}
+
+uint64_t fnv1a(uint64_t h, const uint8_t* p, size_t n) {
+    for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 0x100000001B3ULL; }
+    return h;
+}
+constexpr uint64_t FNV_BASIS = 0xCBF29CE484222325ULL;
+
+// I/O that depends only on the port and the access sequence, with a running
+// hash of everything the guest wrote.
+struct DetIO {
+    IOBus    bus;
+    uint64_t hash  = FNV_BASIS;
+    uint32_t reads = 0;
+
+    DetIO() {
+        bus.in_handler = [this](uint8_t port) -> uint8_t {
+            uint8_t rec[2] = {0x01, port};
+            hash = fnv1a(hash, rec, 2);
+            return uint8_t(port * 31 + (reads++) * 7);
+        };
+        bus.out_handler = [this](uint8_t port, uint8_t val) {
+            uint8_t rec[3] = {0x02, port, val};
+            hash = fnv1a(hash, rec, 3);
+        };
+    }
+    DetIO(const DetIO&) = delete;
+    DetIO& operator=(const DetIO&) = delete;
+};
+
+struct Snapshot {
+    uint8_t  A, F, B, C, D, E, H, L;
+    uint16_t SP, PC;
+    bool     inte, halted;
+    uint64_t mem_hash, io_hash, cycles;
+
+    bool operator==(const Snapshot&) const = default;
+};
+
+Snapshot snap(const State8080& s, const DetIO& io, uint64_t cycles) {
+    return {s.A, s.F, s.B, s.C, s.D, s.E, s.H, s.L, s.SP, s.PC, s.inte, s.halted,
+            fnv1a(FNV_BASIS, s.mem.data(), s.mem.size()), io.hash, cycles};
+}
+
+std::string describe(const Snapshot& s) {
+    char buf[192];
+    std::snprintf(buf, sizeof buf,
+                  "A=%02X F=%02X B=%02X C=%02X D=%02X E=%02X H=%02X L=%02X SP=%04X PC=%04X "
+                  "inte=%d halt=%d mem=%016llx io=%016llx cycles=%llu",
+                  s.A, s.F, s.B, s.C, s.D, s.E, s.H, s.L, s.SP, s.PC, s.inte, s.halted,
+                  static_cast<unsigned long long>(s.mem_hash),
+                  static_cast<unsigned long long>(s.io_hash),
+                  static_cast<unsigned long long>(s.cycles));
+    return buf;
+}
+
+// ─── Differential check ───────────────────────────────────────────────────────
+struct Mismatch {
+    const char* engine;
+    uint64_t    after_insns;    // instructions executed when the states diverged
+    Snapshot    expected, actual;
+};
+
+std::optional<Mismatch> check(const Case& c, const std::vector<Engine>& engines) {
+    const size_t n = engines.size();
+    std::vector<State8080> states(n);
+    std::vector<DetIO>     ios(n);
+    std::vector<uint64_t>  cycles(n, 0);
+    for (auto& s : states) prepare(c, s);
+
+    for (uint64_t done = 0; done < c.steps;) {
+        uint64_t block = std::min<uint64_t>(BLOCK, c.steps - done);
+        for (size_t e = 0; e < n; ++e)
+            cycles[e] += engines[e].run(states[e], ios[e].bus, block);
+        done += block;
+
+        Snapshot ref = snap(states[0], ios[0], cycles[0]);
+        for (size_t e = 1; e < n; ++e) {
+            Snapshot got = snap(states[e], ios[e], cycles[e]);
+            if (!(got == ref)) return Mismatch{engines[e].name, done, ref, got};
+        }
+        if (states[0].halted) break;
+    }
+    return std::nullopt;
+}
+
+// ─── Minimisation ─────────────────────────────────────────────────────────────
+// Greedy: keep any simplification under which some engine still diverges.
+Case minimize(Case c, const std::vector<Engine>& engines) {
+    auto fails = [&](const Case& t) { return check(t, engines).has_value(); };
+
+    if (auto m = check(c, engines)) c.steps = uint16_t(m->after_insns);
+
+    for (bool progress = true; progress;) {
+        progress = false;
+        auto attempt = [&](Case t) {
+            if (fails(t)) { c = std::move(t); progress = true; return true; }
+            return false;
+        };
+
+        while (c.steps > 1) {                          // fewer instructions
+            Case t = c; --t.steps;
+            if (!attempt(t)) break;
+        }
+        if (c.mem_seed) { Case t = c; t.mem_seed = 0; attempt(t); }
+        while (!c.code.empty()) {                      // shorter code
+            Case t = c; t.code.pop_back();
+            if (!attempt(t)) break;
+        }
+        for (size_t i = 0; i < c.code.size(); ++i)     // NOP out code bytes
+            if (c.code[i] != 0x00) { Case t = c; t.code[i] = 0x00; attempt(t); }
+        for (int r = 0; r < 8; ++r) {                  // simpler registers
+            uint8_t plain = (r == 1) ? FLAG_FIXED : 0;
+            if (c.regs[r] != plain) { Case t = c; t.regs[r] = plain; attempt(t); }
+        }
+        if (c.SP)   { Case t = c; t.SP = 0;       attempt(t); }
+        if (c.inte) { Case t = c; t.inte = false; attempt(t); }
+    }
+    return c;
+}
+
+void report(const Case& c, const std::vector<Engine>& engines, const char* artifact_prefix) {
+    std::optional<Mismatch> m = check(c, engines);
+    if (!m) return;
+
+    std::fprintf(stderr, "MISMATCH: engine '%s' diverged from '%s' after %llu instruction(s)\n",
+                 m->engine, engines[0].name, static_cast<unsigned long long>(m->after_insns));
+    std::fprintf(stderr, "  expected: %s\n", describe(m->expected).c_str());
+    std::fprintf(stderr, "  actual:   %s\n", describe(m->actual).c_str());
+    std::fprintf(stderr, "  start:    A=%02X F=%02X B=%02X C=%02X D=%02X E=%02X H=%02X L=%02X "
+                         "SP=%04X PC=%04X inte=%d mem_seed=%08X\n  code:    ",
+                 c.regs[0], c.regs[1], c.regs[2], c.regs[3], c.regs[4], c.regs[5], c.regs[6], c.regs[7],
+                 c.SP, c.PC, c.inte, c.mem_seed);
+    for (uint8_t b : c.code) std::fprintf(stderr, " %02X", b);
+    std::fprintf(stderr, "\n");
+
+    std::vector<uint8_t> bytes = encode(c);
+    uint64_t h = fnv1a(FNV_BASIS, bytes.data(), bytes.size());
+    char name[64];
+    std::snprintf(name, sizeof name, "%016llx.bin", static_cast<unsigned long long>(h));
+    std::string path = std::string(artifact_prefix) + name;
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()),
+                                                std::streamsize(bytes.size()));
+    std::fprintf(stderr, "  reproducer written to %s\n", path.c_str());
+}
+
+#ifndef NATIVE8080_LIBFUZZER
+// Deliberately broken engine for --self-test: DAA never sets the carry.
+uint64_t run_broken(State8080& s, IOBus& io, uint64_t max_insns) {
+    uint64_t cycles = 0;
+    for (; max_insns && !s.halted; --max_insns) {
+        bool daa = s.mem[s.PC] == 0x27;
+        cycles += Step8080(s, io);
+        if (daa) s.set_cy(false);
+    }
+    return cycles;
+}
+#endif
+
+} // namespace
+
+#ifdef NATIVE8080_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    Case c = decode(data, size);
+    const std::vector<Engine>& engines = Engines();
+    if (check(c, engines)) {
+        report(minimize(c, engines), engines, "crash-");
+        std::abort();
+    }
+    return 0;
+}
+
+#else
+
+namespace {
+
+Case random_case(std::mt19937_64& rng, uint16_t max_steps) {
+    Case c;
+    uint64_t r = rng();
+    for (int i = 0; i < 8; ++i) c.regs[i] = uint8_t(r >> (8 * i));
+    r = rng();
+    c.SP       = uint16_t(r);
+    c.PC       = uint16_t(r >> 16);
+    c.inte     = (r >> 32) & 1;
+    c.mem_seed = uint32_t(rng()) | 1;
+    c.steps    = uint16_t(1 + rng() % max_steps);
+    c.code.resize(1 + rng() % 64);
+    for (auto& b : c.code) b = uint8_t(rng());
+    return c;
+}
+
+void usage(const char* argv0) {
+    std::fprintf(stderr, "Usage: %s [--iterations N] [--seed S] [--steps N] [--self-test] [case.bin ...]\n", argv0);
+    std::fprintf(stderr, "  Without case files, runs N random cases (default 20000) on every engine.\n");
+    std::fprintf(stderr, "  --self-test adds a deliberately broken engine to check the harness.\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint64_t iterations = 20'000;
+    uint64_t seed       = 1;
+    uint16_t max_steps  = 256;
+    bool     self_test  = false;
+    std::vector<const char*> files;
+
+    for (int i = 1; i < argc; ++i) {
+        if      (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) iterations = std::strtoull(argv[++i], nullptr, 0);
+        else if (std::strcmp(argv[i], "--seed")       == 0 && i + 1 < argc) seed       = std::strtoull(argv[++i], nullptr, 0);
+        else if (std::strcmp(argv[i], "--steps")      == 0 && i + 1 < argc)
+            max_steps = uint16_t(std::clamp<unsigned long>(std::strtoul(argv[++i], nullptr, 0), 1, MAX_STEPS));
+        else if (std::strcmp(argv[i], "--self-test")  == 0) self_test = true;
+        else if (argv[i][0] == '-') { usage(argv[0]); return 2; }
+        else files.push_back(argv[i]);
+    }
+
+    std::vector<Engine> engines = Engines();
+    if (self_test) engines.push_back({"broken-daa", run_broken});
+    if (engines.size() < 2)
+        std::fprintf(stderr, "note: only the reference engine is registered\n");
+
+    // Replay mode
+    if (!files.empty()) {
+        int failures = 0;
+        for (const char* path : files) {
+            std::ifstream in(path, std::ios::binary);
+            std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            if (!in.good() && !in.eof()) { std::perror(path); return 2; }
+            Case c = decode(bytes.data(), bytes.size());
+            if (check(c, engines)) { report(c, engines, "replay-"); ++failures; }
+            else std::fprintf(stderr, "%s: ok\n", path);
+        }
+        return failures ? 1 : 0;
+    }
+
+    std::mt19937_64 rng(seed);
+    for (uint64_t it = 0; it < iterations; ++it) {
+        Case c = random_case(rng, max_steps);
+        if (check(c, engines)) {
+            std::fprintf(stderr, "iteration %llu (seed %llu) diverged; minimising...\n",
+                         static_cast<unsigned long long>(it), static_cast<unsigned long long>(seed));
+            report(minimize(c, engines), engines, "crash-");
+            return 1;
+        }
+    }
+    std::fprintf(stderr, "%llu cases, %zu engines: no divergence\n",
+                 static_cast<unsigned long long>(iterations), engines.size());
+    return 0;
+}
+
+#endif
@@ -0,0 +1,38 @@
+#include "altair.h"
+
+Altair::Altair(const AltairConfig& config) : config_(config) {
+    MachineConfig mc;
+    mc.console  = nullptr;
+    mc.throttle = config_.throttle;
+    machine_ = std::make_unique<Machine>(mc);
+    sio_     = std::make_unique<Sio2>(machine_->runner(), machine_->state(), config_.sio);
+    machine_->set_in_handler ([this](uint8_t port) { return in(port); });
+    machine_->set_out_handler([this](uint8_t port, uint8_t val) { out(port, val); });
+}
+
+void Altair::load(const char* path, uint16_t addr) {
+    machine_->load(path, addr);
+    machine_->state().PC = addr;
+}
+
+void Altair::load(const uint8_t* data, size_t size, uint16_t addr) {
+    machine_->load(data, size, addr);
+    machine_->state().PC = addr;
+}
+
+StopReason Altair::run(const RunLimits& limits) {
+    const StopReason reason = machine_->run(limits);
+    sio_->flush();
+    return reason;
+}
+
+// ─── Ports ────────────────────────────────────────────────────────────────────
+uint8_t Altair::in(uint8_t port) {
+    if (sio_->owns(port)) return sio_->in(port);
+    if (port == 0xFF)     return config_.sense;
+    return 0xFF;
+}
+
+void Altair::out(uint8_t port, uint8_t val) {
+    if (sio_->owns(port)) sio_->out(port, val);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "machine.h"
+#include "runner.h"
+#include "sio.h"
+#include "throttle.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+// ─── Altair 8800 profile ──────────────────────────────────────────────────────
+// A MITS Altair 8800 as Altair BASIC and its monitors expect it: 64 KB of RAM,
+// an 88-2SIO serial board at ports 0x10-0x13 with channel A on the host
+// console, and the front-panel sense switches.
+//
+//   IN  0x10-0x13  88-2SIO (see sio.h)
+//   IN  0xFF       sense switches A15-A8 (AltairConfig::sense)
+//
+// Other ports read 0xFF and ignore writes.  Images load at 0x0000 by default
+// and start at their load address.
+
+struct AltairConfig {
+    uint8_t    sense = 0x00;
+    Sio2Config sio;
+
+    std::optional<ThrottleConfig> throttle;   // unset = run flat out
+};
+
+class Altair {
+public:
+    static constexpr uint64_t CLOCK_HZ = 2'000'000;
+
+    explicit Altair(const AltairConfig& config = {});
+
+    Altair(const Altair&)            = delete;
+    Altair& operator=(const Altair&) = delete;
+
+    // Load an image and point PC at it.  Throws std::runtime_error.
+    void load(const char* path, uint16_t addr = 0x0000);
+    void load(const uint8_t* data, size_t size, uint16_t addr = 0x0000);
+
+    // Run until halted, limited or stopped; a program waiting for console
+    // input after the input has ended stops with StopReason::Trap.
+    StopReason run(const RunLimits& limits = {});
+
+    Sio2&    sio()     { return *sio_; }
+    Machine& machine() { return *machine_; }
+
+private:
+    uint8_t in(uint8_t port);
+    void    out(uint8_t port, uint8_t val);
+
+    AltairConfig             config_;
+    std::unique_ptr<Machine> machine_;
+    std::unique_ptr<Sio2>    sio_;             // destroyed first: it wraps the runner
+};
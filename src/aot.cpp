@@ -0,0 +1,80 @@
+#include "aot.h"
+#include "cpm.h"
+#include "runner.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+bool AotProgram::intact(const State8080& s) const {
+    for (size_t i = 0; i < code_range_count; ++i) {
+        const AotRange& r = code_ranges[i];
+        if (std::memcmp(&s.mem[r.first], image + (r.first - origin), r.size) != 0) return false;
+    }
+    return true;
+}
+
+// ─── Registry ─────────────────────────────────────────────────────────────────
+namespace {
+
+std::vector<const AotProgram*>& registry() {
+    static std::vector<const AotProgram*> programs;
+    return programs;
+}
+
+}  // namespace
+
+const std::vector<const AotProgram*>& AotPrograms() { return registry(); }
+
+AotRegistration::AotRegistration(const AotProgram& program) { registry().push_back(&program); }
+
+const AotProgram* FindAotProgram(const State8080& s) {
+    for (const AotProgram* p : registry())
+        if (p->origin + p->size <= s.mem.size() && std::memcmp(&s.mem[p->origin], p->image, p->size) == 0)
+            return p;
+    return nullptr;
+}
+
+// ─── Stand-alone programs ─────────────────────────────────────────────────────
+int AotMain(int argc, char* argv[]) {
+    if (AotPrograms().size() != 1) {
+        std::fprintf(stderr, "%s: expected one translated program, found %zu\n", argv[0], AotPrograms().size());
+        return 1;
+    }
+    const AotProgram& program = *AotPrograms().front();
+
+    bool      interpret = false;
+    RunLimits limits;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--interpret") == 0) {
+            interpret = true;
+        } else if (std::strcmp(argv[i], "--max-cycles") == 0 && i + 1 < argc) {
+            limits.max_cycles = std::strtoull(argv[++i], nullptr, 0);
+        } else if (std::strcmp(argv[i], "--max-instructions") == 0 && i + 1 < argc) {
+            limits.max_instructions = std::strtoull(argv[++i], nullptr, 0);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--interpret] [--max-cycles N] [--max-instructions N]\n"
+                                 "  Runs %s (translated from 0x%04X) under the CP/M shim.\n",
+                         argv[0], program.name, program.origin);
+            return 1;
+        }
+    }
+
+    State8080 state;
+    IOBus     io;
+    CpmShim   cpm;
+    cpm.setup(state);
+    std::memcpy(&state.mem[program.origin], program.image, program.size);
+    state.PC = program.origin;
+
+    Runner runner(state, io);
+    cpm.attach(runner);
+    if (!interpret) runner.set_translation(&program);
+
+    const StopReason reason = runner.run(limits);
+    std::fprintf(stderr, "\n%s: CPU stopped (%s). PC=0x%04X cycles=%llu instructions=%llu\n",
+                 program.name, StopReasonName(reason), state.PC,
+                 static_cast<unsigned long long>(runner.cycles()),
+                 static_cast<unsigned long long>(runner.instructions()));
+    return StopReasonExitStatus(reason);
+}
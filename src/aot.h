@@ -0,0 +1,312 @@
+#pragma once
+#include "cpu8080.h"
+#include "step8080.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// ─── Ahead-of-time translated programs ────────────────────────────────────────
+// native8080_aot (tools/aot8080.cpp) turns a fixed program image into C++:
+// it recovers the control flow graph from the entry point, and every basic
+// block becomes a label in one function that executes the block's
+// instructions as straight-line code and jumps directly to its successors.
+// What it cannot see statically goes through a dispatch switch over all
+// block entries (RET, PCHL) or back to the interpreter (any other address).
+//
+// A Runner executes a program's blocks in place of Step8080 once it is set
+// with Runner::set_translation(); nothing else changes.  Cycle and
+// instruction counts, traps, events, interrupts and run limits behave
+// exactly as when interpreting:
+//
+//   - A block is only entered if it cannot cross the end of the slice or the
+//     instruction limit; the interpreter finishes the slice otherwise.
+//   - IN and OUT end a block, so a request they raise is seen after them;
+//     the cycle count, the registers and PC are exact inside their handlers.
+//   - EI ends the run, so the runner knows not to take an interrupt before
+//     the instruction after it.
+//   - Translation is off while a trap is armed on an address inside the
+//     translated code (checked when a run starts and after a trap handler
+//     changes the trap set).
+//   - Self-modifying code: a store to a byte of translated code switches the
+//     program into a verifying mode, in which each block runs on its own and
+//     only if its bytes still match the image; otherwise the interpreter
+//     executes it.  A block whose own remaining bytes change leaves at once.
+//     Stores the interpreter executes (outside translated code) and those
+//     trap handlers report (Runner::note_stores()) are caught the same way,
+//     as are changes made between runs; I/O handlers that write to
+//     translated code are not.
+//
+// Translated programs register themselves (AotRegistration); a program that
+// links one can find it by the image it was made from.
+
+struct AotContext;
+
+struct AotRange {
+    uint16_t first;
+    uint16_t size;
+};
+
+struct AotProgram {
+    const char*     name;
+    uint16_t        origin;              // load address of the image
+    const uint8_t*  image;
+    size_t          size;
+    const uint64_t* code;                // 64K-bit map of translated instruction bytes
+    const AotRange* code_ranges;         // the same as runs of bytes
+    size_t          code_range_count;
+    size_t          blocks;
+
+    // Execute translated blocks from PC for as long as possible.  Returns
+    // false, having done nothing, if no block can be entered at PC.
+    bool (*run)(AotContext& cx);
+
+    // Whether the translated bytes in `s` are those of the image.
+    bool intact(const State8080& s) const;
+
+    bool is_code(uint16_t addr) const { return code[addr >> 6] >> (addr & 63) & 1; }
+};
+
+// What translated code runs against; set up by the Runner for each entry.
+struct AotContext {
+    State8080&        s;
+    IOBus&            io;
+    const AotProgram& program;
+    uint64_t&         cycles;
+    uint64_t&         instructions;
+    const uint64_t&   slice_end;         // cut to 0 by an interrupt request
+    uint64_t          insn_end;
+    uint64_t          chain_insn_end;    // 0 while verifying: blocks do not chain
+    bool              verify;            // dispatch checks blocks against the image
+    bool              smc = false;       // a store hit translated code
+    bool              ei = false;        // the run ended straight after EI
+};
+
+// ─── Registry ─────────────────────────────────────────────────────────────────
+const std::vector<const AotProgram*>& AotPrograms();
+
+struct AotRegistration {
+    explicit AotRegistration(const AotProgram& program);
+};
+
+// The registered program whose image is in `s` at its origin, if any.
+const AotProgram* FindAotProgram(const State8080& s);
+
+// Entry point of a stand-alone translated CP/M program (tools/aotmain.cpp):
+// runs the registered program like `native8080 program.com`.
+int AotMain(int argc, char* argv[]);
+
+// ─── Support for generated code ───────────────────────────────────────────────
+// The instruction semantics as the interpreter has them (step8080.h), one
+// function per operation.
+//
+// Operations that set flags take the flags still read afterwards as `Live`
+// (the translator works it out per instruction, with every flag live
+// wherever translated code may leave) and compute only those; the others
+// keep their old values until an instruction that is read overwrites them.
+namespace aot {
+
+using namespace step8080_detail;
+
+constexpr uint8_t ALL = FLAG_S | FLAG_Z | FLAG_AC | FLAG_P | FLAG_CY;
+
+// Generated code keeps the registers, the counters and the memory base in
+// locals, which stores to emulated memory cannot alias, so they stay in host
+// registers across blocks; they go back to the State8080 and the runner only
+// where translated code leaves, and around IN and OUT.
+constexpr uint16_t pair(uint8_t hi, uint8_t lo) { return uint16_t(hi << 8 | lo); }
+
+constexpr void split(uint8_t& hi, uint8_t& lo, uint16_t v) {
+    hi = uint8_t(v >> 8);
+    lo = uint8_t(v);
+}
+
+// A block's own remaining bytes differ from the image.
+inline bool changed(const AotContext& cx, uint16_t addr, uint16_t size) {
+    const uint8_t* image = cx.program.image + (addr - cx.program.origin);
+    for (uint16_t i = 0; i < size; ++i)
+        if (cx.s.mem[uint16_t(addr + i)] != image[i]) return true;
+    return false;
+}
+
+// A store into translated code stops blocks chaining and makes dispatch
+// verify, so no other block runs on stale bytes; the running block leaves
+// at once only if its own remaining bytes changed (changed()).
+[[gnu::cold]] inline void wrote_code(AotContext& cx) {
+    cx.smc            = true;
+    cx.verify         = true;
+    cx.chain_insn_end = 0;
+}
+
+struct Memory {
+    uint8_t*        mem;
+    const uint64_t* code;                // AotProgram::code
+    AotContext&     cx;
+
+    uint8_t operator[](uint16_t addr) const { return mem[addr]; }
+
+    void store(uint16_t addr, uint8_t v) const {
+        mem[addr] = v;
+        if (code[addr >> 6] >> (addr & 63) & 1) wrote_code(cx);
+    }
+};
+
+inline void push(const Memory& m, uint16_t& sp, uint16_t v) {
+    sp = uint16_t(sp - 2);
+    m.store(sp, uint8_t(v));
+    m.store(uint16_t(sp + 1), uint8_t(v >> 8));
+}
+
+inline uint16_t pop(const Memory& m, uint16_t& sp) {
+    const uint16_t v = pair(m[uint16_t(sp + 1)], m[sp]);
+    sp = uint16_t(sp + 2);
+    return v;
+}
+
+inline uint8_t in(AotContext& cx, uint8_t port) {
+    return cx.io.in_handler ? cx.io.in_handler(port) : 0xFF;
+}
+
+inline void out(AotContext& cx, uint8_t port, uint8_t val) {
+    if (cx.io.out_handler) cx.io.out_handler(port, val);
+}
+
+// Whether a dispatched block may run: it fits in the slice and the
+// instruction budget, and (while verifying) its bytes are the image's.
+inline bool enter(const AotContext& cx, uint64_t cycles, uint64_t insns, uint64_t slice_end,
+                  uint64_t block_cycles, uint64_t block_insns, uint16_t addr, uint16_t size) {
+    if (cycles + block_cycles > slice_end || insns + block_insns > cx.insn_end) return false;
+    return !cx.verify || !changed(cx, addr, size);
+}
+
+// ── Flags ──
+template <uint8_t Live>
+inline void set_szp(uint8_t& f, uint8_t r) {
+    constexpr uint8_t m = Live & (FLAG_S | FLAG_Z | FLAG_P);
+    if constexpr (m & FLAG_P)
+        f = uint8_t((f & ~m) | (SZP_FLAGS[r] & m));
+    else if constexpr (m)
+        f = uint8_t((f & ~m) | (r & FLAG_S & m) | (r == 0 ? FLAG_Z & m : 0));
+}
+
+template <uint8_t Live, uint8_t Flag>
+inline void set_flag(uint8_t& f, bool v) {
+    if constexpr (Live & Flag) f = uint8_t(v ? f | Flag : f & ~Flag);
+}
+
+// ── Operations ──
+template <uint8_t Live>
+inline void add(uint8_t& a, uint8_t& f, uint8_t v, uint8_t cy = 0) {
+    const unsigned res = unsigned(a) + v + cy;
+    set_szp<Live>(f, uint8_t(res));
+    set_flag<Live, FLAG_CY>(f, res > 0xFF);
+    set_flag<Live, FLAG_AC>(f, (a & 0x0F) + (v & 0x0F) + cy > 0x0F);
+    a = uint8_t(res);
+}
+
+template <uint8_t Live>
+inline void cmp(uint8_t a, uint8_t& f, uint8_t v, uint8_t cy = 0) {
+    const unsigned res = unsigned(a) - v - cy;
+    set_szp<Live>(f, uint8_t(res));
+    set_flag<Live, FLAG_CY>(f, res > 0xFF);
+    set_flag<Live, FLAG_AC>(f, int(a & 0x0F) - int(v & 0x0F) - cy < 0);
+}
+
+template <uint8_t Live>
+inline void sub(uint8_t& a, uint8_t& f, uint8_t v, uint8_t cy = 0) {
+    cmp<Live>(a, f, v, cy);
+    a = uint8_t(a - v - cy);
+}
+
+template <uint8_t Live>
+inline void ana(uint8_t& a, uint8_t& f, uint8_t v) {
+    set_flag<Live, FLAG_AC>(f, ((a | v) & 0x08) != 0);
+    a &= v;
+    set_szp<Live>(f, a);
+    set_flag<Live, FLAG_CY>(f, false);
+}
+
+template <uint8_t Live>
+inline void xra(uint8_t& a, uint8_t& f, uint8_t v) {
+    a ^= v;
+    set_szp<Live>(f, a);
+    set_flag<Live, FLAG_CY>(f, false);
+    set_flag<Live, FLAG_AC>(f, false);
+}
+
+template <uint8_t Live>
+inline void ora(uint8_t& a, uint8_t& f, uint8_t v) {
+    a |= v;
+    set_szp<Live>(f, a);
+    set_flag<Live, FLAG_CY>(f, false);
+    set_flag<Live, FLAG_AC>(f, false);
+}
+
+template <uint8_t Live>
+inline uint8_t inr(uint8_t& f, uint8_t v) {
+    const uint8_t res = uint8_t(v + 1);
+    set_flag<Live, FLAG_AC>(f, (v & 0x0F) == 0x0F);
+    set_szp<Live>(f, res);
+    return res;
+}
+
+template <uint8_t Live>
+inline uint8_t dcr(uint8_t& f, uint8_t v) {
+    const uint8_t res = uint8_t(v - 1);
+    set_flag<Live, FLAG_AC>(f, (v & 0x0F) == 0x00);
+    set_szp<Live>(f, res);
+    return res;
+}
+
+// Returns the new HL.
+template <uint8_t Live>
+inline uint16_t dad(uint8_t& f, uint16_t hl, uint16_t v) {
+    set_flag<Live, FLAG_CY>(f, hl + v > 0xFFFF);
+    return uint16_t(hl + v);
+}
+
+template <uint8_t Live>
+inline void daa(uint8_t& a, uint8_t& f) {
+    uint8_t corr   = 0;
+    bool    new_cy = false;
+    if ((f & FLAG_AC) || (a & 0x0F) > 9) corr |= 0x06;
+    if ((f & FLAG_CY) || a > 0x99) {
+        corr  |= 0x60;
+        new_cy = true;
+    }
+    set_flag<Live, FLAG_AC>(f, (a & 0x0F) + (corr & 0x0F) > 0x0F);
+    a = uint8_t(a + corr);
+    set_szp<Live>(f, a);
+    set_flag<Live, FLAG_CY>(f, new_cy);
+}
+
+template <uint8_t Live>
+inline void rlc(uint8_t& a, uint8_t& f) {
+    const uint8_t msb = a >> 7;
+    a = uint8_t(a << 1 | msb);
+    set_flag<Live, FLAG_CY>(f, msb);
+}
+
+template <uint8_t Live>
+inline void rrc(uint8_t& a, uint8_t& f) {
+    const uint8_t lsb = a & 1;
+    a = uint8_t(a >> 1 | lsb << 7);
+    set_flag<Live, FLAG_CY>(f, lsb);
+}
+
+template <uint8_t Live>
+inline void ral(uint8_t& a, uint8_t& f) {
+    const uint8_t msb = a >> 7;
+    a = uint8_t(a << 1 | (f & FLAG_CY));
+    set_flag<Live, FLAG_CY>(f, msb);
+}
+
+template <uint8_t Live>
+inline void rar(uint8_t& a, uint8_t& f) {
+    const uint8_t lsb = a & 1;
+    a = uint8_t(a >> 1 | (f & FLAG_CY) << 7);
+    set_flag<Live, FLAG_CY>(f, lsb);
+}
+
+}  // namespace aot
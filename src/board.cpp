@@ -0,0 +1,438 @@
+#include "board.h"
+#include "i8251.h"
+#include "i8253.h"
+#include "i8259.h"
+#include "sio.h"
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+static std::runtime_error board_error(const char* fmt, const std::string& a, const std::string& b = {}) {
+    char buf[512];
+    std::snprintf(buf, sizeof buf, fmt, a.c_str(), b.c_str());
+    return std::runtime_error(buf);
+}
+
+// ─── Parameters ───────────────────────────────────────────────────────────────
+const std::string* DeviceParams::find(const std::string& key) {
+    used_.insert(key);
+    const auto it = values_.find(key);
+    return it == values_.end() ? nullptr : &it->second;
+}
+
+uint64_t DeviceParams::number(const std::string& key, uint64_t fallback) {
+    const std::string* v = find(key);
+    if (!v) return fallback;
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long n = std::strtoull(v->c_str(), &end, 0);
+    if (v->empty() || *end || errno || (*v)[0] == '-')
+        throw board_error("Parameter '%s': not a number: '%s'", key, *v);
+    return n;
+}
+
+uint64_t DeviceParams::number(const std::string& key) {
+    if (!values_.count(key)) throw board_error("Missing parameter '%s'", key);
+    return number(key, 0);
+}
+
+std::string DeviceParams::text(const std::string& key, const std::string& fallback) {
+    const std::string* v = find(key);
+    return v ? *v : fallback;
+}
+
+std::string DeviceParams::text(const std::string& key) {
+    const std::string* v = find(key);
+    if (!v) throw board_error("Missing parameter '%s'", key);
+    return *v;
+}
+
+bool DeviceParams::flag(const std::string& key, bool fallback) {
+    const std::string* v = find(key);
+    if (!v) return fallback;
+    if (*v == "1" || *v == "true" || *v == "yes" || *v == "on")  return true;
+    if (*v == "0" || *v == "false" || *v == "no" || *v == "off") return false;
+    throw board_error("Parameter '%s': not a flag: '%s'", key, *v);
+}
+
+std::optional<std::string> DeviceParams::unused() const {
+    for (const auto& [key, value] : values_)
+        if (!used_.count(key)) return key;
+    return std::nullopt;
+}
+
+static uint8_t port_param(DeviceParams& p, const std::string& key, uint64_t fallback) {
+    const uint64_t v = p.number(key, fallback);
+    if (v > 0xFF) throw board_error("Parameter '%s': not a port: '%s'", key, p.text(key, ""));
+    return uint8_t(v);
+}
+
+// ─── Built-in devices ─────────────────────────────────────────────────────────
+namespace {
+
+// A read-only port, e.g. the Altair's front-panel sense switches.
+class Switches : public Device {
+public:
+    Switches(uint8_t port, uint8_t value) : port_(port), value_(value) {}
+    std::vector<PortRange> ports() const override { return {{port_, port_}}; }
+    uint8_t in(uint8_t) override { return value_; }
+
+private:
+    uint8_t port_;
+    uint8_t value_;
+};
+
+// An image read once and copied into its range on every reset.
+class Rom : public Device {
+public:
+    Rom(State8080& state, const std::string& path, uint16_t addr) : state_(state), addr_(addr) {
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) throw board_error("Cannot open ROM image '%s'", path);
+        uint8_t buf[4096];
+        size_t  n;
+        while ((n = std::fread(buf, 1, sizeof buf, f)) > 0) image_.insert(image_.end(), buf, buf + n);
+        std::fclose(f);
+        if (image_.empty() || image_.size() > size_t(0x10000 - addr))
+            throw board_error("ROM image '%s' is empty or does not fit in memory", path);
+    }
+    std::vector<MemoryRange> memory() const override {
+        return {{addr_, uint16_t(addr_ + image_.size() - 1)}};
+    }
+    void reset() override { std::memcpy(state_.mem.data() + addr_, image_.data(), image_.size()); }
+
+private:
+    State8080&           state_;
+    uint16_t             addr_;
+    std::vector<uint8_t> image_;
+};
+
+}  // namespace
+
+DeviceRegistry& DeviceRegistry::global() {
+    static DeviceRegistry registry = [] {
+        DeviceRegistry r;
+        r.add("i8251", [](const DeviceContext& ctx, DeviceParams& p) -> std::unique_ptr<Device> {
+            I8251Config config;
+            static_cast<SerialConfig&>(config) = ctx.console;
+            config.base        = port_param(p, "base", config.base);
+            config.char_cycles = p.number("char_cycles", config.char_cycles);
+            return std::make_unique<I8251>(ctx.runner, ctx.state, config);
+        });
+        r.add("i8253", [](const DeviceContext& ctx, DeviceParams& p) -> std::unique_ptr<Device> {
+            const uint8_t  base     = port_param(p, "base", 0xDC);
+            const uint64_t clock_hz = p.number("clock_hz", ctx.clock_hz);
+            if (!clock_hz) throw std::runtime_error("Parameter 'clock_hz': must not be zero");
+            return std::make_unique<I8253>(ctx.runner, ctx.clock_hz, clock_hz, base);
+        });
+        r.add("i8259", [](const DeviceContext& ctx, DeviceParams& p) -> std::unique_ptr<Device> {
+            return std::make_unique<I8259>(ctx.runner, port_param(p, "base", 0xDA));
+        });
+        r.add("2sio", [](const DeviceContext& ctx, DeviceParams& p) -> std::unique_ptr<Device> {
+            Sio2Config config;
+            static_cast<SerialConfig&>(config) = ctx.console;
+            config.base = port_param(p, "base", config.base);
+            return std::make_unique<Sio2>(ctx.runner, ctx.state, config);
+        });
+        r.add("switches", [](const DeviceContext&, DeviceParams& p) -> std::unique_ptr<Device> {
+            const uint8_t port  = port_param(p, "port", p.number("port"));    // required
+            const uint8_t value = port_param(p, "value", 0x00);
+            return std::make_unique<Switches>(port, value);
+        });
+        r.add("rom", [](const DeviceContext& ctx, DeviceParams& p) -> std::unique_ptr<Device> {
+            const uint64_t addr = p.number("addr", 0);
+            if (addr > 0xFFFF) throw std::runtime_error("Parameter 'addr': not an address");
+            return std::make_unique<Rom>(ctx.state, p.text("file"), uint16_t(addr));
+        });
+        return r;
+    }();
+    return registry;
+}
+
+void DeviceRegistry::add(const std::string& type, DeviceFactory factory) {
+    factories_[type] = std::move(factory);
+}
+
+std::unique_ptr<Device> DeviceRegistry::create(const std::string& type, const DeviceContext& ctx,
+                                               DeviceParams& params) const {
+    const auto it = factories_.find(type);
+    if (it == factories_.end()) throw board_error("Unknown device type '%s'", type);
+    return it->second(ctx, params);
+}
+
+void DeviceRegistry::load_plugin(const std::string& path) {
+    void* lib = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!lib) throw board_error("Cannot load plugin '%s': %s", path, dlerror());
+    using AbiFn      = int (*)();
+    using RegisterFn = void (*)(DeviceRegistry&);
+    const auto abi = reinterpret_cast<AbiFn>(dlsym(lib, "native8080_plugin_abi"));
+    const auto reg = reinterpret_cast<RegisterFn>(dlsym(lib, "native8080_register_devices"));
+    if (!abi || !reg) {
+        dlclose(lib);
+        throw board_error("'%s' is not a Native8080 device plugin", path);
+    }
+    if (abi() != NATIVE8080_DEVICE_ABI) {
+        dlclose(lib);
+        throw board_error("Plugin '%s' was built for another version of the device interface", path);
+    }
+    reg(*this);
+}
+
+// ─── Building ─────────────────────────────────────────────────────────────────
+Board::Board(const BoardSpec& spec, DeviceRegistry& registry) : clock_hz_(spec.clock_hz) {
+    for (const std::string& plugin : spec.plugins) registry.load_plugin(plugin);
+
+    MachineConfig mc;
+    mc.console  = nullptr;
+    mc.throttle = spec.throttle;
+    machine_ = std::make_unique<Machine>(mc);
+
+    map(spec.memory);
+    arm(spec.traps);
+    start_ = spec.start;
+    machine_->state().PC = spec.start.value_or(spec.load);
+
+    const DeviceContext ctx{machine_->runner(), machine_->state(), clock_hz_, spec.console};
+    slots_.reserve(spec.devices.size());              // ports_ points into it
+    for (const DeviceSpec& d : spec.devices) {
+        if (d.name.empty() || d.name.find('.') != std::string::npos)
+            throw board_error("Bad device name '%s'", d.name);
+        if (find(d.name) != slots_.size()) throw board_error("Duplicate device name '%s'", d.name);
+        DeviceParams params(d.params);
+        std::unique_ptr<Device> dev;
+        try {
+            dev = registry.create(d.type, ctx, params);
+        } catch (const std::exception& e) {
+            throw board_error("Device '%s': %s", d.name, e.what());
+        }
+        if (const auto key = params.unused()) throw board_error("Device '%s': unknown parameter '%s'", d.name, *key);
+        slots_.push_back(Slot{d.name, std::move(dev), std::nullopt, UINT64_MAX, {}});
+        attach(slots_.size() - 1);
+    }
+    for (const WireSpec& w : spec.wires) wire(w);
+
+    Runner& runner = machine_->runner();
+    for (const TimedInterruptSpec& i : spec.interrupts) {
+        if (i.rst > 7) throw board_error("Interrupt '%s': RST must be 0-7", i.name);
+        const uint8_t opcode = uint8_t(0xC7 | i.rst << 3);
+        const auto    fire   = [&runner, opcode](uint64_t) { runner.interrupt(opcode); };
+        interrupts_.push_back(i.period ? runner.events.every(i.first, i.period, fire)
+                                       : runner.events.at(i.first, fire));
+    }
+
+    machine_->set_in_handler ([this](uint8_t port) { return in(port); });
+    machine_->set_out_handler([this](uint8_t port, uint8_t val) { out(port, val); });
+    reset();
+}
+
+// Devices chain trap handlers onto the runner and must unhook in reverse.
+Board::~Board() {
+    while (!slots_.empty()) slots_.pop_back();
+}
+
+size_t Board::find(std::string_view name) const {
+    for (size_t i = 0; i < slots_.size(); ++i)
+        if (slots_[i].name == name) return i;
+    return slots_.size();
+}
+
+// ─── Memory map and traps ─────────────────────────────────────────────────────
+void Board::map(const std::vector<MemorySpec>& memory) {
+    if (memory.empty()) return;
+    pages_.fill(PageKind::None);
+    std::array<bool, 256> listed{};
+    for (const MemorySpec& m : memory) {
+        if ((m.first & 0xFF) != 0 || (m.last & 0xFF) != 0xFF || m.first > m.last) {
+            char range[16];
+            std::snprintf(range, sizeof range, "%04X-%04X", m.first, m.last);
+            throw board_error("Memory range %s is not a run of whole pages", range);
+        }
+        for (unsigned p = m.first >> 8; p <= unsigned(m.last >> 8); ++p) {
+            if (listed[p]) {
+                char page[8];
+                std::snprintf(page, sizeof page, "%04X", p << 8);
+                throw board_error("Page %s mapped twice", page);
+            }
+            listed[p] = true;
+            pages_[p] = m.kind;
+        }
+    }
+}
+
+void Board::check_mapped(uint16_t first, uint16_t last, const std::string& what) const {
+    for (unsigned p = first >> 8; p <= unsigned(last >> 8); ++p) {
+        if (pages_[p] == PageKind::None) {
+            char page[8];
+            std::snprintf(page, sizeof page, "%04X", p << 8);
+            throw board_error("%s reaches unmapped page %s", what, page);
+        }
+    }
+}
+
+// The board's own traps go first; devices wrap them and fall through here.
+void Board::arm(const std::vector<TrapSpec>& traps) {
+    if (traps.empty()) return;
+    TrapTable& t = machine_->runner().traps;
+    for (const TrapSpec& trap : traps) {
+        (trap.kind == TrapKind::Stop ? trap_stop_ : trap_return_).set(trap.addr);
+        t.arm(trap.addr);
+    }
+    t.handler = [this, base = std::move(t.handler)](State8080& s) {
+        if (trap_return_[s.PC]) {
+            s.PC = s.pop16();
+            return TrapAction::Resume;
+        }
+        if (trap_stop_[s.PC]) return TrapAction::Stop;
+        return base ? base(s) : TrapAction::Execute;
+    };
+}
+
+void Board::attach(size_t index) {
+    Slot& s = slots_[index];
+    for (const PortRange& r : s.dev->ports()) {
+        for (unsigned p = r.first; p <= r.last; ++p) {
+            if (ports_[p]) {
+                char port[8];
+                std::snprintf(port, sizeof port, "%02X", p);
+                throw board_error("Port %s claimed twice, the second time by '%s'", port, s.name);
+            }
+            ports_[p] = &s;
+        }
+    }
+    s.memory = s.dev->memory();
+    for (const MemoryRange& r : s.memory) {
+        if (r.first > r.last) throw board_error("Device '%s': empty memory range", s.name);
+        check_mapped(r.first, r.last, "Device '" + s.name + "'");
+        for (const Slot& other : slots_)
+            for (const MemoryRange& o : other.memory)
+                if (&other != &s && r.first <= o.last && o.first <= r.last)
+                    throw board_error("Memory claimed by both '%s' and '%s'", other.name, s.name);
+    }
+}
+
+// "pit.out0" -> "pic.ir2".  The receiving device's deadline may move when an
+// input changes, so it is re-read after each change.
+void Board::wire(const WireSpec& w) {
+    const auto split = [this](const std::string& end) {
+        const size_t dot = end.find('.');
+        const size_t i   = dot == std::string::npos ? slots_.size() : find(std::string_view(end).substr(0, dot));
+        if (i == slots_.size()) throw board_error("Bad wire end '%s': expected device.pin", end);
+        return std::pair<size_t, std::string>(i, end.substr(dot + 1));
+    };
+    const auto [from, out] = split(w.from);
+    const auto [to, in]    = split(w.to);
+    std::function<void(bool)> sink = slots_[to].dev->input(in);
+    if (!sink) throw board_error("No input pin '%s'", w.to);
+    Slot* target = &slots_[to];
+    if (!slots_[from].dev->connect(out, [this, target, sink](bool level) {
+            sink(level);
+            sync(*target);
+        }))
+        throw board_error("No output pin '%s'", w.from);
+    sync(slots_[from]);
+}
+
+// ─── Deadlines ────────────────────────────────────────────────────────────────
+// One scheduler event per device, moved only when the deadline does.
+void Board::sync(Slot& s, uint64_t floor) {
+    uint64_t next = s.dev->next_event_cycle();
+    if (next != UINT64_MAX) next = std::max(next, floor);
+    if (next == s.scheduled) return;
+    s.scheduled = next;
+    Scheduler& events = machine_->runner().events;
+    if (next == UINT64_MAX) {
+        events.cancel(*s.event);
+    } else if (s.event) {
+        events.reschedule(*s.event, next);
+    } else {
+        s.event = events.at(next, [this, slot = &s](uint64_t due) {
+            slot->scheduled = UINT64_MAX;             // fired: no longer pending
+            slot->dev->event(due);
+            sync(*slot, due + 1);                     // a deadline that did not move must not spin
+        });
+    }
+}
+
+// ─── Ports ────────────────────────────────────────────────────────────────────
+uint8_t Board::in(uint8_t port) {
+    Slot* s = ports_[port];
+    if (!s) return 0xFF;
+    const uint8_t v = s->dev->in(port);
+    sync(*s);
+    return v;
+}
+
+void Board::out(uint8_t port, uint8_t val) {
+    Slot* s = ports_[port];
+    if (!s) return;
+    s->dev->out(port, val);
+    sync(*s);
+}
+
+// ─── Running ──────────────────────────────────────────────────────────────────
+void Board::load(const char* path, uint16_t addr) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) throw board_error("Cannot open '%s'", path);
+    std::vector<uint8_t> image;
+    uint8_t buf[4096];
+    size_t  n;
+    while ((n = std::fread(buf, 1, sizeof buf, f)) > 0) image.insert(image.end(), buf, buf + n);
+    std::fclose(f);
+    load(image.data(), image.size(), addr);
+}
+
+void Board::load(const uint8_t* data, size_t size, uint16_t addr) {
+    if (size && size <= size_t(0x10000 - addr)) check_mapped(addr, uint16_t(addr + size - 1), "The image");
+    machine_->load(data, size, addr);
+    machine_->state().PC = start_.value_or(addr);
+}
+
+StopReason Board::run(const RunLimits& limits) {
+    const StopReason reason = machine_->run(limits);
+    for (Slot& s : slots_) s.dev->flush();
+    return reason;
+}
+
+void Board::reset() {
+    uint8_t* mem = machine_->state().mem.data();
+    for (unsigned p = 0; p < 256; ++p)
+        if (pages_[p] == PageKind::None) std::memset(mem + (p << 8), 0xFF, 256);
+    for (Slot& s : slots_) s.dev->reset();
+    for (Slot& s : slots_) sync(s);
+}
+
+// ─── Snapshots ────────────────────────────────────────────────────────────────
+BoardSnapshot Board::snapshot() const {
+    BoardSnapshot snap{machine_->snapshot(), {}, {}};
+    for (const Slot& s : slots_) {
+        StateWriter w(snap.devices.emplace_back());
+        s.dev->save(w);
+    }
+    const Scheduler& events = machine_->runner().events;
+    for (Scheduler::EventId id : interrupts_)
+        snap.interrupts.push_back(events.pending(id) ? events.due(id) : UINT64_MAX);
+    return snap;
+}
+
+void Board::restore(const BoardSnapshot& snap) {
+    if (snap.devices.size() != slots_.size() || snap.interrupts.size() != interrupts_.size())
+        throw std::runtime_error("Snapshot is from another board");
+    machine_->restore(snap.machine);
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        StateReader r(snap.devices[i].data(), snap.devices[i].size());
+        slots_[i].dev->restore(r);
+        if (!r.done()) throw board_error("Snapshot is from another board: state of '%s' too long", slots_[i].name);
+    }
+    for (Slot& s : slots_) sync(s);
+    // Timed interrupts are due at absolute cycles, which the restore rewound.
+    Scheduler& events = machine_->runner().events;
+    for (size_t i = 0; i < interrupts_.size(); ++i) {
+        if (snap.interrupts[i] == UINT64_MAX) events.cancel(interrupts_[i]);
+        else                                  events.reschedule(interrupts_[i], snap.interrupts[i]);
+    }
+}
@@ -0,0 +1,249 @@
+#pragma once
+#include "cpu8080.h"
+#include "device.h"
+#include "machine.h"
+#include "runner.h"
+#include "scheduler.h"
+#include "serial.h"
+#include "throttle.h"
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ─── Boards ───────────────────────────────────────────────────────────────────
+// A machine assembled from Device plugins (device.h) by name, rather than a
+// profile class that wires its chips by hand: a BoardSpec lists the devices
+// to create, their parameters and the wires between their pins, and the
+// Board builds them through a DeviceRegistry.  Device types come built in or
+// from shared-library plugins, so a new board needs neither the core nor the
+// front end recompiled.
+//
+// Built-in types and their parameters (numbers in C syntax: 0x1F, 31):
+//
+//   i8251     base (0xEC), char_cycles (2133)         pins rxrdy, txrdy
+//   i8253     base (0xDC), clock_hz (the CPU clock)   out0-2, gate0-2
+//   i8259     base (0xDA)                             ir0-7
+//   2sio      base (0x10)
+//   switches  port, value (0x00): a read-only port
+//   rom       file, addr (0x0000): an image copied into memory on reset
+//
+// The serial devices share BoardSpec::console.  At most one interrupt
+// controller (the last created) drives the CPU's interrupt line.
+//
+// Everything a spec declares is resolved once, when the board is built:
+// ports go into a 256-entry table the I/O bus indexes directly, memory
+// ranges are checked for overlaps and against a 256-entry page map, traps
+// are armed in the runner's bitmap with their actions in two more, and
+// each device with a deadline or timed interrupt gets one scheduler event
+// (see Device).  Nothing on the paths the CPU takes looks anything up by
+// name.  An access to a port nobody claims reads 0xFF and ignores the
+// write.  Descriptions can also come from a file (boardfile.h).
+
+// ─── Plugins ──────────────────────────────────────────────────────────────────
+// A plugin is a shared library exporting
+//
+//     extern "C" int  native8080_plugin_abi() { return NATIVE8080_DEVICE_ABI; }
+//     extern "C" void native8080_register_devices(DeviceRegistry& registry);
+//
+// built against the same headers as the program loading it, which must
+// export its symbols (the native8080 executable does).  Bump the ABI number
+// whenever Device, DeviceContext or DeviceParams change layout.
+#define NATIVE8080_DEVICE_ABI 1
+
+// The parameters of one device, as text.  Getters throw std::runtime_error
+// on malformed values; keys never asked for are reported by the board as
+// unknown.
+class DeviceParams {
+public:
+    explicit DeviceParams(const std::map<std::string, std::string>& values) : values_(values) {}
+
+    uint64_t    number(const std::string& key, uint64_t fallback);
+    uint64_t    number(const std::string& key);                 // required
+    std::string text(const std::string& key, const std::string& fallback);
+    std::string text(const std::string& key);                   // required
+    bool        flag(const std::string& key, bool fallback);
+
+    // The first key no getter asked for, if any.
+    std::optional<std::string> unused() const;
+
+private:
+    const std::string* find(const std::string& key);
+
+    const std::map<std::string, std::string>& values_;
+    std::set<std::string> used_;
+};
+
+// What a factory may use to build a device.
+struct DeviceContext {
+    Runner&             runner;
+    State8080&          state;
+    uint64_t            clock_hz;
+    const SerialConfig& console;
+};
+
+using DeviceFactory = std::function<std::unique_ptr<Device>(const DeviceContext& ctx, DeviceParams& params)>;
+
+class DeviceRegistry {
+public:
+    // The built-in types, plus whatever plugins have added.
+    static DeviceRegistry& global();
+
+    // Add or replace a type.
+    void add(const std::string& type, DeviceFactory factory);
+    bool has(const std::string& type) const { return factories_.count(type) != 0; }
+
+    // Throws std::runtime_error for an unknown type.
+    std::unique_ptr<Device> create(const std::string& type, const DeviceContext& ctx, DeviceParams& params) const;
+
+    // Load a plugin library and let it register its types.  Throws
+    // std::runtime_error.  The library stays loaded for the process.
+    void load_plugin(const std::string& path);
+
+private:
+    std::map<std::string, DeviceFactory> factories_;
+};
+
+// ─── Board description ────────────────────────────────────────────────────────
+// What each 256-byte page of the address space holds.  Memory stays flat and
+// writable (see Device): the map decides where images and device ranges may
+// go and what a reset puts there, and unmapped pages read as a floating bus
+// (0xFF).
+enum class PageKind : uint8_t { Ram, Rom, None };
+
+struct MemorySpec {
+    uint16_t first;                                    // page aligned
+    uint16_t last;                                     // last byte of a page
+    PageKind kind;
+};
+
+// At a trap address: stop the run (StopReason::Trap), or return to the
+// caller at once (stubbing out a routine).
+enum class TrapKind : uint8_t { Stop, Return };
+
+struct TrapSpec {
+    uint16_t addr;
+    TrapKind kind;
+};
+
+// An RST interrupt at `first` and then every `period` cycles (0 = once).
+struct TimedInterruptSpec {
+    std::string name;
+    uint64_t    first  = 0;
+    uint64_t    period = 0;
+    uint8_t     rst    = 0;                            // 0-7
+};
+
+struct DeviceSpec {
+    std::string type;                                  // registry type
+    std::string name;                                  // unique on the board
+    std::map<std::string, std::string> params;
+};
+
+// From an output pin to an input pin, each as "device.pin".
+struct WireSpec {
+    std::string from;
+    std::string to;
+};
+
+struct BoardSpec {
+    std::string              name;
+    uint64_t                 clock_hz = 2'000'000;
+    uint16_t                 load     = 0x0000;        // where images go by default
+    std::optional<uint16_t>  start;                    // PC after loading (default: the load address)
+    std::vector<std::string> plugins;                  // loaded before any device is created
+    std::vector<MemorySpec>  memory;                   // empty = all RAM; otherwise unlisted pages are unmapped
+    std::vector<DeviceSpec>  devices;                  // created, reset and restored in this order
+    std::vector<WireSpec>    wires;
+    std::vector<TrapSpec>    traps;
+    std::vector<TimedInterruptSpec> interrupts;
+    SerialConfig             console;
+
+    std::optional<ThrottleConfig> throttle;            // unset = run flat out
+};
+
+// A Machine snapshot plus each device's state, in board order, and when each
+// timed interrupt is next due (UINT64_MAX for a one-shot that has fired).
+struct BoardSnapshot {
+    MachineSnapshot                   machine;
+    std::vector<std::vector<uint8_t>> devices;
+    std::vector<uint64_t>             interrupts;
+};
+
+class Board {
+public:
+    // Throws std::runtime_error for an unknown type, parameter or pin, a
+    // duplicate name, a port or memory range claimed twice or a memory range
+    // outside mapped pages.
+    explicit Board(const BoardSpec& spec, DeviceRegistry& registry = DeviceRegistry::global());
+    ~Board();
+
+    Board(const Board&)            = delete;
+    Board& operator=(const Board&) = delete;
+
+    // Load an image into mapped pages and point PC at BoardSpec::start, or
+    // at the image.  Throws std::runtime_error.
+    void load(const char* path, uint16_t addr = 0x0000);
+    void load(const uint8_t* data, size_t size, uint16_t addr = 0x0000);
+
+    // Run until halted, limited or stopped, then flush the devices' output.
+    StopReason run(const RunLimits& limits = {});
+
+    // Every device back to its power-on state, in order, and unmapped pages
+    // back to 0xFF.  The CPU and RAM are left alone.
+    void reset();
+
+    // Restoring throws std::runtime_error if the snapshot is from another
+    // board.
+    BoardSnapshot snapshot() const;
+    void          restore(const BoardSnapshot& snap);
+
+    // The device called `name`: nullptr if there is none or it is not a T.
+    template <class T = Device>
+    T* device(std::string_view name) {
+        for (Slot& s : slots_)
+            if (s.name == name) return dynamic_cast<T*>(s.dev.get());
+        return nullptr;
+    }
+
+    uint64_t clock_hz() const           { return clock_hz_; }
+    PageKind page(uint16_t addr) const  { return pages_[addr >> 8]; }
+    Machine& machine()        { return *machine_; }
+
+private:
+    struct Slot {
+        std::string             name;
+        std::unique_ptr<Device> dev;
+        std::optional<Scheduler::EventId> event;
+        uint64_t                scheduled = UINT64_MAX;
+        std::vector<MemoryRange> memory;
+    };
+
+    void    attach(size_t index);
+    void    map(const std::vector<MemorySpec>& memory);
+    void    arm(const std::vector<TrapSpec>& traps);
+    void    check_mapped(uint16_t first, uint16_t last, const std::string& what) const;
+    void    wire(const WireSpec& w);
+    size_t  find(std::string_view name) const;
+    void    sync(Slot& s, uint64_t floor = 0);
+    uint8_t in(uint8_t port);
+    void    out(uint8_t port, uint8_t val);
+
+    uint64_t                 clock_hz_;
+    std::unique_ptr<Machine> machine_;                  // destroyed last: devices wrap its runner
+    std::vector<Slot>        slots_;
+    std::vector<Scheduler::EventId> interrupts_;        // one per TimedInterruptSpec
+    std::array<Slot*, 256>   ports_{};
+    std::array<PageKind, 256> pages_{};                 // all Ram
+    std::bitset<0x10000>     trap_stop_, trap_return_;
+    std::optional<uint16_t>  start_;
+};
@@ -0,0 +1,211 @@
+#include "boardfile.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// ─── Lines ────────────────────────────────────────────────────────────────────
+struct Parser {
+    std::string name;
+    std::string dir;
+    int         line = 0;
+
+    [[noreturn]] void fail(const std::string& msg) const {
+        throw std::runtime_error(name + ":" + std::to_string(line) + ": " + msg);
+    }
+
+    static std::string_view trim(std::string_view s) {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+        return s;
+    }
+
+    // Drop a comment, leaving quoted text alone.
+    static std::string_view strip(std::string_view s) {
+        bool quoted = false;
+        for (size_t i = 0; i < s.size(); ++i) {
+            if (s[i] == '"') quoted = !quoted;
+            else if (!quoted && (s[i] == '#' || s[i] == ';')) return trim(s.substr(0, i));
+        }
+        return trim(s);
+    }
+
+    std::string value(std::string_view v) const {
+        if (v.size() >= 2 && v.front() == '"' && v.back() == '"') return std::string(v.substr(1, v.size() - 2));
+        if (v.find('"') != std::string_view::npos) fail("unbalanced quotes");
+        return std::string(v);
+    }
+
+    uint64_t number(const std::string& v, uint64_t max = UINT64_MAX) const {
+        char* end = nullptr;
+        errno = 0;
+        const unsigned long long n = std::strtoull(v.c_str(), &end, 0);
+        if (v.empty() || *end || errno || v[0] == '-') fail("not a number: '" + v + "'");
+        if (n > max) fail("out of range: '" + v + "'");
+        return n;
+    }
+
+    uint16_t address(const std::string& v) const { return uint16_t(number(v, 0xFFFF)); }
+
+    bool flag(const std::string& v) const {
+        if (v == "1" || v == "true" || v == "yes" || v == "on")  return true;
+        if (v == "0" || v == "false" || v == "no" || v == "off") return false;
+        fail("not a flag: '" + v + "'");
+    }
+
+    std::string path(const std::string& v) const {
+        if (v.empty() || v[0] == '/' || dir.empty()) return v;
+        return dir + "/" + v;
+    }
+};
+
+}  // namespace
+
+// ─── Sections ─────────────────────────────────────────────────────────────────
+BoardSpec ParseBoardFile(std::string_view text, const std::string& name, const std::string& dir) {
+    Parser    p{name, dir};
+    BoardSpec spec;
+    bool      realtime = false;
+
+    enum class Section { None, Board, Memory, Device, Wires, Traps, Interrupt } section = Section::None;
+    DeviceSpec*         device    = nullptr;
+    TimedInterruptSpec* interrupt = nullptr;
+    bool                first_set = false;
+
+    const auto close_interrupt = [&] {
+        if (interrupt && !first_set) interrupt->first = interrupt->period;
+        interrupt = nullptr;
+    };
+
+    while (!text.empty()) {
+        const size_t eol = text.find('\n');
+        const std::string_view raw = text.substr(0, eol);
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+        ++p.line;
+
+        const std::string_view s = Parser::strip(raw);
+        if (s.empty()) continue;
+
+        if (s.front() == '[') {
+            if (s.back() != ']') p.fail("expected ']'");
+            close_interrupt();
+            device = nullptr;
+            const std::string header(Parser::trim(s.substr(1, s.size() - 2)));
+            const size_t      dot  = header.find('.');
+            const std::string kind = header.substr(0, dot);
+            const std::string sub  = dot == std::string::npos ? "" : header.substr(dot + 1);
+            if ((kind == "device" || kind == "interrupt") && sub.empty()) p.fail("[" + kind + ".NAME] needs a name");
+            if (kind != "device" && kind != "interrupt" && !sub.empty()) p.fail("unknown section [" + header + "]");
+            if (kind == "board") {
+                section = Section::Board;
+            } else if (kind == "memory") {
+                section = Section::Memory;
+            } else if (kind == "wires") {
+                section = Section::Wires;
+            } else if (kind == "traps") {
+                section = Section::Traps;
+            } else if (kind == "device") {
+                for (const DeviceSpec& d : spec.devices)
+                    if (d.name == sub) p.fail("device '" + sub + "' described twice");
+                section = Section::Device;
+                device  = &spec.devices.emplace_back();
+                device->name = sub;
+            } else if (kind == "interrupt") {
+                section   = Section::Interrupt;
+                interrupt = &spec.interrupts.emplace_back();
+                interrupt->name = sub;
+                first_set = false;
+            } else {
+                p.fail("unknown section [" + header + "]");
+            }
+            continue;
+        }
+
+        const size_t eq = s.find('=');
+        if (eq == std::string_view::npos) p.fail("expected 'key = value'");
+        const std::string key(Parser::trim(s.substr(0, eq)));
+        const std::string val = p.value(Parser::trim(s.substr(eq + 1)));
+        if (key.empty()) p.fail("missing key");
+
+        switch (section) {
+            case Section::None:
+                p.fail("'" + key + "' outside a section");
+            case Section::Board:
+                if (key == "name")          spec.name     = val;
+                else if (key == "clock")    spec.clock_hz = p.number(val);
+                else if (key == "load")     spec.load     = p.address(val);
+                else if (key == "start")    spec.start    = p.address(val);
+                else if (key == "realtime") realtime      = p.flag(val);
+                else if (key == "plugin")   spec.plugins.push_back(p.path(val));
+                else p.fail("unknown key '" + key + "' in [board]");
+                break;
+            case Section::Memory: {
+                const size_t dash = key.find('-');
+                if (dash == std::string::npos) p.fail("expected FIRST-LAST");
+                MemorySpec m{p.address(std::string(Parser::trim(std::string_view(key).substr(0, dash)))),
+                             p.address(std::string(Parser::trim(std::string_view(key).substr(dash + 1)))),
+                             PageKind::Ram};
+                if (val == "ram")       m.kind = PageKind::Ram;
+                else if (val == "rom")  m.kind = PageKind::Rom;
+                else if (val == "none") m.kind = PageKind::None;
+                else p.fail("expected ram, rom or none, not '" + val + "'");
+                if ((m.first & 0xFF) || (m.last & 0xFF) != 0xFF || m.first > m.last)
+                    p.fail("'" + key + "' is not a run of whole 256-byte pages");
+                spec.memory.push_back(m);
+                break;
+            }
+            case Section::Device:
+                if (key == "type") {
+                    device->type = val;
+                } else {
+                    if (device->params.count(key)) p.fail("'" + key + "' given twice");
+                    device->params[key] = key == "file" ? p.path(val) : val;
+                }
+                break;
+            case Section::Wires:
+                spec.wires.push_back({key, val});
+                break;
+            case Section::Traps:
+                if (val == "stop")     spec.traps.push_back({p.address(key), TrapKind::Stop});
+                else if (val == "ret") spec.traps.push_back({p.address(key), TrapKind::Return});
+                else p.fail("expected stop or ret, not '" + val + "'");
+                break;
+            case Section::Interrupt:
+                if (key == "rst") {
+                    interrupt->rst = uint8_t(p.number(val, 7));
+                } else if (key == "every") {
+                    interrupt->period = p.number(val);
+                } else if (key == "first") {
+                    interrupt->first = p.number(val);
+                    first_set        = true;
+                } else {
+                    p.fail("unknown key '" + key + "' in [interrupt." + interrupt->name + "]");
+                }
+                break;
+        }
+    }
+    close_interrupt();
+
+    for (const DeviceSpec& d : spec.devices)
+        if (d.type.empty()) throw std::runtime_error(name + ": device '" + d.name + "' has no type");
+    if (!spec.clock_hz) throw std::runtime_error(name + ": clock must not be zero");
+    if (realtime) {
+        spec.throttle = ThrottleConfig{};
+        spec.throttle->clock_hz = spec.clock_hz;
+    }
+    return spec;
+}
+
+BoardSpec LoadBoardFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("Cannot open board description '" + path + "'");
+    std::ostringstream text;
+    text << in.rdbuf();
+    const size_t slash = path.rfind('/');
+    return ParseBoardFile(text.str(), path, slash == std::string::npos ? "." : path.substr(0, slash));
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "board.h"
+
+#include <string>
+#include <string_view>
+
+// ─── Board description files ──────────────────────────────────────────────────
+// A BoardSpec (board.h) in an INI dialect, read once at start-up; nothing of
+// the text survives into the running board.  Sections and keys:
+//
+//   [board]            name, clock (Hz), load, start (addresses), realtime
+//                      (pace to the clock), plugin (repeatable: a library)
+//   [memory]           FIRST-LAST = ram | rom | none, in whole 256-byte
+//                      pages; without this section all memory is RAM
+//   [device.NAME]      type = a registered device type; every other key is
+//                      a parameter of the device
+//   [wires]            device.pin = device.pin   (output = input)
+//   [traps]            ADDR = stop | ret
+//   [interrupt.NAME]   rst (0-7), every (cycles; default once), first
+//                      (cycle; default every)
+//
+// Numbers are C style (0x1F or 31).  Values may be "quoted"; '#' and ';'
+// start comments outside quotes.  Relative paths (plugin, and a device's
+// file parameter) are taken from the description's directory.  Errors throw
+// std::runtime_error as "FILE:LINE: message".
+//
+//   [board]
+//   name  = iSBC 80/20
+//   clock = 2048000
+//
+//   [device.pic]
+//   type = i8259
+//
+//   [device.pit]
+//   type     = i8253
+//   clock_hz = 1228800
+//
+//   [wires]
+//   pit.out0 = pic.ir2
+
+BoardSpec LoadBoardFile(const std::string& path);
+
+// `name` is used in messages, `dir` to resolve relative paths.
+BoardSpec ParseBoardFile(std::string_view text, const std::string& name, const std::string& dir);
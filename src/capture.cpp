@@ -0,0 +1,144 @@
+#include "capture.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+FrameCapture::FrameCapture(const CaptureConfig& config) : config_(config) {
+    if (config_.interval == 0) config_.interval = 1;
+    if (config_.slots == 0) config_.slots = 1;
+
+    const size_t dot = config_.pattern.rfind('.');
+    if (dot != std::string::npos) {
+        std::string ext = config_.pattern.substr(dot);
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+        png_ = ext == ".png";
+    }
+    if (!config_.manifest.empty()) {
+        manifest_ = std::fopen(config_.manifest.c_str(), "w");
+        if (!manifest_) throw std::runtime_error("cannot create " + config_.manifest);
+    }
+
+    thread_ = std::thread([this] { encoder(); });
+}
+
+FrameCapture::~FrameCapture() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+    }
+    work_.notify_one();
+    thread_.join();
+    if (manifest_) std::fclose(manifest_);
+}
+
+std::string FrameCapture::file_name(uint64_t n) const {
+    const std::string& p = config_.pattern;
+    std::string digits   = std::to_string(n);
+    size_t begin = p.find('#'), end = begin;
+    if (begin == std::string::npos) {
+        const size_t dot   = p.rfind('.');
+        const size_t slash = p.find_last_of('/');
+        begin = end = dot != std::string::npos && (slash == std::string::npos || dot > slash) ? dot : p.size();
+        if (digits.size() < 6) digits.insert(0, 6 - digits.size(), '0');
+        digits.insert(0, 1, '_');
+    } else {
+        while (end < p.size() && p[end] == '#') ++end;
+        if (digits.size() < end - begin) digits.insert(0, end - begin - digits.size(), '0');
+    }
+    return p.substr(0, begin) + digits + p.substr(end);
+}
+
+// ─── Emulation thread ─────────────────────────────────────────────────────────
+void FrameCapture::submit(uint64_t n, const Framebuffer& fb) {
+    if (!due(n)) return;
+
+    const uint64_t hash      = HashFrame(fb);
+    const bool     duplicate = config_.dedup && have_last_ && hash == last_hash_;
+    if (duplicate && !manifest_) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.duplicates;
+        return;
+    }
+
+    std::unique_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            job = std::move(free_.back());
+            free_.pop_back();
+        } else if (jobs_ < config_.slots) {
+            ++jobs_;                                // grow the pool up to the limit
+        } else {
+            ++stats_.dropped;
+            return;
+        }
+    }
+
+    // Copy outside the lock: the encoder never touches a free slot.
+    if (!job) job = std::make_unique<Job>();
+    job->frame     = n;
+    job->hash      = hash;
+    job->duplicate = duplicate;
+    job->file      = duplicate ? last_file_ : file_name(n);
+    if (!duplicate) job->fb = fb;
+
+    have_last_ = true;
+    last_hash_ = hash;
+    last_file_ = job->file;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(job));
+    }
+    work_.notify_one();
+}
+
+void FrameCapture::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return queue_.empty() && !busy_; });
+}
+
+CaptureStats FrameCapture::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// ─── Encoder thread ───────────────────────────────────────────────────────────
+void FrameCapture::encoder() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_.wait(lock, [this] { return done_ || !queue_.empty(); });
+        if (queue_.empty()) return;                 // done_ and drained
+        std::unique_ptr<Job> job = std::move(queue_.front());
+        queue_.pop_front();
+        busy_ = true;
+        lock.unlock();
+
+        CaptureStats delta;
+        if (job->duplicate) {
+            delta.duplicates = 1;
+        } else {
+            const std::vector<uint8_t> image = png_ ? EncodePng(job->fb) : EncodePpm(job->fb);
+            bool ok = false;
+            if (std::FILE* f = std::fopen(job->file.c_str(), "wb")) {
+                ok = std::fwrite(image.data(), 1, image.size(), f) == image.size();
+                ok = std::fclose(f) == 0 && ok;
+            }
+            delta.written = ok;
+            delta.errors  = !ok;
+            delta.bytes   = ok ? image.size() : 0;
+        }
+        if (manifest_)
+            std::fprintf(manifest_, "%llu %016llx %s\n", static_cast<unsigned long long>(job->frame),
+                         static_cast<unsigned long long>(job->hash), job->file.c_str());
+
+        lock.lock();
+        stats_.written    += delta.written;
+        stats_.duplicates += delta.duplicates;
+        stats_.errors     += delta.errors;
+        stats_.bytes      += delta.bytes;
+        free_.push_back(std::move(job));
+        busy_ = false;
+        if (queue_.empty()) idle_.notify_all();
+    }
+}
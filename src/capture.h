@@ -0,0 +1,98 @@
+#pragma once
+#include "video.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ─── Frame capture ────────────────────────────────────────────────────────────
+// Writes frames of a headless video profile to numbered image files for
+// regression comparison.  The emulation thread only hashes the frame and
+// copies it into a pooled slot; a background thread encodes and writes it,
+// so the CPU never waits on the disk.  If the encoder falls behind by more
+// than `slots` frames, the frame is dropped and counted instead.
+//
+// File names come from a pattern in which a run of '#' is replaced by the
+// zero-padded frame number ("shots/frame_#####.png"); without one, "_######"
+// is inserted before the extension.  The extension picks the format: .png,
+// or .ppm otherwise.
+//
+// Consecutive identical frames — common in attract modes — are written once.
+// The optional manifest lists every captured frame as "FRAME HASH FILE", so
+// a repeated frame names the file of its first occurrence.
+
+struct CaptureConfig {
+    std::string pattern  = "frame_######.png";
+    std::string manifest;                     // empty = none
+    uint64_t    first    = 0;                 // first frame number to capture
+    uint64_t    interval = 1;                 // then every interval-th frame
+    bool        dedup    = true;              // skip frames equal to the previous one
+    unsigned    slots    = 64;                // most frames queued for the encoder
+};
+
+struct CaptureStats {
+    uint64_t written    = 0;                  // image files written
+    uint64_t duplicates = 0;                  // frames identical to their predecessor
+    uint64_t dropped    = 0;                  // frames lost because the encoder was behind
+    uint64_t errors     = 0;                  // files that could not be written
+    uint64_t bytes      = 0;                  // encoded bytes written
+};
+
+class FrameCapture {
+public:
+    // Throws std::runtime_error if the manifest cannot be created.
+    explicit FrameCapture(const CaptureConfig& config);
+    ~FrameCapture();                          // finishes the queued frames
+
+    FrameCapture(const FrameCapture&)            = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Whether frame `n` is one to capture (render it only if so).
+    bool due(uint64_t n) const {
+        return n >= config_.first && (n - config_.first) % config_.interval == 0;
+    }
+
+    // Offer frame `n`; ignored unless due(n).  Never blocks on I/O.
+    void submit(uint64_t n, const Framebuffer& fb);
+
+    // Wait until every queued frame is on disk.
+    void flush();
+
+    CaptureStats stats() const;
+    std::string  file_name(uint64_t n) const;
+
+private:
+    struct Job {
+        uint64_t    frame = 0;
+        uint64_t    hash  = 0;
+        bool        duplicate = false;        // no image: refers to `file`
+        std::string file;
+        Framebuffer fb;
+    };
+
+    void encoder();
+
+    CaptureConfig config_;
+    bool          png_ = false;
+    std::FILE*    manifest_ = nullptr;
+
+    uint64_t    last_hash_ = 0;               // emulation thread only
+    bool        have_last_ = false;
+    std::string last_file_;
+
+    mutable std::mutex                 mutex_;
+    std::condition_variable            work_, idle_;
+    std::deque<std::unique_ptr<Job>>   queue_;
+    std::vector<std::unique_ptr<Job>>  free_;
+    unsigned                           jobs_ = 0;      // slots allocated so far
+    bool                               busy_ = false;
+    bool                               done_ = false;
+    CaptureStats                       stats_;
+    std::thread                        thread_;
+};
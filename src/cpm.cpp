@@ -0,0 +1,63 @@
+#include "cpm.h"
+
+void CpmShim::setup(State8080& s) const {
+    // Warm-boot vector: CALL 0x0000 at the start of the CP/M stack area
+    // Place a HLT at 0x0000 so reaching it terminates cleanly
+    s.mem[0x0000] = 0x76;   // HLT  — fall-through safety
+
+    // 0x0005 must be reachable as a CALL target for BDOS; we'll intercept
+    // it via trap() before the CPU sees it.  Put a RET there anyway so
+    // a raw (unhooked) call still returns gracefully.
+    s.mem[0x0005] = 0xC9;   // RET
+
+    // Set CP/M default stack (just below the 64-KB top)
+    s.SP = 0xF000;
+}
+
+void CpmShim::attach(Runner& runner) {
+    runner.traps.arm(0x0000);
+    runner.traps.arm(0x0005);
+    runner.traps.handler = [this](State8080& s) { return trap(s); };
+}
+
+TrapAction CpmShim::trap(State8080& s) {
+    switch (s.PC) {
+        case 0x0000: return TrapAction::Stop;
+        case 0x0005: bdos(s); return TrapAction::Resume;
+        default:     return TrapAction::Execute;
+    }
+}
+
+void CpmShim::put(uint8_t ch) {
+    if (muted_) return;
+    if (out_)     std::fputc(ch, out_);
+    if (capture_) capture_->push_back(char(ch));
+}
+
+// ─── BDOS ─────────────────────────────────────────────────────────────────────
+// The register C selects the function; the trap fires on CALL 5 and we
+// return to the caller by popping the return address.
+void CpmShim::bdos(State8080& s) {
+    switch (s.C) {
+        case 2: {
+            // BDOS function 2: console character output (char in E)
+            put(s.E);
+            break;
+        }
+        case 9: {
+            // BDOS function 9: print string at DE, terminated by '$'
+            uint16_t addr = s.DE();
+            while (s.mem[addr] != '$') {
+                put(s.mem[addr++]);
+            }
+            put('\n');
+            break;
+        }
+        default:
+            // Other BDOS calls are silently ignored
+            break;
+    }
+
+    // Simulate RET: pop return address from stack
+    s.PC = s.pop16();
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "cpu8080.h"
+#include "runner.h"
+
+#include <cstdio>
+#include <string>
+
+// ─── CP/M shim ────────────────────────────────────────────────────────────────
+// Minimal CP/M environment for .COM programs:
+//   0x0000  warm boot — a HLT is placed there, and reaching it ends the run
+//   0x0005  BDOS entry — intercepted by a trap; functions 2 and 9 supported
+// Console output goes to a FILE* and/or is captured into a string (used by
+// the benchmark drivers to self-check workload output).
+class CpmShim {
+public:
+    static constexpr uint16_t TPA = 0x0100;    // standard .COM load address
+
+    explicit CpmShim(std::FILE* out = stdout) : out_(out) {}
+
+    // Write the page-zero vectors and set the default stack.
+    void setup(State8080& s) const;
+
+    // Arm the BDOS and warm-boot traps on `runner`.  The shim must outlive it.
+    void attach(Runner& runner);
+
+    // Additionally append console output to `buf` (nullptr to stop).
+    void capture_to(std::string* buf) { capture_ = buf; }
+
+    // Drop console output while on (e.g. while a Timeline replays history).
+    void mute(bool on) { muted_ = on; }
+
+    // Trap handler: BDOS at 0x0005 resumes, warm boot at 0x0000 stops.
+    TrapAction trap(State8080& s);
+
+private:
+    void bdos(State8080& s);
+    void put(uint8_t ch);
+
+    std::FILE*   out_;
+    std::string* capture_{nullptr};
+    bool         muted_{false};
+};
@@ -37,53 +37,53 @@ struct State8080 {
     bool halted{false};
 
     // ── Flag helpers ──────────────────────────────────────────────────────────
-    bool flag_cy() const { return (F & FLAG_CY) != 0; }
-    bool flag_p()  const { return (F & FLAG_P)  != 0; }
-    bool flag_ac() const { return (F & FLAG_AC) != 0; }
-    bool flag_z()  const { return (F & FLAG_Z)  != 0; }
-    bool flag_s()  const { return (F & FLAG_S)  != 0; }
-
-    void set_cy(bool v) { v ? (F |= FLAG_CY) : (F &= ~FLAG_CY); }
-    void set_p (bool v) { v ? (F |= FLAG_P)  : (F &= ~FLAG_P);  }
-    void set_ac(bool v) { v ? (F |= FLAG_AC) : (F &= ~FLAG_AC); }
-    void set_z (bool v) { v ? (F |= FLAG_Z)  : (F &= ~FLAG_Z);  }
-    void set_s (bool v) { v ? (F |= FLAG_S)  : (F &= ~FLAG_S);  }
+    constexpr bool flag_cy() const { return (F & FLAG_CY) != 0; }
+    constexpr bool flag_p()  const { return (F & FLAG_P)  != 0; }
+    constexpr bool flag_ac() const { return (F & FLAG_AC) != 0; }
+    constexpr bool flag_z()  const { return (F & FLAG_Z)  != 0; }
+    constexpr bool flag_s()  const { return (F & FLAG_S)  != 0; }
+
+    constexpr void set_cy(bool v) { v ? (F |= FLAG_CY) : (F &= ~FLAG_CY); }
+    constexpr void set_p (bool v) { v ? (F |= FLAG_P)  : (F &= ~FLAG_P);  }
+    constexpr void set_ac(bool v) { v ? (F |= FLAG_AC) : (F &= ~FLAG_AC); }
+    constexpr void set_z (bool v) { v ? (F |= FLAG_Z)  : (F &= ~FLAG_Z);  }
+    constexpr void set_s (bool v) { v ? (F |= FLAG_S)  : (F &= ~FLAG_S);  }
 
     // ── Register-pair helpers ─────────────────────────────────────────────────
-    uint16_t BC() const { return (uint16_t(B) << 8) | C; }
-    uint16_t DE() const { return (uint16_t(D) << 8) | E; }
-    uint16_t HL() const { return (uint16_t(H) << 8) | L; }
+    constexpr uint16_t BC() const { return (uint16_t(B) << 8) | C; }
+    constexpr uint16_t DE() const { return (uint16_t(D) << 8) | E; }
+    constexpr uint16_t HL() const { return (uint16_t(H) << 8) | L; }
 
-    void setBC(uint16_t v) { B = v >> 8; C = v & 0xFF; }
-    void setDE(uint16_t v) { D = v >> 8; E = v & 0xFF; }
-    void setHL(uint16_t v) { H = v >> 8; L = v & 0xFF; }
+    constexpr void setBC(uint16_t v) { B = v >> 8; C = v & 0xFF; }
+    constexpr void setDE(uint16_t v) { D = v >> 8; E = v & 0xFF; }
+    constexpr void setHL(uint16_t v) { H = v >> 8; L = v & 0xFF; }
 
     // PSW = FLAGS:A packed as a 16-bit word (used by PUSH PSW / POP PSW)
-    uint16_t PSW() const { return (uint16_t(A) << 8) | F; }
-    void setPSW(uint16_t v) { A = v >> 8; F = (v & 0xFF) | FLAG_FIXED; }
+    constexpr uint16_t PSW() const { return (uint16_t(A) << 8) | F; }
+    constexpr void setPSW(uint16_t v) { A = v >> 8; F = (v & 0xFF) | FLAG_FIXED; }
 
     // ── Memory helpers ────────────────────────────────────────────────────────
-    uint8_t  read8 (uint16_t addr)  const { return mem[addr]; }
-    uint16_t read16(uint16_t addr)  const {
-        return uint16_t(mem[addr]) | (uint16_t(mem[addr + 1]) << 8);
+    constexpr uint8_t  read8 (uint16_t addr)  const { return mem[addr]; }
+    constexpr uint16_t read16(uint16_t addr)  const {
+        return uint16_t(mem[addr]) | (uint16_t(mem[uint16_t(addr + 1)]) << 8);
     }
-    void write8 (uint16_t addr, uint8_t  v) { mem[addr] = v; }
-    void write16(uint16_t addr, uint16_t v) {
-        mem[addr]     = v & 0xFF;
-        mem[addr + 1] = v >> 8;
+    constexpr void write8 (uint16_t addr, uint8_t  v) { mem[addr] = v; }
+    constexpr void write16(uint16_t addr, uint16_t v) {
+        mem[addr]               = v & 0xFF;
+        mem[uint16_t(addr + 1)] = v >> 8;
     }
 
     // Inline fetch helpers (advance PC)
-    uint8_t  next8()  { return mem[PC++]; }
-    uint16_t next16() {
+    constexpr uint8_t  next8()  { return mem[PC++]; }
+    constexpr uint16_t next16() {
         uint8_t lo = mem[PC++];
         uint8_t hi = mem[PC++];
         return uint16_t(lo) | (uint16_t(hi) << 8);
     }
 
     // Stack helpers
-    void push16(uint16_t v) { SP -= 2; write16(SP, v); }
-    uint16_t pop16()        { uint16_t v = read16(SP); SP += 2; return v; }
+    constexpr void push16(uint16_t v) { SP -= 2; write16(SP, v); }
+    constexpr uint16_t pop16()        { uint16_t v = read16(SP); SP += 2; return v; }
 };
 
 // ─── I/O callbacks ────────────────────────────────────────────────────────────
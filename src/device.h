@@ -0,0 +1,121 @@
+#pragma once
+#include "cpu8080.h"
+#include "runner.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+// ─── Device plugins ───────────────────────────────────────────────────────────
+// A peripheral as the core sees it when it is plugged into a Board (board.h)
+// rather than wired by hand into an IOBus.  Everything is optional:
+//
+//   ports(), memory()   the I/O ports and address ranges it decodes; asked
+//                       once, when the device is attached, and compiled into
+//                       the board's port table and memory map
+//   in(), out()         accesses to its ports, with Runner::cycles() exact
+//   reset()             back to the power-on state (a ROM refills its range)
+//   save(), restore()   its state, for board snapshots
+//   flush()             buffered host output, at the end of a run
+//   next_event_cycle()  the cycle at which it next has something to do on
+//                       its own (a timer expiring, a character time), or
+//                       UINT64_MAX for nothing; event() is called once the
+//                       runner's cycle count reaches it
+//   connect(), input()  named signal pins, wired device to device by the
+//                       board (e.g. a timer's "out0" to a PIC's "ir2")
+//
+// The board re-reads next_event_cycle() after every call into the device
+// (port access, event, reset, restore, an input pin changing) and keeps one
+// scheduler event at that cycle, so the CPU runs uninterrupted until the
+// earliest deadline of any device.  A deadline must therefore only move as
+// a result of such a call; devices that want several independent events may
+// use Runner::events directly instead.
+//
+// Memory stays the flat 64 KB of State8080, read and written directly by
+// the interpreter: a memory range is a claim on part of it that the board
+// checks for overlaps and the device may fill or watch, not a bus cycle
+// hook.  ROM is therefore not write-protected.
+
+struct PortRange {
+    uint8_t first;
+    uint8_t last;
+};
+
+struct MemoryRange {
+    uint16_t first;
+    uint16_t last;
+};
+
+// Little-endian writer and reader for device state.  The reader throws
+// std::runtime_error if the state runs out.
+class StateWriter {
+public:
+    explicit StateWriter(std::vector<uint8_t>& out) : out_(out) {}
+    void u8(uint8_t v)   { out_.push_back(v); }
+    void u16(uint16_t v) { put(v, 2); }
+    void u32(uint32_t v) { put(v, 4); }
+    void u64(uint64_t v) { put(v, 8); }
+    void flag(bool v)    { out_.push_back(v ? 1 : 0); }
+
+private:
+    void put(uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; ++i) out_.push_back(uint8_t(v >> (8 * i)));
+    }
+    std::vector<uint8_t>& out_;
+};
+
+class StateReader {
+public:
+    StateReader(const uint8_t* data, size_t size) : p_(data), end_(data + size) {}
+    uint8_t  u8()   { return uint8_t(get(1)); }
+    uint16_t u16()  { return uint16_t(get(2)); }
+    uint32_t u32()  { return uint32_t(get(4)); }
+    uint64_t u64()  { return get(8); }
+    bool     flag() { return get(1) != 0; }
+    bool     done() const { return p_ == end_; }
+
+private:
+    uint64_t get(int bytes) {
+        if (end_ - p_ < bytes) throw std::runtime_error("Truncated device state");
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) v |= uint64_t(*p_++) << (8 * i);
+        return v;
+    }
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
+
+class Device {
+public:
+    virtual ~Device() = default;
+
+    virtual std::vector<PortRange>   ports()  const { return {}; }
+    virtual std::vector<MemoryRange> memory() const { return {}; }
+
+    virtual uint8_t in(uint8_t port)               { (void)port; return 0xFF; }
+    virtual void    out(uint8_t port, uint8_t val) { (void)port; (void)val; }
+
+    virtual void reset() {}
+    virtual void save(StateWriter& w) const { (void)w; }
+    virtual void restore(StateReader& r)    { (void)r; }
+
+    virtual uint64_t next_event_cycle() const { return UINT64_MAX; }
+    virtual void     event(uint64_t now)      { (void)now; }
+
+    // Push buffered output to the host; called when a board's run ends.
+    virtual void flush() {}
+
+    // Drive `sink` from the output pin `name`; false if there is no such pin.
+    virtual bool connect(std::string_view name, std::function<void(bool level)> sink) {
+        (void)name; (void)sink;
+        return false;
+    }
+    // The input pin `name`, or an empty function if there is none.
+    virtual std::function<void(bool level)> input(std::string_view name) {
+        (void)name;
+        return {};
+    }
+};
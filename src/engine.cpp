@@ -0,0 +1,49 @@
+#include "engine.h"
+#include "runner.h"
+#include "writes.h"
+
+// ─── reference ────────────────────────────────────────────────────────────────
+// Plain Step8080 loop: the definition of correct behaviour.
+static uint64_t run_reference(State8080& s, IOBus& io, uint64_t max_insns) {
+    uint64_t cycles = 0;
+    for (; max_insns && !s.halted; --max_insns)
+        cycles += Step8080(s, io);
+    return cycles;
+}
+
+// ─── runner ───────────────────────────────────────────────────────────────────
+// The production run loop.  A deliberately tiny slice makes every few
+// instructions a budget boundary, so slice bookkeeping is exercised too.
+static uint64_t run_runner(State8080& s, IOBus& io, uint64_t max_insns) {
+    if (max_insns == 0) return 0;       // 0 means "unlimited" to RunLimits
+    Runner runner(s, io);
+    runner.set_slice_cycles(17);
+    RunLimits limits;
+    limits.max_instructions = max_insns;
+    runner.run(limits);
+    return runner.cycles();
+}
+
+// ─── tracked ──────────────────────────────────────────────────────────────────
+// The run loop with last-writer tracking on, which switches it to the hooked
+// loop; tracking must not change what the CPU does.  The index is reused
+// across calls since only the execution is compared.
+static uint64_t run_tracked(State8080& s, IOBus& io, uint64_t max_insns) {
+    if (max_insns == 0) return 0;
+    thread_local WriteIndex index(4);
+    Runner       runner(s, io);
+    WriteTracker tracker(runner, index);
+    RunLimits limits;
+    limits.max_instructions = max_insns;
+    runner.run(limits);
+    return runner.cycles();
+}
+
+const std::vector<Engine>& Engines() {
+    static const std::vector<Engine> engines = {
+        {"reference", run_reference},
+        {"runner",    run_runner},
+        {"tracked",   run_tracked},
+    };
+    return engines;
+}
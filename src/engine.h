@@ -0,0 +1,26 @@
+#pragma once
+#include "cpu8080.h"
+
+#include <cstdint>
+#include <vector>
+
+// ─── Execution engines ────────────────────────────────────────────────────────
+// Every way of executing 8080 code registers itself here so that the
+// differential fuzzer and the ALU verifier can check it against the reference
+// interpreter, Step8080.  An engine must leave exactly the same architectural
+// state, memory contents, I/O traffic and cycle count as the reference after
+// any number of instructions.
+//
+// Translated code (aot.h) cannot be built per test case, so it is checked
+// against the interpreter by native8080_fuzz_aot instead (fuzz/fuzz_aot.cpp).
+
+struct Engine {
+    const char* name;
+
+    // Execute up to `max_insns` instructions, stopping early if the CPU halts.
+    // Returns the number of clock cycles consumed.
+    uint64_t (*run)(State8080& state, IOBus& io, uint64_t max_insns);
+};
+
+// All engines; Engines()[0] is the reference.
+const std::vector<Engine>& Engines();
@@ -0,0 +1,650 @@
+#include "gdbstub.h"
+#include "step8080.h"
+#include "timeline.h"
+#include "writes.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+// Cycles run between checks for a Ctrl-C from the debugger: ~50 ms of 2 MHz
+// time, well under a millisecond flat out.
+constexpr uint64_t POLL_CYCLES = 100'000;
+
+constexpr unsigned NUM_REGS = 13;     // GDB z80 layout, see gdbstub.h
+
+const char TARGET_XML[] =
+    "<?xml version=\"1.0\"?>"
+    "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+    "<target version=\"1.0\">"
+    "<architecture>z80</architecture>"
+    "<feature name=\"org.gnu.gdb.z80.cpu\">"
+    "<reg name=\"af\" bitsize=\"16\" type=\"int\"/>"
+    "<reg name=\"bc\" bitsize=\"16\" type=\"int\"/>"
+    "<reg name=\"de\" bitsize=\"16\" type=\"int\"/>"
+    "<reg name=\"hl\" bitsize=\"16\" type=\"data_ptr\"/>"
+    "<reg name=\"sp\" bitsize=\"16\" type=\"data_ptr\"/>"
+    "<reg name=\"pc\" bitsize=\"16\" type=\"code_ptr\"/>"
+    "<reg name=\"ix\" bitsize=\"16\" type=\"int\"/>"
+    "<reg name=\"iy\" bitsize=\"16\" type=\"int\"/>"
+    "<reg name=\"af'\" bitsize=\"16\" type=\"int\"/>"
+    "<reg name=\"bc'\" bitsize=\"16\" type=\"int\"/>"
+    "<reg name=\"de'\" bitsize=\"16\" type=\"int\"/>"
+    "<reg name=\"hl'\" bitsize=\"16\" type=\"int\"/>"
+    "<reg name=\"ir\" bitsize=\"16\" type=\"int\"/>"
+    "</feature>"
+    "</target>";
+
+const char HEX[] = "0123456789abcdef";
+
+int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void append_byte(std::string& out, uint8_t v) {
+    out += HEX[v >> 4];
+    out += HEX[v & 0x0F];
+}
+
+// 16-bit register value as GDB expects it: target (little-endian) byte order.
+void append_word(std::string& out, uint16_t v) {
+    append_byte(out, uint8_t(v));
+    append_byte(out, uint8_t(v >> 8));
+}
+
+bool parse_word(const std::string& hex, size_t pos, uint16_t& v) {
+    if (pos + 4 > hex.size()) return false;
+    int d[4];
+    for (int i = 0; i < 4; ++i)
+        if ((d[i] = hex_digit(hex[pos + i])) < 0) return false;
+    v = uint16_t(((d[0] << 4) | d[1]) | (((d[2] << 4) | d[3]) << 8));
+    return true;
+}
+
+// "addr,len" in hex; stops at the first character that is not part of it.
+bool parse_addr_len(const std::string& s, uint32_t& addr, uint32_t& len, size_t* end = nullptr) {
+    char* p = nullptr;
+    addr = uint32_t(std::strtoul(s.c_str(), &p, 16));
+    if (*p != ',') return false;
+    len = uint32_t(std::strtoul(p + 1, &p, 16));
+    if (end) *end = size_t(p - s.c_str());
+    return true;
+}
+
+uint16_t reg_value(const State8080& s, unsigned n) {
+    switch (n) {
+        case 0:  return s.PSW();
+        case 1:  return s.BC();
+        case 2:  return s.DE();
+        case 3:  return s.HL();
+        case 4:  return s.SP;
+        case 5:  return s.PC;
+        default: return 0;          // Z80-only registers
+    }
+}
+
+void set_reg_value(State8080& s, unsigned n, uint16_t v) {
+    switch (n) {
+        case 0: s.setPSW(v); break;
+        case 1: s.setBC(v);  break;
+        case 2: s.setDE(v);  break;
+        case 3: s.setHL(v);  break;
+        case 4: s.SP = v;    break;
+        case 5: s.PC = v; s.halted = false; break;
+        default: break;
+    }
+}
+
+} // namespace
+
+GdbStub::GdbStub(State8080& state, Runner& runner) : s_(state), runner_(runner) {
+    base_armed_   = runner_.traps.bitmap();
+    base_handler_ = runner_.traps.handler;
+    runner_.traps.handler = [this](State8080& s) { return trap(s); };
+}
+
+GdbStub::~GdbStub() {
+    runner_.traps.set_bitmap(base_armed_);
+    runner_.traps.handler = base_handler_;
+    if (fd_ >= 0) ::close(fd_);
+    if (listen_fd_ >= 0) ::close(listen_fd_);
+    if (!socket_path_.empty()) ::unlink(socket_path_.c_str());
+}
+
+// ─── Transport ────────────────────────────────────────────────────────────────
+bool GdbStub::listen_unix(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof addr.sun_path) {
+        std::fprintf(stderr, "gdb: socket path too long: %s\n", path.c_str());
+        return false;
+    }
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) { std::perror("gdb: socket"); return false; }
+
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    ::unlink(path.c_str());
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof addr) < 0 ||
+        ::listen(listen_fd_, 1) < 0) {
+        std::perror("gdb: bind");
+        return false;
+    }
+    socket_path_ = path;
+    return true;
+}
+
+bool GdbStub::open_pty(std::string* name) {
+    int master = ::posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || ::grantpt(master) < 0 || ::unlockpt(master) < 0) {
+        std::perror("gdb: posix_openpt");
+        if (master >= 0) ::close(master);
+        return false;
+    }
+    const char* slave = ::ptsname(master);
+    // Keep the slave open ourselves in raw mode: reads on the master then
+    // block until the debugger writes instead of failing with EIO.
+    int keep = slave ? ::open(slave, O_RDWR | O_NOCTTY) : -1;
+    if (keep < 0) {
+        std::perror("gdb: open pty slave");
+        ::close(master);
+        return false;
+    }
+    termios tio{};
+    ::tcgetattr(keep, &tio);
+    ::cfmakeraw(&tio);
+    ::tcsetattr(keep, TCSANOW, &tio);
+    listen_fd_ = keep;                  // closed with the stub
+    fd_        = master;
+    is_pty_    = true;
+    *name      = slave;
+    return true;
+}
+
+bool GdbStub::wait_for_client() {
+    if (is_pty_) return fd_ >= 0;
+    fd_ = ::accept(listen_fd_, nullptr, nullptr);
+    if (fd_ < 0) { std::perror("gdb: accept"); return false; }
+    return true;
+}
+
+// Next byte from the debugger, or -1 on EOF/error (or nothing available when
+// `block` is false).
+int GdbStub::read_byte(bool block) {
+    if (rx_.empty()) {
+        if (!block) {
+            pollfd p{fd_, POLLIN, 0};
+            if (::poll(&p, 1, 0) <= 0) return -1;
+        }
+        char buf[256];
+        ssize_t n;
+        do { n = ::read(fd_, buf, sizeof buf); } while (n < 0 && errno == EINTR);
+        if (n <= 0) return -1;
+        rx_.append(buf, size_t(n));
+    }
+    uint8_t c = uint8_t(rx_[0]);
+    rx_.erase(0, 1);
+    return c;
+}
+
+bool GdbStub::write_all(const std::string& data) {
+    size_t off = 0;
+    while (off < data.size()) {
+        // A debugger that hangs up must not kill the emulator with SIGPIPE.
+        ssize_t n = is_pty_ ? ::write(fd_, data.data() + off, data.size() - off)
+                            : ::send(fd_, data.data() + off, data.size() - off, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        off += size_t(n);
+    }
+    return true;
+}
+
+bool GdbStub::get_packet(std::string& out) {
+    for (;;) {
+        int c;
+        do {
+            if ((c = read_byte(true)) < 0) return false;
+        } while (c != '$');                 // skips acks and stray Ctrl-C
+
+        out.clear();
+        uint8_t sum = 0;
+        while ((c = read_byte(true)) >= 0 && c != '#') {
+            out += char(c);
+            sum = uint8_t(sum + c);
+        }
+        int h = read_byte(true), l = read_byte(true);
+        if (c < 0 || h < 0 || l < 0) return false;
+        if (no_ack_) return true;
+        if (hex_digit(char(h)) * 16 + hex_digit(char(l)) == sum) return write_all("+");
+        if (!write_all("-")) return false;
+    }
+}
+
+bool GdbStub::put_packet(const std::string& data) {
+    uint8_t sum = 0;
+    for (char c : data) sum = uint8_t(sum + uint8_t(c));
+    std::string frame = "$" + data + "#";
+    append_byte(frame, sum);
+    for (;;) {
+        if (!write_all(frame)) return false;
+        if (no_ack_) return true;
+        int c;
+        do {
+            if ((c = read_byte(true)) < 0) return false;
+        } while (c != '+' && c != '-');
+        if (c == '+') return true;
+    }
+}
+
+// ─── Execution ────────────────────────────────────────────────────────────────
+bool GdbStub::breakpoint_here(const State8080& s) const {
+    if (!sw_breaks_[s.PC] && !hw_breaks_[s.PC]) return false;
+    auto cond = conditions_.find(s.PC);
+    return cond == conditions_.end() || cond->second(s);
+}
+
+// First watched address the instruction at PC is about to write.
+std::optional<uint16_t> GdbStub::watched_write(const State8080& s) const {
+    const WriteSpan w = PendingWrite(s);
+    for (uint8_t i = 0; i < w.len; ++i)
+        if (watch_[uint16_t(w.addr + i)]) return uint16_t(w.addr + i);
+    return std::nullopt;
+}
+
+TrapAction GdbStub::trap(State8080& s) {
+    // Breakpoints stay quiet while the timeline moves between instants.
+    const bool seeking = timeline_ && timeline_->seeking();
+    if (!seeking && (sw_breaks_[s.PC] || hw_breaks_[s.PC])) {
+        if (step_over_ && s.PC == step_over_pc_) {
+            step_over_ = false;             // resuming from this breakpoint
+        } else if (breakpoint_here(s)) {
+            break_hit_ = true;
+            return TrapAction::Stop;
+        }
+    }
+    if (base_handler_) return base_handler_(s);
+    return TrapAction::Execute;
+}
+
+// Instruction hook while watchpoints are set: stop at the boundary after an
+// instruction that wrote a watched byte, as hardware watchpoints do.
+bool GdbStub::watch_hook(const State8080& s) {
+    if (watch_pending_) {
+        watch_hit_ = watch_pending_;
+        watch_pending_.reset();
+        return false;
+    }
+    watch_pending_ = watched_write(s);
+    return true;
+}
+
+bool GdbStub::interrupt_pending() {
+    for (int c; (c = read_byte(false)) >= 0;)
+        if (c == 0x03) return true;
+    return false;
+}
+
+std::string GdbStub::stop_reply_here() const {
+    if (watch_hit_) {
+        char reply[32];
+        std::snprintf(reply, sizeof reply, "T05watch:%x;", *watch_hit_);
+        return reply;
+    }
+    return hw_breaks_[s_.PC] ? "T05hwbreak:;" : "T05swbreak:;";
+}
+
+// Run (or step) and return the stop reply.
+std::string GdbStub::resume(bool step) {
+    step_over_    = true;
+    step_over_pc_ = s_.PC;
+    break_hit_    = false;
+    watch_hit_.reset();
+    watch_pending_.reset();
+
+    InstructionHook saved = runner_.hook;
+    if (watch_.any()) {
+        runner_.hook = [this, saved](const State8080& s) {
+            return (!saved || saved(s)) && watch_hook(s);
+        };
+    }
+    auto run = [this](const RunLimits& limits) {
+        return timeline_ ? timeline_->run(limits) : runner_.run(limits);
+    };
+
+    StopReason reason;
+    bool interrupted = false;
+    if (step) {
+        RunLimits limits;
+        limits.max_instructions = 1;
+        reason = run(limits);
+    } else {
+        RunLimits limits;
+        limits.max_cycles = POLL_CYCLES;
+        while ((reason = run(limits)) == StopReason::CycleLimit) {
+            if (interrupt_pending()) { interrupted = true; break; }
+        }
+    }
+    runner_.hook = std::move(saved);
+    if (watch_pending_) {                   // written by the last instruction run
+        watch_hit_ = watch_pending_;
+        watch_pending_.reset();
+    }
+    step_over_   = false;
+    last_reason_ = reason;
+
+    if (interrupted || reason == StopReason::StopRequested) return "S02";   // SIGINT
+    if (watch_hit_) return stop_reply_here();
+    if (reason == StopReason::Trap) {
+        if (break_hit_) return stop_reply_here();
+        exited_ = true;
+        return "W00";
+    }
+    return "S05";                           // step done, HLT or other limit
+}
+
+// Step or continue backwards through the timeline's history.
+std::string GdbStub::reverse(bool step) {
+    break_hit_ = false;
+    watch_hit_.reset();
+    if (step) return timeline_->step_back() ? "S05" : "T05replaylog:begin;";
+
+    auto found = timeline_->find_last([this](const State8080& s) {
+        return breakpoint_here(s) || (watch_.any() && watched_write(s));
+    });
+    if (!found) {
+        timeline_->seek(timeline_->begin());
+        return "T05replaylog:begin;";
+    }
+    watch_hit_ = watched_write(s_);
+    return stop_reply_here();
+}
+
+// Registers or memory were changed by the debugger: recorded history after
+// this instant no longer applies.
+void GdbStub::state_changed() {
+    if (timeline_) timeline_->diverge();
+}
+
+// ─── Registers and memory ─────────────────────────────────────────────────────
+std::string GdbStub::read_registers() const {
+    std::string out;
+    for (unsigned n = 0; n < NUM_REGS; ++n) append_word(out, reg_value(s_, n));
+    return out;
+}
+
+bool GdbStub::write_registers(const std::string& hex) {
+    for (unsigned n = 0; n < NUM_REGS; ++n) {
+        uint16_t v;
+        if (!parse_word(hex, n * 4, v)) return n > 0;
+        set_reg_value(s_, n, v);
+    }
+    return true;
+}
+
+std::string GdbStub::read_register(unsigned n) const {
+    if (n >= NUM_REGS) return "E01";
+    std::string out;
+    append_word(out, reg_value(s_, n));
+    return out;
+}
+
+bool GdbStub::write_register(unsigned n, const std::string& hex) {
+    uint16_t v;
+    if (n >= NUM_REGS || !parse_word(hex, 0, v)) return false;
+    set_reg_value(s_, n, v);
+    return true;
+}
+
+std::string GdbStub::read_memory(const std::string& args) const {
+    uint32_t addr, len;
+    if (!parse_addr_len(args, addr, len)) return "E01";
+    std::string out;
+    for (uint32_t i = 0; i < len && i < 0x10000; ++i) append_byte(out, s_.mem[uint16_t(addr + i)]);
+    return out;
+}
+
+bool GdbStub::write_memory_hex(const std::string& args) {
+    uint32_t addr, len;
+    size_t   end;
+    if (!parse_addr_len(args, addr, len, &end) || end >= args.size() || args[end] != ':') return false;
+    const std::string data = args.substr(end + 1);
+    if (data.size() < size_t(len) * 2) return false;
+    for (uint32_t i = 0; i < len; ++i) {
+        int h = hex_digit(data[2 * i]), l = hex_digit(data[2 * i + 1]);
+        if (h < 0 || l < 0) return false;
+        s_.mem[uint16_t(addr + i)] = uint8_t(h * 16 + l);
+    }
+    return true;
+}
+
+bool GdbStub::write_memory_binary(const std::string& args) {
+    uint32_t addr, len;
+    size_t   end;
+    if (!parse_addr_len(args, addr, len, &end) || end >= args.size() || args[end] != ':') return false;
+    uint32_t i = 0;
+    for (size_t p = end + 1; p < args.size() && i < len; ++p, ++i) {
+        uint8_t c = uint8_t(args[p]);
+        if (c == '}' && p + 1 < args.size()) c = uint8_t(args[++p]) ^ 0x20;
+        s_.mem[uint16_t(addr + i)] = c;
+    }
+    return i == len;
+}
+
+// "type,addr,kind" for Z/z packets.  Both software and hardware breakpoints
+// live in the trap bitmap; guest memory is never patched.  Write watchpoints
+// (type 2) cover `kind` bytes.
+std::string GdbStub::breakpoint(const std::string& args, bool insert) {
+    if (args.size() < 2 || args[0] < '0' || args[0] > '2' || args[1] != ',') return "";
+    char* end = nullptr;
+    uint16_t addr = uint16_t(std::strtoul(args.c_str() + 2, &end, 16));
+    if (args[0] == '2') {
+        unsigned len = *end == ',' ? unsigned(std::strtoul(end + 1, nullptr, 16)) : 1;
+        for (unsigned i = 0; i < len && i < 0x10000; ++i) watch_[uint16_t(addr + i)] = insert;
+        return "OK";
+    }
+    auto& set = args[0] == '0' ? sw_breaks_ : hw_breaks_;
+    set[addr] = insert;
+    runner_.traps.arm(addr, base_armed_[addr] || sw_breaks_[addr] || hw_breaks_[addr]);
+    return "OK";
+}
+
+std::string GdbStub::query_features(const std::string& args) const {
+    // args: "target.xml:offset,length"
+    const std::string prefix = "target.xml:";
+    if (args.compare(0, prefix.size(), prefix) != 0) return "E00";
+    uint32_t off, len;
+    if (!parse_addr_len(args.substr(prefix.size()), off, len)) return "E01";
+    const std::string xml = TARGET_XML;
+    if (off >= xml.size()) return "l";
+    std::string chunk = xml.substr(off, len);
+    return (off + chunk.size() >= xml.size() ? "l" : "m") + chunk;
+}
+
+// "qRcmd,<hex>" — GDB's `monitor` command.  Output goes back as O packets.
+std::string GdbStub::monitor(const std::string& hex_command) {
+    std::string cmd;
+    for (size_t i = 0; i + 1 < hex_command.size(); i += 2) {
+        int h = hex_digit(hex_command[i]), l = hex_digit(hex_command[i + 1]);
+        if (h < 0 || l < 0) return "E01";
+        cmd += char(h * 16 + l);
+    }
+
+    std::string text;
+    if (cmd == "cond") {
+        for (const auto& [pc, pred] : conditions_) {
+            char addr[16];
+            std::snprintf(addr, sizeof addr, "  0x%04X: ", pc);
+            text += addr + pred.text() + "\n";
+        }
+        if (text.empty()) text = "no breakpoint conditions\n";
+    } else if (cmd.rfind("cond ", 0) == 0) {
+        const char* begin = cmd.c_str() + 5;
+        char* end = nullptr;
+        unsigned long pc = std::strtoul(begin, &end, 0);
+        if (end == begin || pc > 0xFFFF) {
+            text = "usage: monitor cond ADDR [EXPR]\n";
+        } else {
+            while (*end == ' ') ++end;
+            try {
+                if (*end) conditions_[uint16_t(pc)] = Predicate::Compile(end);
+                else      conditions_.erase(uint16_t(pc));
+            } catch (const std::invalid_argument& e) {
+                text = std::string(e.what()) + "\n";
+            }
+        }
+    } else if (cmd == "history") {
+        if (!timeline_) {
+            text = "reverse execution is off (start with --history MB)\n";
+        } else {
+            char line[160];
+            std::snprintf(line, sizeof line,
+                          "instructions %llu..%llu, now %llu; %zu checkpoints in %.1f MiB\n",
+                          static_cast<unsigned long long>(timeline_->begin()),
+                          static_cast<unsigned long long>(timeline_->end()),
+                          static_cast<unsigned long long>(timeline_->now()),
+                          timeline_->checkpoints(), timeline_->memory_bytes() / 1048576.0);
+            text = line;
+        }
+    } else if (cmd.rfind("writer ", 0) == 0) {
+        char* end = nullptr;
+        unsigned long addr = std::strtoul(cmd.c_str() + 7, &end, 0);
+        unsigned long len  = *end ? std::strtoul(end, nullptr, 0) : 1;
+        if (!writes_) {
+            text = "write tracking is off (start with --track-writes N)\n";
+        } else if (addr > 0xFFFF || len == 0) {
+            text = "usage: monitor writer ADDR [LEN]\n";
+        } else {
+            for (unsigned long i = 0; i < std::min(len, 256ul); ++i) {
+                const uint16_t a = uint16_t(addr + i);
+                char line[64];
+                std::snprintf(line, sizeof line, "0x%04X:", a);
+                text += line;
+                const std::vector<WriteRecord> w = writes_->writers(a);
+                if (w.empty()) text += " not written";
+                for (const WriteRecord& r : w) {
+                    std::snprintf(line, sizeof line, " pc=0x%04X cycle=%llu", r.pc,
+                                  static_cast<unsigned long long>(r.cycle));
+                    text += line;
+                }
+                text += "\n";
+            }
+        }
+    } else {
+        text = "monitor commands: cond [ADDR [EXPR]], history, writer ADDR [LEN]\n";
+    }
+
+    if (!text.empty()) {
+        std::string out = "O";
+        for (char c : text) append_byte(out, uint8_t(c));
+        if (!put_packet(out)) return "E01";
+    }
+    return "OK";
+}
+
+// ─── Packet dispatch ──────────────────────────────────────────────────────────
+std::string GdbStub::handle(const std::string& pkt, bool& done) {
+    if (pkt.empty()) return "";
+    const std::string args = pkt.substr(1);
+
+    switch (pkt[0]) {
+        case '?': return exited_ ? "W00" : "S05";
+        case 'g': return read_registers();
+        case 'G':
+            if (!write_registers(args)) return "E01";
+            state_changed();
+            return "OK";
+        case 'p': return read_register(unsigned(std::strtoul(args.c_str(), nullptr, 16)));
+        case 'P': {
+            size_t eq = args.find('=');
+            if (eq == std::string::npos ||
+                !write_register(unsigned(std::strtoul(args.c_str(), nullptr, 16)), args.substr(eq + 1)))
+                return "E01";
+            state_changed();
+            return "OK";
+        }
+        case 'm': return read_memory(args);
+        case 'M':
+        case 'X':
+            if (!(pkt[0] == 'M' ? write_memory_hex(args) : write_memory_binary(args))) return "E01";
+            state_changed();
+            return "OK";
+        case 'c':
+        case 's':
+            if (!args.empty()) {
+                s_.PC = uint16_t(std::strtoul(args.c_str(), nullptr, 16));
+                s_.halted = false;
+                state_changed();
+            }
+            if (exited_) return "W00";
+            return resume(pkt[0] == 's');
+        case 'b':
+            if (!timeline_ || (pkt != "bs" && pkt != "bc")) return "";
+            if (exited_) return "W00";
+            return reverse(pkt == "bs");
+        case 'Z': return breakpoint(args, true);
+        case 'z': return breakpoint(args, false);
+        case 'H': return "OK";
+        case 'T': return "OK";
+        case 'D': done = true; return "OK";
+        case 'v':
+            if (pkt == "vCont?")          return "vCont;c;C;s;S";
+            if (pkt.rfind("vCont;", 0) == 0) {
+                if (exited_) return "W00";
+                char action = pkt.size() > 6 ? pkt[6] : 'c';
+                return resume(action == 's' || action == 'S');
+            }
+            if (pkt.rfind("vKill", 0) == 0) { done = true; return "OK"; }
+            return "";
+        case 'q':
+            if (pkt.rfind("qSupported", 0) == 0)
+                return std::string("PacketSize=4000;qXfer:features:read+;swbreak+;hwbreak+;QStartNoAckMode+;vContSupported+") +
+                       (timeline_ ? ";ReverseStep+;ReverseContinue+" : "");
+            if (pkt.rfind("qXfer:features:read:", 0) == 0) return query_features(pkt.substr(20));
+            if (pkt == "qAttached")        return "1";
+            if (pkt == "qC")               return "QC1";
+            if (pkt == "qfThreadInfo")     return "m1";
+            if (pkt == "qsThreadInfo")     return "l";
+            if (pkt.rfind("qSymbol", 0) == 0) return "OK";
+            if (pkt.rfind("qRcmd,", 0) == 0)  return monitor(pkt.substr(6));
+            return "";
+        default:
+            return "";
+    }
+}
+
+GdbStub::Outcome GdbStub::serve() {
+    if (!wait_for_client()) return Outcome::Killed;
+
+    std::string pkt;
+    while (get_packet(pkt)) {
+        if (pkt == "k") return Outcome::Killed;            // no reply expected
+        if (pkt == "QStartNoAckMode") {
+            if (!put_packet("OK")) break;
+            no_ack_ = true;
+            continue;
+        }
+        bool done = false;
+        if (!put_packet(handle(pkt, done))) break;
+        if (done) {
+            if (exited_)      return Outcome::Exited;
+            if (pkt[0] == 'D') return Outcome::Detached;
+            return Outcome::Killed;
+        }
+    }
+    return exited_ ? Outcome::Exited : Outcome::Killed;
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include "cpu8080.h"
+#include "predicate.h"
+#include "runner.h"
+
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+// ─── GDB remote serial protocol stub ──────────────────────────────────────────
+// Serves one GDB session over a Unix domain socket or a pseudo-terminal:
+//
+//     native8080 --gdb unix:/tmp/n80.sock prog.com    (gdb) target remote /tmp/n80.sock
+//     native8080 --gdb pty prog.com                   (gdb) target remote /dev/pts/N
+//
+// GDB has no 8080 target, so the stub presents itself as a Z80 (a superset of
+// the 8080) with the register layout of GDB's z80 port: AF BC DE HL SP PC IX
+// IY AF' BC' DE' HL' IR, 16 bits each; the Z80-only registers read as zero.
+//
+// Supported: register and memory read/write (g G p P m M X), continue and
+// single-step (c s vCont), software and hardware breakpoints (Z0/Z1), write
+// watchpoints (Z2), Ctrl-C, detach and kill, and conditions on breakpoints through monitor commands:
+//
+//     (gdb) monitor cond 0x0142 HL == 0x2400 && [HL] != 0
+//     (gdb) monitor cond 0x0142              (clear)
+//     (gdb) monitor cond                     (list)
+//
+// Conditions use the Predicate syntax (predicate.h); a breakpoint whose
+// condition is false does not stop, without a round trip to the debugger.
+// With a last-writer index attached (set_write_index), `monitor writer ADDR
+// [LEN]` shows which instructions last stored to memory.
+// Breakpoints never patch guest memory: they are armed in the runner's trap
+// bitmap, so code between stops runs at full speed with a single bit test per
+// instruction, exactly as without a debugger.
+//
+// With a Timeline attached (set_timeline) the stub also executes in reverse:
+// reverse-stepi and reverse-continue (bs bc), which stops at the latest
+// breakpoint or watched write before the current instant:
+//
+//     (gdb) watch *(char *)0x2400
+//     (gdb) reverse-continue          -> at the instruction that last wrote it
+//
+// Write watchpoints are checked per instruction through the Runner's
+// instruction hook, so a session with watchpoints set runs slower.
+//
+// The stub chains onto whatever trap handler is installed when it is
+// constructed (e.g. the CP/M shim), so construct it after the shim's attach().
+
+class Timeline;
+class WriteIndex;
+
+class GdbStub {
+public:
+    enum class Outcome {
+        Detached,   // debugger detached; the program should keep running
+        Killed,     // debugger sent kill or the connection dropped
+        Exited,     // the program finished (trap stop, e.g. CP/M warm boot)
+    };
+
+    GdbStub(State8080& state, Runner& runner);
+    ~GdbStub();
+
+    GdbStub(const GdbStub&)            = delete;
+    GdbStub& operator=(const GdbStub&) = delete;
+
+    // Wait for a debugger on a Unix domain socket at `path` (replacing any
+    // stale socket file).  Returns false with a message on stderr on failure.
+    bool listen_unix(const std::string& path);
+
+    // Create a pseudo-terminal and store its slave device name in `*name`;
+    // the debugger connects by opening that device.
+    bool open_pty(std::string* name);
+
+    // Serve the session until the debugger detaches, kills or the program
+    // exits.  The CPU only runs while the debugger has it continued/stepping.
+    Outcome serve();
+
+    // Enable reverse execution; `timeline` must wrap the same state and
+    // runner and outlive the stub.
+    void set_timeline(Timeline* timeline) { timeline_ = timeline; }
+
+    // Answer `monitor writer` from `index` (which must outlive the stub).
+    void set_write_index(const WriteIndex* index) { writes_ = index; }
+
+    // Stop reason of the most recent run (for the process exit status).
+    StopReason last_reason() const { return last_reason_; }
+
+private:
+    // Transport
+    bool wait_for_client();
+    int  read_byte(bool block);
+    bool write_all(const std::string& data);
+    bool get_packet(std::string& out);
+    bool put_packet(const std::string& data);
+
+    // Execution
+    TrapAction trap(State8080& s);
+    std::string resume(bool step);
+    std::string reverse(bool step);
+    std::string stop_reply_here() const;
+    bool        watch_hook(const State8080& s);
+    std::optional<uint16_t> watched_write(const State8080& s) const;
+    bool        breakpoint_here(const State8080& s) const;
+    void        state_changed();
+    bool interrupt_pending();
+
+    // Packet handlers
+    std::string handle(const std::string& pkt, bool& done);
+    std::string read_registers() const;
+    bool        write_registers(const std::string& hex);
+    std::string read_register(unsigned n) const;
+    bool        write_register(unsigned n, const std::string& hex);
+    std::string read_memory(const std::string& args) const;
+    bool        write_memory_hex(const std::string& args);
+    bool        write_memory_binary(const std::string& args);
+    std::string breakpoint(const std::string& args, bool insert);
+    std::string query_features(const std::string& args) const;
+    std::string monitor(const std::string& hex_command);
+
+    State8080& s_;
+    Runner&    runner_;
+
+    int  listen_fd_  = -1;
+    int  fd_         = -1;
+    bool is_pty_     = false;
+    bool no_ack_     = false;
+    std::string socket_path_;
+    std::string rx_;                 // bytes read but not yet consumed
+
+    // Traps owned by whoever was attached before the stub.
+    std::bitset<0x10000>                  base_armed_;
+    std::function<TrapAction(State8080&)> base_handler_;
+
+    std::bitset<0x10000> sw_breaks_;
+    std::bitset<0x10000> hw_breaks_;
+    std::bitset<0x10000> watch_;
+    std::unordered_map<uint16_t, Predicate> conditions_;
+    std::optional<uint16_t> watch_pending_;   // watched write by the instruction just run
+    std::optional<uint16_t> watch_hit_;
+    Timeline*         timeline_ = nullptr;
+    const WriteIndex* writes_   = nullptr;
+    bool     step_over_    = false;  // resuming from a breakpoint at step_over_pc_
+    uint16_t step_over_pc_ = 0;
+    bool     break_hit_    = false;
+    bool     exited_       = false;
+
+    StopReason last_reason_ = StopReason::StopRequested;
+};
@@ -0,0 +1,121 @@
+#include "hostio.h"
+
+#include <cerrno>
+#include <chrono>
+#include <system_error>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+HostStream::HostStream(int in_fd, int out_fd) : in_fd_(in_fd), out_fd_(out_fd) {
+    eof_.store(in_fd_ < 0, std::memory_order_relaxed);
+    if (::pipe(wake_) != 0) throw std::system_error(errno, std::generic_category(), "pipe");
+    for (int fd : wake_) ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    try {
+        thread_ = std::thread([this] { run(); });
+    } catch (...) {
+        ::close(wake_[0]);
+        ::close(wake_[1]);
+        throw;
+    }
+}
+
+HostStream::~HostStream() {
+    stop_.store(true, std::memory_order_release);
+    const char c = 0;
+    (void)!::write(wake_[1], &c, 1);
+    thread_.join();
+    ::close(wake_[0]);
+    ::close(wake_[1]);
+}
+
+// ─── CPU thread ───────────────────────────────────────────────────────────────
+// Pairs with the fence in run(): either this sees the thread asleep, or the
+// thread sees what was pushed before it goes to sleep.
+void HostStream::kick() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!asleep_.load(std::memory_order_relaxed)) return;
+    const char c = 0;
+    (void)!::write(wake_[1], &c, 1);
+}
+
+bool HostStream::wait_input(int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    waiting_ = true;
+    const bool ready = input_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] {
+        return rx_->size() != 0 || eof_.load(std::memory_order_acquire);
+    });
+    waiting_ = false;
+    return ready && rx_->size() != 0;
+}
+
+void HostStream::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    waiting_ = true;
+    while (tx_->size() != 0) {
+        lock.unlock();
+        kick();
+        lock.lock();
+        drained_.wait_for(lock, std::chrono::milliseconds(10), [this] { return tx_->size() == 0; });
+    }
+    waiting_ = false;
+}
+
+// ─── Device thread ────────────────────────────────────────────────────────────
+void HostStream::notify(std::condition_variable& cv) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (waiting_) cv.notify_all();
+}
+
+void HostStream::write_out() {
+    for (std::span<const uint8_t> queued; !(queued = tx_->read_span()).empty();) {
+        if (out_fd_ < 0) {
+            tx_->consume(queued.size());
+            continue;
+        }
+        const ssize_t n = ::write(out_fd_, queued.data(), queued.size());
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {                           // host output gone: drop it
+            tx_->consume(queued.size());
+            continue;
+        }
+        writes_.fetch_add(1, std::memory_order_relaxed);
+        tx_->consume(size_t(n));
+    }
+}
+
+void HostStream::run() {
+    for (;;) {
+        write_out();
+        notify(drained_);
+        if (stop_.load(std::memory_order_acquire) && tx_->empty()) return;
+
+        // With rx full, stop reading and look for room again shortly.
+        const bool open    = in_fd_ >= 0 && !eof_.load(std::memory_order_relaxed);
+        const bool reading = open && !rx_->full();
+        pollfd fds[2] = {{wake_[0], POLLIN, 0}, {in_fd_, POLLIN, 0}};
+
+        asleep_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int timeout = open && !reading ? 1 : -1;
+        if (!tx_->empty() || stop_.load(std::memory_order_relaxed)) timeout = 0;
+        const int ready = ::poll(fds, reading ? 2 : 1, timeout);
+        asleep_.store(false, std::memory_order_relaxed);
+        if (ready <= 0) continue;
+
+        if (fds[0].revents) {
+            char buf[64];
+            while (::read(wake_[0], buf, sizeof buf) > 0) {}
+        }
+        if (reading && fds[1].revents) {
+            const std::span<uint8_t> room = rx_->write_span();
+            const ssize_t n = ::read(in_fd_, room.data(), room.size());
+            if (n > 0)
+                rx_->commit(size_t(n));
+            else if (n == 0 || (errno != EINTR && errno != EAGAIN))
+                eof_.store(true, std::memory_order_release);
+            notify(input_);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "spsc.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// ─── Host byte streams ────────────────────────────────────────────────────────
+// A device thread that moves bytes between host file descriptors and the CPU
+// thread, so no read() or write() runs on the emulation hot path.  The CPU
+// side only touches two rings:
+//
+//   rx()  host input, filled by the thread from `in_fd`; the CPU pops
+//   tx()  guest output, pushed by the CPU; the thread writes it to `out_fd`
+//
+// Both are bounded.  A full tx ring is the device's cue to report "busy" to
+// the guest (e.g. a UART's transmitter-empty bit); with rx full, the thread
+// stops reading, so the back-pressure reaches the host's pipe.
+//
+// The thread sleeps in poll() when it has nothing to write.  Pushing to tx
+// does not wake it — that would be a syscall per byte — so the CPU side
+// calls kick() at coarser points (a flush event, a wait for input), which
+// costs a write() only if the thread is actually asleep.  wait_input() lets
+// the CPU thread block until input arrives when the guest has nothing else
+// to do.
+
+class HostStream {
+public:
+    static constexpr size_t RING_BYTES = 1 << 16;
+    using Ring = SpscRing<uint8_t, RING_BYTES>;
+
+    // Starts the thread.  Either descriptor may be -1 (input ended from the
+    // start; output discarded).  Throws std::system_error if the thread cannot start.
+    HostStream(int in_fd, int out_fd);
+    ~HostStream();                            // writes what is queued, then joins
+
+    HostStream(const HostStream&)            = delete;
+    HostStream& operator=(const HostStream&) = delete;
+
+    Ring& rx() { return *rx_; }
+    Ring& tx() { return *tx_; }
+
+    // ── CPU thread ────────────────────────────────────────────────────────────
+    // Wake the thread if it sleeps, to write what tx holds and to look for
+    // input again.
+    void kick();
+
+    // Block until rx has data, input has ended or `timeout_ms` has passed;
+    // returns whether rx has data.
+    bool wait_input(int timeout_ms);
+
+    // Block until everything pushed to tx has been written.
+    void drain();
+
+    // The input descriptor reached end of file (rx may still hold bytes).
+    bool     input_ended() const { return eof_.load(std::memory_order_acquire); }
+    uint64_t writes() const      { return writes_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void write_out();
+    void notify(std::condition_variable& cv);
+
+    int in_fd_;
+    int out_fd_;
+    int wake_[2] = {-1, -1};                  // self-pipe: kick() -> poll()
+
+    std::unique_ptr<Ring> rx_ = std::make_unique<Ring>();
+    std::unique_ptr<Ring> tx_ = std::make_unique<Ring>();
+
+    std::atomic<bool>     stop_{false};
+    std::atomic<bool>     eof_{false};
+    std::atomic<bool>     asleep_{false};
+    std::atomic<uint64_t> writes_{0};
+
+    std::mutex              mutex_;           // only for the blocking waits
+    std::condition_variable input_, drained_;
+    bool                    waiting_ = false; // the CPU thread is in wait_input()/drain()
+
+    std::thread thread_;
+};
@@ -0,0 +1,122 @@
+#include "i8251.h"
+
+I8251::I8251(Runner& runner, const State8080& s, const I8251Config& config)
+    : runner_(runner), config_(config),
+      console_(runner, s, config, uint8_t(config.base + 1), TXRDY | TXEMPTY | DSR) {
+    if (config_.char_cycles == 0) config_.char_cycles = 1;
+}
+
+// ─── Pins ─────────────────────────────────────────────────────────────────────
+void I8251::set_rxrdy(bool level) {
+    if (level == rxrdy_) return;
+    rxrdy_ = level;
+    if (on_rxrdy_) on_rxrdy_(level);
+}
+
+void I8251::set_txrdy(bool level) {
+    if (level == txrdy_) return;
+    txrdy_ = level;
+    if (on_txrdy_) on_txrdy_(level);
+}
+
+// Once per character time: a character that has arrived raises RxRDY, room
+// in the transmitter raises TxRDY.
+void I8251::event(uint64_t now) {
+    if (now < next_sample_) return;
+    next_sample_ += config_.char_cycles;
+    if (next_sample_ <= now) next_sample_ = now + config_.char_cycles;
+    set_rxrdy(rx_enabled() && console_.rx_ready());
+    set_txrdy(tx_enabled() && console_.tx_ready());
+}
+
+void I8251::start_sampling() {
+    if (next_sample_ == UINT64_MAX) next_sample_ = runner_.cycles() + config_.char_cycles;
+}
+
+void I8251::connect_rxrdy(std::function<void(bool level)> fn) {
+    on_rxrdy_ = std::move(fn);
+    start_sampling();
+}
+
+void I8251::connect_txrdy(std::function<void(bool level)> fn) {
+    on_txrdy_ = std::move(fn);
+    start_sampling();
+}
+
+bool I8251::connect(std::string_view name, std::function<void(bool level)> sink) {
+    if (name == "rxrdy") connect_rxrdy(std::move(sink));
+    else if (name == "txrdy") connect_txrdy(std::move(sink));
+    else return false;
+    return true;
+}
+
+// ─── Ports ────────────────────────────────────────────────────────────────────
+uint8_t I8251::in(uint8_t port) {
+    if (port == config_.base) {
+        set_rxrdy(false);
+        return console_.read();
+    }
+    const bool rx = rx_enabled() && console_.rx_ready();
+    console_.status_read(rx);
+    const bool tx = console_.tx_ready();
+    return uint8_t(DSR | (tx ? TXRDY | TXEMPTY : 0) | (rx ? RXRDY : 0));
+}
+
+void I8251::out(uint8_t port, uint8_t val) {
+    if (port == config_.base) {
+        set_txrdy(false);
+        console_.write(val);
+        return;
+    }
+    switch (expect_) {
+        case Expect::Mode:
+            mode_   = val;
+            expect_ = (val & 0x03) ? Expect::Command : Expect::Sync1;    // baud factor 00 = synchronous
+            break;
+        case Expect::Sync1:
+            expect_ = (mode_ & 0x80) ? Expect::Command : Expect::Sync2;  // single sync character
+            break;
+        case Expect::Sync2:
+            expect_ = Expect::Command;
+            break;
+        case Expect::Command:
+            if (val & 0x40) {                       // internal reset
+                command_ = 0;
+                expect_  = Expect::Mode;
+            } else {
+                command_ = val;
+            }
+            // Enabling the transmitter with room raises TxRDY straight away.
+            set_txrdy(tx_enabled() && console_.tx_ready());
+            if (!rx_enabled()) set_rxrdy(false);
+            break;
+    }
+}
+
+// ─── Reset and snapshots ──────────────────────────────────────────────────────
+// The console's buffers are the host's side of the line and stay as they are.
+void I8251::reset() {
+    expect_  = Expect::Mode;
+    mode_    = 0;
+    command_ = 0;
+    set_rxrdy(false);
+    set_txrdy(false);
+}
+
+void I8251::save(StateWriter& w) const {
+    w.u8(uint8_t(expect_));
+    w.u8(mode_);
+    w.u8(command_);
+    w.flag(rxrdy_);
+    w.flag(txrdy_);
+    w.u64(next_sample_);
+}
+
+void I8251::restore(StateReader& r) {
+    expect_  = Expect(r.u8());
+    mode_    = r.u8();
+    command_ = r.u8();
+    set_rxrdy(r.flag());
+    set_txrdy(r.flag());
+    next_sample_ = r.u64();
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "cpu8080.h"
+#include "device.h"
+#include "runner.h"
+#include "serial.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+// ─── Intel 8251 USART ─────────────────────────────────────────────────────────
+// A programmable serial interface with one data port and one control/status
+// port, here on the host console through a SerialConsole (serial.h).
+//
+//   IN  base       received character
+//   OUT base       character to send
+//   IN  base + 1   status: bit 0 TxRDY, 1 RxRDY, 2 TxEMPTY, 3 PE, 4 OE,
+//                  5 FE, 6 SYNDET, 7 DSR (asserted)
+//   OUT base + 1   mode instruction after a reset (then one or two sync
+//                  characters in synchronous mode), command instructions
+//                  after that; command bit 6 resets to expecting a mode
+//
+// The command's TxEN and RxE bits gate the TxRDY and RxRDY pins, and RxE
+// gates the status bit as well.  Baud rates and character formats are
+// accepted and ignored: characters move at host speed, and no parity,
+// overrun or framing error is ever flagged.
+//
+// The pins are for an interrupt controller.  RxRDY rises when a character is
+// waiting and falls when it is read; TxRDY rises when the transmitter has
+// room and falls on each write.  While someone listens to them, the device
+// asks for an event every `char_cycles` (next_event_cycle()) that samples
+// the console and raises them again, so an interrupt-driven program gets one
+// edge per character, at most one character time apart.  Polled status reads
+// see the console at once.  As a Device the pins are "rxrdy" and "txrdy".
+
+struct I8251Config : SerialConfig {
+    uint8_t  base        = 0xEC;     // data port; control/status is base + 1
+    uint64_t char_cycles = 2'133;    // one character at 9600 baud on a 2.048 MHz CPU
+};
+
+class I8251 : public Device {
+public:
+    static constexpr uint8_t TXRDY   = 0x01;
+    static constexpr uint8_t RXRDY   = 0x02;
+    static constexpr uint8_t TXEMPTY = 0x04;
+    static constexpr uint8_t DSR     = 0x80;
+
+    using Stats = SerialConsole::Stats;
+
+    // Chains a trap handler onto `runner` (see TrapTable); the device must
+    // outlive the runner's use of it.  Reads the guest's code through `s`.
+    I8251(Runner& runner, const State8080& s, const I8251Config& config = {});
+
+    I8251(const I8251&)            = delete;
+    I8251& operator=(const I8251&) = delete;
+
+    bool    owns(uint8_t port) const { return uint8_t(port - config_.base) < 2; }
+    uint8_t in(uint8_t port) override;
+    void    out(uint8_t port, uint8_t val) override;
+
+    // ── Device ────────────────────────────────────────────────────────────────
+    // Pins: outputs "rxrdy" and "txrdy".
+    std::vector<PortRange> ports() const override { return {{config_.base, uint8_t(config_.base + 1)}}; }
+    void     reset() override;
+    void     save(StateWriter& w) const override;
+    void     restore(StateReader& r) override;
+    uint64_t next_event_cycle() const override { return next_sample_; }
+    void     event(uint64_t now) override;
+    bool     connect(std::string_view name, std::function<void(bool level)> sink) override;
+    void     flush() override { console_.flush(); }
+
+    // Watch the RxRDY and TxRDY pins: `fn` gets each new level.
+    void connect_rxrdy(std::function<void(bool level)> fn);
+    void connect_txrdy(std::function<void(bool level)> fn);
+
+    SerialConsole& console() { return console_; }
+
+    void  feed(const char* data, size_t size) { console_.feed(data, size); }
+    bool  input_exhausted() const             { return console_.input_exhausted(); }
+    Stats stats() const                       { return console_.stats(); }
+
+private:
+    enum class Expect { Mode, Sync1, Sync2, Command };
+
+    bool rx_enabled() const { return command_ & 0x04; }
+    bool tx_enabled() const { return command_ & 0x01; }
+    void set_rxrdy(bool level);
+    void set_txrdy(bool level);
+    void start_sampling();
+
+    Runner&       runner_;
+    I8251Config   config_;
+    SerialConsole console_;
+
+    Expect  expect_  = Expect::Mode;
+    uint8_t mode_    = 0;
+    uint8_t command_ = 0;
+    bool    rxrdy_   = false;            // pin levels
+    bool    txrdy_   = false;
+    std::function<void(bool)> on_rxrdy_, on_txrdy_;
+    uint64_t next_sample_ = UINT64_MAX;  // while anyone listens to the pins
+};
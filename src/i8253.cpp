@@ -0,0 +1,285 @@
+#include "i8253.h"
+
+#include <algorithm>
+#include <numeric>
+
+I8253::I8253(Runner& runner, uint64_t cpu_hz, uint64_t clock_hz, uint8_t base)
+    : runner_(runner), base_(base) {
+    const uint64_t g = std::gcd(cpu_hz, clock_hz);
+    num_ = g ? clock_hz / g : 1;
+    den_ = g ? cpu_hz / g : 1;
+}
+
+// ─── Time ─────────────────────────────────────────────────────────────────────
+// Split so that neither product overflows: a * num / den, and its inverse
+// rounded up.
+uint64_t I8253::ticks(const Counter& c, uint64_t cycle) const {
+    if (!c.counting) return 0;
+    if (suspended(c) || cycle < c.start) return c.held;
+    const uint64_t a = cycle - c.start;
+    return c.held + (a / den_) * num_ + (a % den_) * num_ / den_;
+}
+
+uint64_t I8253::cycle_at(const Counter& c, uint64_t t) const {
+    if (t <= c.held) return c.start;
+    const uint64_t d = t - c.held;
+    return c.start + (d / num_) * den_ + ((d % num_) * den_ + num_ - 1) / num_;
+}
+
+// ─── Counting ─────────────────────────────────────────────────────────────────
+// The count and output `t` ticks after counting started.  Modes 2 and 3
+// repeat every period; the others count down once and wrap.
+uint16_t I8253::value_at(const Counter& c, uint64_t t) const {
+    const uint32_t m = modulus(c);
+    const uint32_t n = period(c);
+    uint32_t v;
+    if (!c.counting) {
+        v = c.reload;
+    } else if (c.mode == 2) {
+        v = n - uint32_t(t % n);
+    } else if (c.mode == 3) {                       // counts by two through each half
+        const uint32_t high = (n + 1) / 2;
+        const uint32_t p    = uint32_t(t % n);
+        v = (n & ~1u) - 2 * (p < high ? p : p - high);
+    } else {
+        v = (n + m - uint32_t(t % m)) % m;
+    }
+    v %= m;
+    if (!c.bcd) return uint16_t(v);
+    return uint16_t(v % 10 | (v / 10 % 10) << 4 | (v / 100 % 10) << 8 | (v / 1000) << 12);
+}
+
+bool I8253::out_at(const Counter& c, uint64_t t) const {
+    const uint32_t n = period(c);
+    switch (c.mode) {
+        case 0:  return c.counting && t >= n;
+        case 1:  return !c.counting || t >= n;
+        case 2:  return !c.counting || !c.gate || n < 2 || t % n != n - 1;
+        case 3:  return !c.counting || !c.gate || t % n < (n + 1) / 2;
+        default: return !c.counting || t != n;      // modes 4 and 5: a one-tick strobe
+    }
+}
+
+// The first tick after `t` at which the output changes.
+std::optional<uint64_t> I8253::next_edge(const Counter& c, uint64_t t) const {
+    if (!c.counting || suspended(c)) return std::nullopt;
+    const uint64_t n    = period(c);
+    const uint64_t base = t - t % n;
+    switch (c.mode) {
+        case 0:
+        case 1:
+            if (t < n) return n;
+            return std::nullopt;
+        case 2:
+            if (n < 2) return std::nullopt;
+            return t % n < n - 1 ? base + n - 1 : base + n;
+        case 3:
+            return t % n < (n + 1) / 2 ? base + (n + 1) / 2 : base + n;
+        default:
+            if (t < n)  return n;
+            if (t == n) return n + 1;
+            return std::nullopt;
+    }
+}
+
+uint16_t I8253::count(int n) const {
+    const Counter& c = counters_[n];
+    return value_at(c, ticks(c, runner_.cycles()));
+}
+
+bool I8253::output(int n) const {
+    const Counter& c = counters_[n];
+    return out_at(c, ticks(c, runner_.cycles()));
+}
+
+// ─── Output events ────────────────────────────────────────────────────────────
+// After anything that may move a watched output: report its level now and
+// work out when it next changes.
+void I8253::changed(int n, uint64_t now) {
+    Counter& c = counters_[n];
+    if (!c.listener) return;
+    const uint64_t t     = ticks(c, now);
+    const bool     level = out_at(c, t);
+    if (level != c.out) {
+        c.out = level;
+        c.listener(level);
+    }
+    const std::optional<uint64_t> edge = next_edge(c, t);
+    c.next = edge ? cycle_at(c, *edge) : UINT64_MAX;
+}
+
+uint64_t I8253::next_event_cycle() const {
+    uint64_t next = UINT64_MAX;
+    for (const Counter& c : counters_) next = std::min(next, c.next);
+    return next;
+}
+
+void I8253::event(uint64_t now) {
+    for (int n = 0; n < 3; ++n)
+        if (counters_[n].next <= now) changed(n, now);
+}
+
+void I8253::connect(int n, std::function<void(bool level)> fn) {
+    Counter& c = counters_[n];
+    c.listener = std::move(fn);
+    c.out      = !out_at(c, ticks(c, runner_.cycles()));    // report the current level
+    changed(n, runner_.cycles());
+}
+
+// "out0" -> 0 and so on; -1 for anything else.
+static int pin_index(std::string_view name, std::string_view prefix) {
+    if (name.size() != prefix.size() + 1 || name.substr(0, prefix.size()) != prefix) return -1;
+    const int n = name.back() - '0';
+    return n >= 0 && n < 3 ? n : -1;
+}
+
+bool I8253::connect(std::string_view name, std::function<void(bool level)> sink) {
+    const int n = pin_index(name, "out");
+    if (n < 0) return false;
+    connect(n, std::move(sink));
+    return true;
+}
+
+std::function<void(bool level)> I8253::input(std::string_view name) {
+    const int n = pin_index(name, "gate");
+    if (n < 0) return {};
+    return [this, n](bool level) { set_gate(n, level); };
+}
+
+void I8253::set_gate(int n, bool level) {
+    Counter& c = counters_[n];
+    if (level == c.gate) return;
+    const uint64_t now = runner_.cycles();
+    if (!level) {
+        if (c.mode != 1 && c.mode != 5) c.held = ticks(c, now);
+        c.gate = false;
+    } else {
+        c.gate  = true;
+        c.start = now;
+        if (c.mode == 1 || c.mode == 2 || c.mode == 3 || c.mode == 5) {
+            c.held     = 0;                         // trigger or restart
+            c.counting = c.loaded;
+        }
+    }
+    changed(n, now);
+}
+
+// ─── Ports ────────────────────────────────────────────────────────────────────
+void I8253::load(Counter& c, uint64_t now) {
+    c.loaded = true;
+    if ((c.mode == 1 || c.mode == 5) && !c.counting) return;    // waits for the gate
+    c.counting = true;
+    c.start    = now;
+    c.held     = 0;
+}
+
+uint8_t I8253::in(uint8_t port) {
+    const int n = uint8_t(port - base_);
+    if (n > 2) return 0xFF;                         // the control word is write-only
+    Counter& c = counters_[n];
+    const uint16_t v = c.latch ? *c.latch : count(n);
+    bool msb = c.access == 2;
+    if (c.access == 3) {
+        msb        = c.read_msb;
+        c.read_msb = !c.read_msb;
+    }
+    if (msb || c.access != 3) c.latch.reset();      // the latch holds until fully read
+    return msb ? uint8_t(v >> 8) : uint8_t(v);
+}
+
+void I8253::out(uint8_t port, uint8_t val) {
+    const int      n   = uint8_t(port - base_);
+    const uint64_t now = runner_.cycles();
+    if (n == 3) {
+        const int sel = val >> 6;
+        if (sel == 3) return;                       // the 8254's read-back command
+        Counter& c = counters_[sel];
+        if ((val & 0x30) == 0) {                    // counter latch command
+            if (!c.latch) c.latch = count(sel);
+            return;
+        }
+        c.access    = (val >> 4) & 3;
+        c.mode      = (val >> 1) & 7;
+        if (c.mode > 5) c.mode -= 4;                // 6 and 7 alias 2 and 3
+        c.bcd       = val & 1;
+        c.loaded    = c.counting = false;
+        c.held      = 0;
+        c.write_msb = c.read_msb = false;
+        c.latch.reset();
+        changed(sel, now);
+        return;
+    }
+
+    Counter& c = counters_[n];
+    uint16_t raw;
+    if (c.access == 3 && !c.write_msb) {
+        c.write_lsb = val;
+        c.write_msb = true;
+        return;
+    }
+    if (c.access == 3) {
+        raw         = uint16_t(c.write_lsb | val << 8);
+        c.write_msb = false;
+    } else {
+        raw = c.access == 2 ? uint16_t(val << 8) : val;
+    }
+    c.reload = c.bcd ? uint32_t((raw & 0xF) + (raw >> 4 & 0xF) * 10 + (raw >> 8 & 0xF) * 100 + (raw >> 12) * 1000)
+                     : raw;
+    load(c, now);
+    changed(n, now);
+}
+
+// ─── Reset and snapshots ──────────────────────────────────────────────────────
+// Listeners are wiring, not state: they survive both.
+void I8253::reset() {
+    for (int n = 0; n < 3; ++n) {
+        Counter& c = counters_[n];
+        auto listener = std::move(c.listener);
+        c = Counter{};
+        c.listener = std::move(listener);
+        changed(n, runner_.cycles());
+    }
+}
+
+void I8253::save(StateWriter& w) const {
+    for (const Counter& c : counters_) {
+        w.u8(c.mode);
+        w.u8(c.access);
+        w.flag(c.bcd);
+        w.u32(c.reload);
+        w.flag(c.loaded);
+        w.flag(c.counting);
+        w.flag(c.gate);
+        w.u64(c.start);
+        w.u64(c.held);
+        w.u8(c.write_lsb);
+        w.flag(c.write_msb);
+        w.flag(c.read_msb);
+        w.flag(c.latch.has_value());
+        w.u16(c.latch.value_or(0));
+        w.flag(c.out);
+    }
+}
+
+void I8253::restore(StateReader& r) {
+    for (int n = 0; n < 3; ++n) {
+        Counter& c = counters_[n];
+        c.mode      = r.u8();
+        c.access    = r.u8();
+        c.bcd       = r.flag();
+        c.reload    = r.u32();
+        c.loaded    = r.flag();
+        c.counting  = r.flag();
+        c.gate      = r.flag();
+        c.start     = r.u64();
+        c.held      = r.u64();
+        c.write_lsb = r.u8();
+        c.write_msb = r.flag();
+        c.read_msb  = r.flag();
+        const bool     latched = r.flag();
+        const uint16_t latch   = r.u16();
+        c.latch = latched ? std::optional<uint16_t>(latch) : std::nullopt;
+        c.out   = r.flag();
+        changed(n, runner_.cycles());
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include "device.h"
+#include "runner.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// ─── Intel 8253 programmable interval timer ───────────────────────────────────
+// Three 16-bit down-counters on a common input clock, each with a gate input
+// and an output pin.
+//
+//   OUT base + n  (n = 0-2) count for counter n: LSB, MSB or LSB then MSB
+//   IN  base + n  the current count, or the latched one, in the same order
+//   OUT base + 3  control word: SC1-0 counter, RW1-0 access (00 = latch the
+//                 count), M2-M0 mode 0-5, BCD
+//
+// Nothing is decremented per instruction or per tick.  A counter keeps the
+// cycle it started counting at, and its count and output are worked out from
+// the cycles elapsed since then whenever the guest reads it.  Only an output
+// with a listener attached (connect()) costs anything while counting: its
+// next transition is the device's next_event_cycle(), so on a Board a rate
+// generator driving an interrupt costs two events per period.
+//
+// Modes as on the datasheet: 0 interrupt on terminal count, 1 retriggerable
+// one-shot, 2 rate generator, 3 square wave, 4 software and 5 hardware
+// triggered strobe.  Gates are high unless set_gate() says otherwise; a low
+// gate suspends counting in modes 0, 2, 3 and 4, and a rising edge triggers
+// modes 1 and 5 and restarts modes 2 and 3.  Simplifications: a count is
+// loaded on the write that completes it, not on the next clock edge, and a
+// new count in modes 2 and 3 restarts the period at once.
+
+class I8253 : public Device {
+public:
+    // `cpu_hz` and `clock_hz` relate the counters' input clock to the
+    // runner's cycles; their ratio is kept reduced, and the product of the
+    // reduced terms must fit in 64 bits.
+    I8253(Runner& runner, uint64_t cpu_hz, uint64_t clock_hz, uint8_t base = 0xDC);
+
+    I8253(const I8253&)            = delete;
+    I8253& operator=(const I8253&) = delete;
+
+    bool    owns(uint8_t port) const { return uint8_t(port - base_) < 4; }
+    uint8_t in(uint8_t port) override;
+    void    out(uint8_t port, uint8_t val) override;
+
+    // Watch counter `n`'s output: `fn` gets the new level at each transition,
+    // at the cycle it happens (from event()).
+    void connect(int n, std::function<void(bool level)> fn);
+
+    void set_gate(int n, bool level);
+
+    // ── Device ────────────────────────────────────────────────────────────────
+    // Pins: outputs "out0"-"out2", inputs "gate0"-"gate2".
+    std::vector<PortRange> ports() const override { return {{base_, uint8_t(base_ + 3)}}; }
+    void     reset() override;
+    void     save(StateWriter& w) const override;
+    void     restore(StateReader& r) override;
+    uint64_t next_event_cycle() const override;
+    void     event(uint64_t now) override;
+    bool     connect(std::string_view name, std::function<void(bool level)> sink) override;
+    std::function<void(bool level)> input(std::string_view name) override;
+
+    // The current count and output of counter `n`, as the chip would show
+    // them now.
+    uint16_t count(int n) const;
+    bool     output(int n) const;
+
+private:
+    struct Counter {
+        uint8_t  mode    = 0;
+        uint8_t  access  = 3;          // RW bits: 1 LSB, 2 MSB, 3 LSB then MSB
+        bool     bcd     = false;
+        uint32_t reload  = 0;          // the count written, as a number of ticks (0 = the maximum)
+        bool     loaded  = false;      // a count has been written since the control word
+        bool     counting = false;     // ... and, in modes 1 and 5, triggered by the gate
+        bool     gate    = true;
+        uint64_t start   = 0;          // cycle counting started (or resumed) at
+        uint64_t held    = 0;          // ticks counted before the gate went low
+        uint8_t  write_lsb = 0;
+        bool     write_msb = false;    // the next count byte written is the MSB
+        bool     read_msb  = false;
+        std::optional<uint16_t> latch;
+        bool     out     = true;       // the level last reported to the listener
+        uint64_t next    = UINT64_MAX; // cycle of its next transition, if listened to
+        std::function<void(bool)> listener;
+    };
+
+    uint32_t modulus(const Counter& c) const { return c.bcd ? 10'000 : 0x10000; }
+    uint32_t period(const Counter& c)  const { return c.reload ? c.reload : modulus(c); }
+    uint64_t ticks(const Counter& c, uint64_t cycle) const;
+    uint64_t cycle_at(const Counter& c, uint64_t ticks) const;
+    uint16_t value_at(const Counter& c, uint64_t t) const;
+    bool     out_at(const Counter& c, uint64_t t) const;
+    std::optional<uint64_t> next_edge(const Counter& c, uint64_t t) const;
+
+    bool     suspended(const Counter& c) const { return !c.gate && c.mode != 1 && c.mode != 5; }
+    void     load(Counter& c, uint64_t now);
+    void     changed(int n, uint64_t now);
+
+    Runner&                runner_;
+    uint64_t               num_;        // ticks = cycles * num_ / den_
+    uint64_t               den_;
+    uint8_t                base_;
+    std::array<Counter, 3> counters_;
+};
@@ -0,0 +1,196 @@
+#include "i8259.h"
+
+I8259::I8259(Runner& runner, uint8_t base) : runner_(runner), base_(base) {
+    runner_.set_interrupt_controller([this] { return acknowledge(); });
+}
+
+// ─── Priority ─────────────────────────────────────────────────────────────────
+int I8259::highest(uint8_t bits) const {
+    for (int i = 0; i < 8; ++i) {
+        const int level = (lowest_ + 1 + i) & 7;
+        if (bits & (1u << level)) return level;
+    }
+    return -1;
+}
+
+// A request is granted if it outranks every level in service; in special
+// mask mode, masked levels in service do not count.
+int I8259::pending() const {
+    const int req = highest(uint8_t(irr_ & ~imr_));
+    if (req < 0) return -1;
+    const int busy = highest(special_mask_ ? uint8_t(isr_ & ~imr_) : isr_);
+    return busy < 0 || rank(req) < rank(busy) ? req : -1;
+}
+
+void I8259::update() {
+    const bool level = pending() >= 0;
+    if (level == int_) return;
+    int_ = level;
+    runner_.interrupt_line(level);
+}
+
+void I8259::set_irq(int line, bool level) {
+    const uint8_t bit = uint8_t(1u << (line & 7));
+    const bool    was = levels_ & bit;
+    levels_ = level ? uint8_t(levels_ | bit) : uint8_t(levels_ & ~bit);
+    if (icw1_ & 0x08)                               // level-triggered: IRR follows the pin
+        irr_ = level ? uint8_t(irr_ | bit) : uint8_t(irr_ & ~bit);
+    else if (level && !was)
+        irr_ |= bit;
+    update();
+}
+
+// ─── Acknowledge ──────────────────────────────────────────────────────────────
+// INTA: the winning request moves from IRR to ISR and its vector goes on the
+// bus.  A request that went away before the CPU answered gets IR7's vector
+// without being put in service, as on the chip.
+Runner::InterruptVector I8259::acknowledge() {
+    int_ = false;                                   // the runner has dropped the line
+    int level = pending();
+    if (level >= 0) {
+        const uint8_t bit = uint8_t(1u << level);
+        if (!(icw1_ & 0x08)) irr_ &= uint8_t(~bit);
+        if (icw4_ & 0x02) {                         // automatic EOI
+            if (rotate_aeoi_) lowest_ = level;
+        } else {
+            isr_ |= bit;
+        }
+    } else {
+        level = 7;
+    }
+    update();
+
+    if (icw4_ & 0x01) return {uint8_t((icw2_ & 0xF8) | level), 0};
+    const uint16_t table = uint16_t(icw2_ << 8);
+    const uint16_t addr  = (icw1_ & 0x04) ? uint16_t(table | (icw1_ & 0xE0) | (level << 2))
+                                          : uint16_t(table | (icw1_ & 0xC0) | (level << 3));
+    return {0xCD, addr};
+}
+
+void I8259::end_of_interrupt(int level) {
+    if (level >= 0) isr_ &= uint8_t(~(1u << level));
+}
+
+// ─── Ports ────────────────────────────────────────────────────────────────────
+uint8_t I8259::in(uint8_t port) {
+    if (port != base_) return imr_;
+    if (!poll_) return read_isr_ ? isr_ : irr_;
+
+    // Poll word: bit 7 = a request, bits 2-0 = its level; reading it
+    // acknowledges the request like INTA.
+    poll_ = false;
+    const int level = pending();
+    if (level < 0) return 0x00;
+    if (!(icw1_ & 0x08)) irr_ &= uint8_t(~(1u << level));
+    if (!(icw4_ & 0x02)) isr_ |= uint8_t(1u << level);
+    update();
+    return uint8_t(0x80 | level);
+}
+
+void I8259::out(uint8_t port, uint8_t val) {
+    if (port == base_) {
+        if (val & 0x10) {                           // ICW1: start initialisation
+            icw1_   = val;
+            icw4_   = 0;
+            imr_    = 0;
+            isr_    = 0;
+            irr_    = (val & 0x08) ? levels_ : 0;
+            lowest_ = 7;
+            read_isr_ = poll_ = special_mask_ = rotate_aeoi_ = false;
+            init_   = Init::Icw2;
+        } else if (val & 0x08) {                    // OCW3
+            if (val & 0x02) read_isr_ = val & 0x01;
+            if (val & 0x40) special_mask_ = val & 0x20;
+            poll_ = val & 0x04;
+        } else {                                    // OCW2
+            const int level = val & 0x07;
+            switch (val >> 5) {
+                case 0: rotate_aeoi_ = false; break;                        // clear rotate in AEOI
+                case 4: rotate_aeoi_ = true;  break;                        // set rotate in AEOI
+                case 1: end_of_interrupt(highest(isr_)); break;             // non-specific EOI
+                case 3: end_of_interrupt(level); break;                     // specific EOI
+                case 5: {                                                   // rotate on non-specific EOI
+                    const int served = highest(isr_);
+                    end_of_interrupt(served);
+                    if (served >= 0) lowest_ = served;
+                    break;
+                }
+                case 6: lowest_ = level; break;                             // set priority
+                case 7: end_of_interrupt(level); lowest_ = level; break;    // rotate on specific EOI
+                default: break;                                             // no operation
+            }
+        }
+        update();
+        return;
+    }
+
+    switch (init_) {
+        case Init::Icw2:
+            icw2_ = val;
+            init_ = (icw1_ & 0x02) ? ((icw1_ & 0x01) ? Init::Icw4 : Init::Ready) : Init::Icw3;
+            break;
+        case Init::Icw3:
+            init_ = (icw1_ & 0x01) ? Init::Icw4 : Init::Ready;
+            break;
+        case Init::Icw4:
+            icw4_ = val;
+            init_ = Init::Ready;
+            break;
+        case Init::Ready:
+            imr_ = val;                             // OCW1
+            break;
+    }
+    update();
+}
+
+// ─── Device ───────────────────────────────────────────────────────────────────
+std::function<void(bool level)> I8259::input(std::string_view name) {
+    if (name.size() != 3 || name.substr(0, 2) != "ir" || name[2] < '0' || name[2] > '7') return {};
+    const int line = name[2] - '0';
+    return [this, line](bool level) { set_irq(line, level); };
+}
+
+// The input pins belong to whoever drives them and keep their levels.
+void I8259::reset() {
+    init_   = Init::Ready;
+    icw1_   = icw2_ = icw4_ = 0;
+    irr_    = isr_ = 0;
+    imr_    = 0xFF;
+    lowest_ = 7;
+    read_isr_ = poll_ = special_mask_ = rotate_aeoi_ = false;
+    update();
+}
+
+void I8259::save(StateWriter& w) const {
+    w.u8(uint8_t(init_));
+    w.u8(icw1_);
+    w.u8(icw2_);
+    w.u8(icw4_);
+    w.u8(irr_);
+    w.u8(isr_);
+    w.u8(imr_);
+    w.u8(levels_);
+    w.u8(uint8_t(lowest_));
+    w.flag(read_isr_);
+    w.flag(poll_);
+    w.flag(special_mask_);
+    w.flag(rotate_aeoi_);
+}
+
+void I8259::restore(StateReader& r) {
+    init_   = Init(r.u8());
+    icw1_   = r.u8();
+    icw2_   = r.u8();
+    icw4_   = r.u8();
+    irr_    = r.u8();
+    isr_    = r.u8();
+    imr_    = r.u8();
+    levels_ = r.u8();
+    lowest_ = r.u8() & 7;
+    read_isr_     = r.flag();
+    poll_         = r.flag();
+    special_mask_ = r.flag();
+    rotate_aeoi_  = r.flag();
+    int_ = pending() >= 0;                          // drive the line whatever it was
+    runner_.interrupt_line(int_);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "device.h"
+#include "runner.h"
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+// ─── Intel 8259 programmable interrupt controller ──────────────────────────────
+// Eight request inputs IR0-IR7 in front of the CPU's single interrupt line,
+// as used in 8080 mode: when the CPU acknowledges, the PIC puts a CALL on the
+// bus to a vector in a table of 4- or 8-byte entries.
+//
+//   OUT base      ICW1 (bit 4 set), OCW2 (bits 4-3 = 00), OCW3 (bits 4-3 = 01)
+//   OUT base + 1  ICW2-ICW4 during initialisation, then OCW1 (the mask)
+//   IN  base      IRR or ISR (as OCW3 selected), or the poll word after a
+//                 poll command
+//   IN  base + 1  IMR
+//
+// The vector for IRn is ICW2:ICW1 bits 7-5 plus n * 4 (ICW1 bit 2 set) or
+// ICW2:ICW1 bits 7-6 plus n * 8.  Supported: edge- and level-triggered
+// inputs, masking and special mask mode, fixed and rotating priority,
+// specific and non-specific EOI, automatic EOI, and polling.  A single PIC
+// only: ICW3 is accepted and ignored.  In 8086 mode (ICW4 bit 0) the vector
+// byte itself goes on the bus, which the 8080 executes as RST.
+//
+// The PIC installs itself as the runner's interrupt controller (see
+// Runner::set_interrupt_controller) and drives the line whenever a request,
+// the mask or the in-service set changes, so devices just call set_irq()
+// from an event or an I/O handler.  Until ICW1 is written every input is
+// masked.
+
+class I8259 : public Device {
+public:
+    explicit I8259(Runner& runner, uint8_t base = 0xDA);
+
+    I8259(const I8259&)            = delete;
+    I8259& operator=(const I8259&) = delete;
+
+    bool    owns(uint8_t port) const { return uint8_t(port - base_) < 2; }
+    uint8_t in(uint8_t port) override;
+    void    out(uint8_t port, uint8_t val) override;
+
+    // Drive input IR`line` (0-7).  Edge-triggered inputs request on a rising
+    // edge; level-triggered ones while high.
+    void set_irq(int line, bool level);
+
+    uint8_t irr() const { return irr_; }
+    uint8_t isr() const { return isr_; }
+    uint8_t imr() const { return imr_; }
+
+    // ── Device ────────────────────────────────────────────────────────────────
+    // Pins: inputs "ir0"-"ir7".  A reset returns to the uninitialised state.
+    std::vector<PortRange> ports() const override { return {{base_, uint8_t(base_ + 1)}}; }
+    void reset() override;
+    void save(StateWriter& w) const override;
+    void restore(StateReader& r) override;
+    std::function<void(bool level)> input(std::string_view name) override;
+
+private:
+    enum class Init { Ready, Icw2, Icw3, Icw4 };
+
+    Runner::InterruptVector acknowledge();
+    int  highest(uint8_t bits) const;         // highest-priority level set, or -1
+    int  rank(int level) const { return (level - lowest_ - 1) & 7; }   // 0 = highest priority
+    int  pending() const;                     // the level a request would be granted for, or -1
+    void end_of_interrupt(int level);
+    void update();
+
+    Runner& runner_;
+    uint8_t base_;
+
+    Init    init_   = Init::Ready;
+    uint8_t icw1_   = 0;
+    uint8_t icw2_   = 0;
+    uint8_t icw4_   = 0;
+    uint8_t irr_    = 0;
+    uint8_t isr_    = 0;
+    uint8_t imr_    = 0xFF;
+    uint8_t levels_ = 0;          // input pins
+    int     lowest_ = 7;          // lowest-priority level
+    bool    read_isr_     = false;
+    bool    poll_         = false;
+    bool    special_mask_ = false;
+    bool    rotate_aeoi_  = false;
+    bool    int_          = false; // the line as last driven
+};
@@ -0,0 +1,146 @@
+#include "invaders.h"
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Transpose an 8x8 bit matrix held one row per byte: bit j of byte i moves to
+// bit i of byte j.
+constexpr uint64_t transpose8(uint64_t x) {
+    uint64_t t;
+    t = (x ^ (x >> 7))  & 0x00AA00AA00AA00AAULL; x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL; x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL; x ^= t ^ (t << 28);
+    return x;
+}
+static_assert(transpose8(0x0000000000000001ULL) == 0x0000000000000001ULL);
+static_assert(transpose8(0x0000000000000080ULL) == 0x0100000000000000ULL);
+static_assert(transpose8(0x0200000000000000ULL) == 0x0000000000008000ULL);
+
+constexpr uint32_t BLACK = Rgba(0x00, 0x00, 0x00);
+constexpr uint32_t WHITE = Rgba(0xFF, 0xFF, 0xFF);
+constexpr uint32_t RED   = Rgba(0xFF, 0x30, 0x30);
+constexpr uint32_t GREEN = Rgba(0x30, 0xFF, 0x30);
+
+} // namespace
+
+Invaders::Invaders(const InvadersConfig& config) : config_(config) {
+    MachineConfig mc;
+    mc.console  = nullptr;
+    mc.throttle = config_.throttle;
+    machine_ = std::make_unique<Machine>(mc);
+    machine_->set_in_handler ([this](uint8_t port) { return in(port); });
+    machine_->set_out_handler([this](uint8_t port, uint8_t val) { out(port, val); });
+
+    Runner& runner = machine_->runner();
+    runner.events.every(MIDFRAME_CYCLE, CYCLES_PER_FRAME, [&runner](uint64_t) {
+        runner.interrupt(0xCF);                                 // RST 1
+    });
+    runner.events.every(VBLANK_CYCLE, CYCLES_PER_FRAME, [this, &runner](uint64_t) {
+        runner.interrupt(0xD7);                                 // RST 2
+        ++frames_;
+    });
+}
+
+// ─── ROM ──────────────────────────────────────────────────────────────────────
+void Invaders::load_rom(const char* path) {
+    if (!std::filesystem::is_directory(path)) {
+        machine_->load(path, 0x0000);
+        return;
+    }
+    // MAME layout: invaders.h at 0x0000, .g at 0x0800, .f at 0x1000, .e at 0x1800.
+    const char parts[] = {'h', 'g', 'f', 'e'};
+    for (int i = 0; i < 4; ++i) {
+        const std::string part = (std::filesystem::path(path) / "invaders.").string() + parts[i];
+        if (std::filesystem::file_size(part) != 0x800)
+            throw std::runtime_error(part + ": expected a 2 KB ROM part");
+        machine_->load(part.c_str(), uint16_t(i * 0x800));
+    }
+}
+
+void Invaders::load_rom(const uint8_t* data, size_t size) {
+    if (size > ROM_SIZE) throw std::runtime_error("ROM larger than 8 KB");
+    machine_->load(data, size, 0x0000);
+}
+
+// ─── Ports ────────────────────────────────────────────────────────────────────
+void Invaders::set_input(InvadersInput input, bool down) {
+    const uint8_t port = uint8_t(uint16_t(input) >> 8);
+    const uint8_t bit  = uint8_t(input);
+    down ? (inputs_[port] |= bit) : (inputs_[port] &= uint8_t(~bit));
+}
+
+uint8_t Invaders::in(uint8_t port) const {
+    switch (port) {
+        case 0:
+        case 1: return inputs_[port];
+        case 2: return uint8_t(inputs_[2] | (config_.dips & 0x8B));
+        case 3: return uint8_t(shift_ >> (8 - shift_amount_));
+        default: return 0x00;
+    }
+}
+
+void Invaders::out(uint8_t port, uint8_t val) {
+    switch (port) {
+        case 2: shift_amount_ = val & 7; break;
+        case 4: shift_ = uint16_t(val << 8 | shift_ >> 8); break;
+        case 3: sound3_ = val; break;
+        case 5: sound5_ = val; break;
+        default: break;                 // 6: watchdog
+    }
+}
+
+// ─── Running ──────────────────────────────────────────────────────────────────
+// Frame n ends at the VBlank event, at a fixed cycle; running to exactly that
+// cycle dispatches it before the cycle limit is reported.
+StopReason Invaders::run_frames(uint64_t n) {
+    const uint64_t target = frames_ + n;
+    while (frames_ < target) {
+        const uint64_t due = (target - 1) * CYCLES_PER_FRAME + VBLANK_CYCLE;
+        StopReason reason = machine_->run_cycles(due > machine_->cycles() ? due - machine_->cycles() : 1);
+        if (reason != StopReason::CycleLimit) return reason;
+    }
+    return StopReason::CycleLimit;
+}
+
+// ─── Rendering ────────────────────────────────────────────────────────────────
+// Video RAM holds the raster as the beam draws it: 224 lines of 32 bytes,
+// least significant bit first, with the monitor turned 90 degrees anticlockwise.
+// Upright, pixel (x, y) is bit (255 - y) of line x.  Rotating 8x8 blocks with
+// a bit transpose gives an upright 1bpp bitmap, which ExpandBits() colours.
+void Invaders::render(Framebuffer& fb) const {
+    constexpr int ROW_BYTES = WIDTH / 8;
+    uint8_t upright[HEIGHT][ROW_BYTES];
+
+    const uint8_t* vram = machine_->state().mem.data() + VRAM;
+    for (int band = 0; band < HEIGHT / 8; ++band) {
+        const int src = 31 - band;                          // byte within each line
+        for (int xb = 0; xb < ROW_BYTES; ++xb) {
+            uint64_t block = 0;
+            for (int i = 0; i < 8; ++i)
+                block |= uint64_t(vram[(xb * 8 + i) * 32 + src]) << (8 * i);
+            block = transpose8(block);
+            for (int r = 0; r < 8; ++r)
+                upright[band * 8 + r][xb] = uint8_t(block >> (8 * (7 - r)));
+        }
+    }
+
+    if (fb.width != WIDTH || fb.height != HEIGHT) fb.resize(WIDTH, HEIGHT);
+    for (int y = 0; y < HEIGHT; ++y) {
+        uint32_t* row = fb.row(y);
+        if (!config_.overlay) {
+            ExpandBits(upright[y], ROW_BYTES, row, WHITE, BLACK);
+        } else if (y >= 240) {
+            // Remaining-lives strip: green over the reserve ships only.
+            ExpandBits(upright[y],      2,  row,       WHITE, BLACK);
+            ExpandBits(upright[y] + 2,  15, row + 16,  GREEN, BLACK);
+            ExpandBits(upright[y] + 17, 11, row + 136, WHITE, BLACK);
+        } else {
+            const uint32_t fg = y >= 32 && y < 64 ? RED : y >= 184 ? GREEN : WHITE;
+            ExpandBits(upright[y], ROW_BYTES, row, fg, BLACK);
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include "machine.h"
+#include "runner.h"
+#include "throttle.h"
+#include "video.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+// ─── Space Invaders profile ───────────────────────────────────────────────────
+// The Midway 8080 board used by Space Invaders, as a CPU-plus-video stress
+// test: 8 KB ROM at 0x0000, RAM at 0x2000 and a 7 KB 1bpp video RAM at 0x2400
+// that the video hardware scans out 60 times a second.
+//
+//   IN  0, 1, 2   inputs and DIP switches (InvadersInput, InvadersConfig::dips)
+//   OUT 2         shift amount (bits 0-2)
+//   OUT 4         shift data: the 16-bit shift register moves right by 8 and
+//                 the byte enters at the top
+//   IN  3         the shift register's top 8 bits, after the shift amount
+//   OUT 3, 5      sound latches (recorded, not played)
+//   OUT 6         watchdog (ignored)
+//
+// The video hardware interrupts with RST 1 when the beam reaches scanline 96
+// (mid-frame) and RST 2 at scanline 224 (start of VBlank); both come from the
+// runner's event scheduler, so the CPU runs in long slices between them.
+// Memory is the flat 64 KB of State8080: ROM is not write-protected and the
+// RAM mirror at 0x4000 is not modelled, neither of which the game relies on.
+//
+// Rendering is headless: render() rotates video RAM upright (the monitor is
+// mounted on its side) and expands it to RGBA with ExpandBits().
+
+enum class InvadersInput : uint16_t {      // port << 8 | bit
+    Coin    = 0x101,
+    P2Start = 0x102,
+    P1Start = 0x104,
+    P1Fire  = 0x110,
+    P1Left  = 0x120,
+    P1Right = 0x140,
+    Tilt    = 0x204,
+    P2Fire  = 0x210,
+    P2Left  = 0x220,
+    P2Right = 0x240,
+};
+
+struct InvadersConfig {
+    // Port 2 DIP switches: bits 0-1 ships - 3, bit 3 bonus ship at 1000
+    // instead of 1500, bit 7 coin info off.
+    uint8_t dips    = 0x00;
+    bool    overlay = true;                // colour the cabinet's cellophane strips
+
+    std::optional<ThrottleConfig> throttle;   // unset = run flat out
+};
+
+class Invaders {
+public:
+    static constexpr uint64_t CLOCK_HZ         = 1'996'800;         // 19.968 MHz / 10
+    static constexpr uint64_t CYCLES_PER_FRAME = CLOCK_HZ / 60;     // 262 scanlines
+    static constexpr uint64_t MIDFRAME_CYCLE   = CYCLES_PER_FRAME * 96 / 262;
+    static constexpr uint64_t VBLANK_CYCLE     = CYCLES_PER_FRAME * 224 / 262;
+
+    static constexpr uint16_t ROM_SIZE = 0x2000;
+    static constexpr uint16_t RAM      = 0x2000;
+    static constexpr uint16_t VRAM     = 0x2400;
+    static constexpr int      WIDTH    = 224;      // upright
+    static constexpr int      HEIGHT   = 256;
+
+    explicit Invaders(const InvadersConfig& config = {});
+
+    Invaders(const Invaders&)            = delete;
+    Invaders& operator=(const Invaders&) = delete;
+
+    // Load the program ROM: an 8 KB image, or a directory holding the four
+    // 2 KB parts invaders.h, .g, .f and .e.  Throws std::runtime_error.
+    void load_rom(const char* path);
+    void load_rom(const uint8_t* data, size_t size);
+
+    void set_input(InvadersInput input, bool down);
+
+    // Run until `n` more frames have ended (at VBlank).  Returns
+    // StopReason::CycleLimit when they have, or whatever stopped the run
+    // sooner.
+    StopReason run_frames(uint64_t n);
+
+    uint64_t frames() const { return frames_; }
+
+    // The screen as displayed: WIDTH x HEIGHT RGBA.
+    void render(Framebuffer& fb) const;
+
+    uint8_t  sound(int port) const { return port == 3 ? sound3_ : port == 5 ? sound5_ : 0; }
+    Machine& machine()             { return *machine_; }
+
+private:
+    uint8_t in(uint8_t port) const;
+    void    out(uint8_t port, uint8_t val);
+
+    InvadersConfig           config_;
+    std::unique_ptr<Machine> machine_;
+    uint8_t  inputs_[3] = {0x0E, 0x08, 0x00};   // ports 0-2; fixed bits set
+    uint16_t shift_        = 0;
+    uint8_t  shift_amount_ = 0;
+    uint8_t  sound3_ = 0, sound5_ = 0;
+    uint64_t frames_ = 0;
+};
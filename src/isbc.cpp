@@ -0,0 +1,24 @@
+#include "isbc.h"
+
+#include <string>
+
+BoardSpec IsbcSpec(const IsbcConfig& config) {
+    BoardSpec spec;
+    spec.clock_hz = Isbc::CLOCK_HZ;
+    spec.throttle = config.throttle;
+    spec.console  = config.usart;
+    spec.devices  = {
+        {"i8259", "pic",   {}},                      // first: the others drive it
+        {"i8253", "pit",   {{"clock_hz", std::to_string(Isbc::PIT_CLOCK_HZ)}}},
+        {"i8251", "usart", {{"base", std::to_string(config.usart.base)},
+                            {"char_cycles", std::to_string(config.usart.char_cycles)}}},
+    };
+    const auto ir = [](int line) { return "pic.ir" + std::to_string(line); };
+    spec.wires = {
+        {"pit.out0",    ir(Isbc::IRQ_TIMER0)},
+        {"pit.out1",    ir(Isbc::IRQ_TIMER1)},
+        {"usart.rxrdy", ir(Isbc::IRQ_RXRDY)},
+        {"usart.txrdy", ir(Isbc::IRQ_TXRDY)},
+    };
+    return spec;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "board.h"
+#include "i8251.h"
+#include "i8253.h"
+#include "i8259.h"
+#include "machine.h"
+#include "runner.h"
+#include "throttle.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+// ─── iSBC profile ─────────────────────────────────────────────────────────────
+// An Intel single-board computer built around the three classic 8080
+// peripherals, at the ports of the iSBC 80/20: an 8251 USART on the host
+// console, an 8253 interval timer and an 8259 interrupt controller in front
+// of the CPU's interrupt line.  64 KB of RAM; the board's 8255 parallel
+// ports are not modelled.
+//
+//   IN/OUT 0xDA-0xDB  8259 PIC (see i8259.h)
+//   IN/OUT 0xDC-0xDF  8253 PIT: counters 0-2 and control (see i8253.h)
+//   IN/OUT 0xEC-0xED  8251 USART: data, control/status (see i8251.h)
+//
+// The interrupt jumpers are fixed as follows:
+//
+//   IR2  PIT counter 0 output       IR6  USART RxRDY
+//   IR3  PIT counter 1 output       IR7  USART TxRDY
+//
+// The CPU runs at 2.048 MHz and the PIT counts a 1.2288 MHz clock, so a
+// count of 12288 in mode 2 interrupts 100 times a second.  Counter 2 clocks
+// the USART on the real board; here its output goes nowhere and the USART
+// moves one character per I8251Config::char_cycles.  Other ports read 0xFF
+// and ignore writes.  Images load at 0x0000 by default and start at their
+// load address.
+//
+// The profile is a Board (board.h) built from IsbcSpec(); a variant of it is
+// a different spec, not a different class.
+
+struct IsbcConfig {
+    I8251Config usart;
+
+    std::optional<ThrottleConfig> throttle;   // unset = run flat out
+};
+
+// The board description: devices "pic", "pit" and "usart" and the jumpers
+// above.
+BoardSpec IsbcSpec(const IsbcConfig& config = {});
+
+class Isbc {
+public:
+    static constexpr uint64_t CLOCK_HZ     = 2'048'000;
+    static constexpr uint64_t PIT_CLOCK_HZ = 1'228'800;
+
+    static constexpr int IRQ_TIMER0 = 2;
+    static constexpr int IRQ_TIMER1 = 3;
+    static constexpr int IRQ_RXRDY  = 6;
+    static constexpr int IRQ_TXRDY  = 7;
+
+    explicit Isbc(const IsbcConfig& config = {}) : board_(IsbcSpec(config)) {}
+
+    Isbc(const Isbc&)            = delete;
+    Isbc& operator=(const Isbc&) = delete;
+
+    // Load an image and point PC at it.  Throws std::runtime_error.
+    void load(const char* path, uint16_t addr = 0x0000)               { board_.load(path, addr); }
+    void load(const uint8_t* data, size_t size, uint16_t addr = 0x0000) { board_.load(data, size, addr); }
+
+    // Run until halted, limited or stopped; a program polling for console
+    // input after the input has ended stops with StopReason::Trap.
+    StopReason run(const RunLimits& limits = {}) { return board_.run(limits); }
+
+    I8251&   usart()   { return *board_.device<I8251>("usart"); }
+    I8253&   pit()     { return *board_.device<I8253>("pit"); }
+    I8259&   pic()     { return *board_.device<I8259>("pic"); }
+    Board&   board()   { return board_; }
+    Machine& machine() { return board_.machine(); }
+
+private:
+    Board board_;
+};
+
@@ -0,0 +1,138 @@
+#include "machine.h"
+#include "native8080.h"
+
+#include <cstring>
+#include <stdexcept>
+
+const char* Native8080Version() {
+    return NATIVE8080_VERSION;
+}
+
+Machine::Machine(const MachineConfig& config)
+    : cpm_(config.console), runner_(state_, io_) {
+    if (config.cpm) {
+        cpm_.capture_to(config.capture);
+        cpm_.setup(state_);
+        cpm_.attach(runner_);
+        state_.PC = CpmShim::TPA;
+    }
+    if (config.throttle) {
+        throttle_.emplace(*config.throttle);
+        runner_.set_throttle(&*throttle_);
+    }
+    runner_.set_slice_cycles(config.slice_cycles);
+}
+
+void Machine::load(const char* path, uint16_t addr) {
+    LoadBinary(state_, path, addr);
+}
+
+void Machine::load(const uint8_t* data, size_t size, uint16_t addr) {
+    if (size > size_t(0x10000 - addr))
+        throw std::runtime_error("Binary too large for memory at given offset");
+    std::memcpy(state_.mem.data() + addr, data, size);
+}
+
+StopReason Machine::run(const RunLimits& limits) {
+    return runner_.run(limits);
+}
+
+StopReason Machine::run_cycles(uint64_t cycles) {
+    RunLimits limits;
+    limits.max_cycles = cycles ? cycles : 1;
+    return runner_.run(limits);
+}
+
+void Machine::track_writes(unsigned depth) {
+    tracker_.reset();
+    writes_.reset();
+    if (depth) {
+        writes_.emplace(depth);
+        tracker_.emplace(runner_, *writes_);
+    }
+}
+
+MachineSnapshot Machine::snapshot() const {
+    return {state_, runner_.cycles(), runner_.instructions(), writes_};
+}
+
+void Machine::restore(const MachineSnapshot& snap) {
+    state_ = snap.cpu;
+    runner_.set_counters(snap.cycles, snap.instructions);
+    runner_.clear_interrupt();              // raised on the abandoned timeline
+    // Writes recorded after the snapshot would hide the re-executed ones.
+    if (writes_) {
+        if (snap.writes) *writes_ = *snap.writes;
+        else             writes_->clear();
+    }
+}
+
+// ─── Snapshot encoding ────────────────────────────────────────────────────────
+//   "N80S"  u32 version
+//   A F B C D E H L  u16 SP  u16 PC  u8 inte  u8 halted
+//   u64 cycles  u64 instructions  64 KB memory
+//   version 2:  u8 has_write_index  [write index, see WriteIndex::serialize]
+namespace {
+
+constexpr char     SNAPSHOT_MAGIC[4] = {'N', '8', '0', 'S'};
+constexpr uint32_t SNAPSHOT_VERSION  = 2;
+constexpr size_t   SNAPSHOT_SIZE     = 4 + 4 + 8 + 2 + 2 + 1 + 1 + 8 + 8 + 0x10000;   // version 1
+
+void put_le(std::vector<uint8_t>& out, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(uint8_t(v >> (8 * i)));
+}
+
+uint64_t get_le(const uint8_t*& p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) v |= uint64_t(*p++) << (8 * i);
+    return v;
+}
+
+} // namespace
+
+std::vector<uint8_t> SerializeSnapshot(const MachineSnapshot& snap) {
+    const State8080& s = snap.cpu;
+    std::vector<uint8_t> out;
+    out.reserve(SNAPSHOT_SIZE);
+    out.insert(out.end(), SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + 4);
+    put_le(out, SNAPSHOT_VERSION, 4);
+    for (uint8_t r : {s.A, s.F, s.B, s.C, s.D, s.E, s.H, s.L}) out.push_back(r);
+    put_le(out, s.SP, 2);
+    put_le(out, s.PC, 2);
+    out.push_back(s.inte);
+    out.push_back(s.halted);
+    put_le(out, snap.cycles, 8);
+    put_le(out, snap.instructions, 8);
+    out.insert(out.end(), s.mem.begin(), s.mem.end());
+    out.push_back(snap.writes ? 1 : 0);
+    if (snap.writes) snap.writes->serialize(out);
+    return out;
+}
+
+MachineSnapshot DeserializeSnapshot(const uint8_t* data, size_t size) {
+    if (size < SNAPSHOT_SIZE || std::memcmp(data, SNAPSHOT_MAGIC, 4) != 0)
+        throw std::runtime_error("Not a Native8080 snapshot");
+    const uint8_t* p   = data + 4;
+    const uint8_t* end = data + size;
+    const uint64_t version = get_le(p, 4);
+    if (version != 1 && version != SNAPSHOT_VERSION)
+        throw std::runtime_error("Unsupported snapshot version");
+    if (version == 1 ? size != SNAPSHOT_SIZE : size == SNAPSHOT_SIZE)
+        throw std::runtime_error("Truncated snapshot");
+
+    MachineSnapshot snap;
+    State8080& s = snap.cpu;
+    s.A = *p++; s.F = *p++; s.B = *p++; s.C = *p++;
+    s.D = *p++; s.E = *p++; s.H = *p++; s.L = *p++;
+    s.SP     = uint16_t(get_le(p, 2));
+    s.PC     = uint16_t(get_le(p, 2));
+    s.inte   = *p++ != 0;
+    s.halted = *p++ != 0;
+    snap.cycles       = get_le(p, 8);
+    snap.instructions = get_le(p, 8);
+    std::memcpy(s.mem.data(), p, s.mem.size());
+    p += s.mem.size();
+    if (version >= 2 && *p++) snap.writes = WriteIndex::deserialize(p, end);
+    if (p != end) throw std::runtime_error("Trailing data in snapshot");
+    return snap;
+}
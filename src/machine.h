@@ -0,0 +1,113 @@
+#pragma once
+#include "cpm.h"
+#include "cpu8080.h"
+#include "runner.h"
+#include "throttle.h"
+#include "writes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+// ─── Machine ──────────────────────────────────────────────────────────────────
+// One self-contained emulated system: CPU state and memory, I/O bus, run loop
+// and (optionally) the CP/M shim and real-time pacing.  This is the entry
+// point for embedding the core; the lower-level pieces (State8080, Runner,
+// CpmShim, Throttle) stay available through machine.runner() / state().
+//
+// A Machine holds 64 KB of memory inline, so allocate it on the heap
+// (std::make_unique<Machine>()) rather than on a small thread stack.
+
+struct MachineConfig {
+    bool         cpm     = false;        // install page-zero vectors and the BDOS trap
+    std::FILE*   console = stdout;       // CP/M console output (nullptr = none)
+    std::string* capture = nullptr;      // also append CP/M console output here
+
+    std::optional<ThrottleConfig> throttle;           // unset = run flat out
+    uint64_t slice_cycles = Runner::DEFAULT_SLICE_CYCLES;
+};
+
+// Complete architectural state plus the run counters, and the last-writer
+// index when the machine tracks writes.
+struct MachineSnapshot {
+    State8080 cpu;
+    uint64_t  cycles       = 0;
+    uint64_t  instructions = 0;
+    std::optional<WriteIndex> writes;
+};
+
+class Machine {
+public:
+    explicit Machine(const MachineConfig& config = {});
+
+    Machine(const Machine&)            = delete;
+    Machine& operator=(const Machine&) = delete;
+
+    // ── Memory ────────────────────────────────────────────────────────────────
+    // Both loaders throw std::runtime_error if the image does not fit.
+    void load(const char* path, uint16_t addr);
+    void load(const uint8_t* data, size_t size, uint16_t addr);
+
+    uint8_t peek(uint16_t addr) const        { return state_.mem[addr]; }
+    void    poke(uint16_t addr, uint8_t val) { state_.mem[addr] = val; }
+
+    // ── I/O ───────────────────────────────────────────────────────────────────
+    // Unset handlers read 0xFF and ignore writes.
+    void set_in_handler (std::function<uint8_t(uint8_t port)> fn)             { io_.in_handler  = std::move(fn); }
+    void set_out_handler(std::function<void(uint8_t port, uint8_t val)> fn)   { io_.out_handler = std::move(fn); }
+
+    // ── Execution ─────────────────────────────────────────────────────────────
+    // Run until halted, trapped, limited or stopped; see Runner::run().
+    StopReason run(const RunLimits& limits = {});
+
+    // Run for a budget of about `cycles` clock cycles (overshoot is at most
+    // one instruction).
+    StopReason run_cycles(uint64_t cycles);
+
+    // Thread- and signal-safe; honoured at the next slice boundary.
+    void request_stop() { runner_.request_stop(); }
+
+    uint64_t cycles()       const { return runner_.cycles(); }
+    uint64_t instructions() const { return runner_.instructions(); }
+
+    State8080&       state()       { return state_; }
+    const State8080& state() const { return state_; }
+    Runner&          runner()      { return runner_; }
+
+    // ── Write tracking ────────────────────────────────────────────────────────
+    // Record the last `depth` writers of every byte (0 turns tracking off and
+    // discards the index).  See writes.h for the cost.
+    void track_writes(unsigned depth);
+    const WriteIndex* write_index() const { return writes_ ? &*writes_ : nullptr; }
+
+    // ── Snapshots ─────────────────────────────────────────────────────────────
+    // A snapshot is the CPU, memory, counters and write index.  Restoring one
+    // drops a pending interrupt request, but leaves the runner's scheduler
+    // alone: events stay at the cycles they were due at, so whoever owns
+    // them reschedules them for the restored cycle count (Board::restore
+    // does this for its devices and timed interrupts).  Restoring a snapshot
+    // taken without a write index clears the index.
+    MachineSnapshot snapshot() const;
+    void            restore(const MachineSnapshot& snap);
+
+private:
+    State8080               state_;
+    IOBus                   io_;
+    CpmShim                 cpm_;
+    std::optional<Throttle> throttle_;
+    Runner                  runner_;
+    std::optional<WriteIndex>   writes_;
+    std::optional<WriteTracker> tracker_;
+};
+
+// ─── Snapshot files ───────────────────────────────────────────────────────────
+// Flat little-endian encoding with a magic and format version, suitable for
+// storing on disk or sending between processes; a write index is included
+// when present.  Deserialisation accepts the current and previous versions
+// and throws std::runtime_error on a truncated or foreign buffer.
+std::vector<uint8_t> SerializeSnapshot(const MachineSnapshot& snap);
+MachineSnapshot      DeserializeSnapshot(const uint8_t* data, size_t size);
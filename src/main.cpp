@@ -1,39 +1,33 @@
+#include "altair.h"
+#include "boardfile.h"
+#include "capture.h"
+#include "cpm.h"
 #include "cpu8080.h"
+#include "gdbstub.h"
+#include "invaders.h"
+#include "isbc.h"
+#include "probes.h"
+#include "runner.h"
+#include "throttle.h"
+#include "timeline.h"
+#include "writes.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
-// ─── CP/M BIOS hook ───────────────────────────────────────────────────────────
-// Inject a RET at address 0x0005 so CP/M programs that CALL 5 come back.
-// Before each step we intercept PC == 0x0005 with register C checked here.
-static bool cpm_bdos(State8080& s) {
-    if (s.PC != 0x0005) return false;
-
-    switch (s.C) {
-        case 2: {
-            // BDOS function 2: console character output (char in E)
-            std::putchar(s.E);
-            break;
-        }
-        case 9: {
-            // BDOS function 9: print string at DE, terminated by '$'
-            uint16_t addr = s.DE();
-            while (s.mem[addr] != '$') {
-                std::putchar(s.mem[addr++]);
-            }
-            std::putchar('\n');
-            break;
-        }
-        default:
-            // Other BDOS calls are silently ignored
-            break;
-    }
-
-    // Simulate RET: pop return address from stack
-    s.PC = s.pop16();
-    return true;
-}
+#include <termios.h>
+#include <unistd.h>
 
 // ─── I/O bus setup ────────────────────────────────────────────────────────────
 // Extend these handlers to wire real peripherals.
@@ -52,38 +46,540 @@ static IOBus make_io_bus() {
     return io;
 }
 
+// SIGINT/SIGTERM stop the run gracefully at the next slice boundary.
+static Runner* g_runner = nullptr;
+
+static void on_stop_signal(int) {
+    if (g_runner) g_runner->request_stop();
+}
+
+// ─── Breakpoints and tracepoints ──────────────────────────────────────────────
+using ProbeSpecs = std::vector<std::pair<ProbeSet::Kind, std::string>>;
+
+static bool add_probes(ProbeSet& probes, const ProbeSpecs& specs) {
+    for (const auto& [kind, spec] : specs) {
+        try {
+            probes.add(kind, spec);
+        } catch (const std::invalid_argument& e) {
+            std::fprintf(stderr, "Invalid --%s: %s\n", kind == ProbeSet::Kind::Break ? "break" : "trace", e.what());
+            return false;
+        }
+    }
+    return true;
+}
+
+static void report_break(const ProbeSet& probes, StopReason reason) {
+    if (const ProbeSet::Probe* hit = probes.last_break(); hit && reason == StopReason::Trap)
+        std::fprintf(stderr, "\nNative8080: breakpoint at 0x%04X%s%s (hit %llu)\n", hit->pc,
+                     hit->cond.always() ? "" : " if ", hit->cond.text().c_str(),
+                     static_cast<unsigned long long>(hit->hits));
+}
+
+// ─── Debugger ─────────────────────────────────────────────────────────────────
+// Serve a GDB session; if the debugger detaches, the program runs on
+// undebugged.  With a history budget the session can also execute in
+// reverse.  Returns nothing if the transport could not be set up.
+static std::optional<StopReason> debug_session(const char* spec, State8080& state, Runner& runner,
+                                                IOBus& io, CpmShim& cpm, size_t history_bytes,
+                                                const WriteIndex* writes, const RunLimits& limits) {
+    StopReason reason;
+    GdbStub::Outcome outcome;
+    {
+        std::optional<Timeline> timeline;
+        GdbStub stub(state, runner);
+        stub.set_write_index(writes);
+        if (history_bytes) {
+            TimelineConfig config;
+            config.budget_bytes = history_bytes;
+            timeline.emplace(state, runner, io, config);
+            timeline->set_replay_hook([&cpm](bool replaying) { cpm.mute(replaying); });
+            stub.set_timeline(&*timeline);
+        }
+        if (std::strcmp(spec, "pty") == 0) {
+            std::string name;
+            if (!stub.open_pty(&name)) return std::nullopt;
+            std::fprintf(stderr, "Native8080: GDB stub on %s (target remote %s)\n", name.c_str(), name.c_str());
+        } else {
+            if (!stub.listen_unix(spec + 5)) return std::nullopt;
+            std::fprintf(stderr, "Native8080: GDB stub waiting on %s\n", spec + 5);
+        }
+        outcome = stub.serve();
+        reason  = stub.last_reason();
+    }
+    switch (outcome) {
+        case GdbStub::Outcome::Detached: return runner.run(limits);
+        case GdbStub::Outcome::Killed:   return StopReason::StopRequested;
+        case GdbStub::Outcome::Exited:   return reason;
+    }
+    return reason;
+}
+
+// ─── Space Invaders ───────────────────────────────────────────────────────────
+// Run the board headless for `frames` frames (0 = until stopped) and report
+// the frame rate, optionally capturing frames to image files.  Completing
+// the frames counts as a normal exit.
+static int run_invaders(const char* rom, uint64_t frames, const std::optional<ThrottleConfig>& pacing,
+                        double max_seconds, const ProbeSpecs& probe_specs,
+                        const std::optional<CaptureConfig>& capture_config) {
+    using clock = std::chrono::steady_clock;
+
+    InvadersConfig config;
+    config.throttle = pacing;
+    auto inv = std::make_unique<Invaders>(config);
+    try {
+        inv->load_rom(rom);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Load error: %s\n", e.what());
+        return 1;
+    }
+    Runner& runner = inv->machine().runner();
+    ProbeSet probes(runner);
+    if (!add_probes(probes, probe_specs)) return 1;
+
+    std::optional<FrameCapture> capture;
+    if (capture_config) {
+        try {
+            capture.emplace(*capture_config);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "Capture error: %s\n", e.what());
+            return 1;
+        }
+    }
+    Framebuffer fb;
+
+    std::fprintf(stderr, "Native8080: Space Invaders board, ROM '%s', %s...\n", rom,
+                 pacing ? "real time" : "unthrottled");
+    g_runner = &runner;
+    std::signal(SIGINT,  on_stop_signal);
+    std::signal(SIGTERM, on_stop_signal);
+
+    const auto started = clock::now();
+    double seconds = 0.0;
+    StopReason reason = StopReason::CycleLimit;
+    while (!frames || inv->frames() < frames) {
+        reason = inv->run_frames(1);
+        if (capture && capture->due(inv->frames())) {
+            inv->render(fb);
+            capture->submit(inv->frames(), fb);
+        }
+        seconds = std::chrono::duration<double>(clock::now() - started).count();
+        if (reason != StopReason::CycleLimit) break;
+        if (max_seconds > 0.0 && seconds >= max_seconds) { reason = StopReason::TimeLimit; break; }
+    }
+    g_runner = nullptr;
+
+    report_break(probes, reason);
+    std::fprintf(stderr, "\nNative8080: CPU stopped (%s). PC=0x%04X cycles=%llu instructions=%llu\n",
+                 reason == StopReason::CycleLimit ? "frames done" : StopReasonName(reason),
+                 inv->machine().state().PC,
+                 static_cast<unsigned long long>(runner.cycles()),
+                 static_cast<unsigned long long>(runner.instructions()));
+    std::fprintf(stderr, "Native8080: %llu frames in %.3f s (%.1f fps, %.1f MIPS)\n",
+                 static_cast<unsigned long long>(inv->frames()), seconds,
+                 seconds > 0.0 ? inv->frames() / seconds : 0.0,
+                 seconds > 0.0 ? runner.instructions() / seconds / 1e6 : 0.0);
+    if (capture) {
+        capture->flush();
+        const CaptureStats st = capture->stats();
+        std::fprintf(stderr, "Native8080: captured %llu frames (%llu KiB), %llu duplicates skipped",
+                     static_cast<unsigned long long>(st.written), static_cast<unsigned long long>(st.bytes / 1024),
+                     static_cast<unsigned long long>(st.duplicates));
+        if (st.dropped) std::fprintf(stderr, ", %llu dropped (encoder behind)", static_cast<unsigned long long>(st.dropped));
+        if (st.errors)  std::fprintf(stderr, ", %llu write errors", static_cast<unsigned long long>(st.errors));
+        std::fprintf(stderr, "\n");
+    }
+    return reason == StopReason::CycleLimit ? 0 : StopReasonExitStatus(reason);
+}
+
+// ─── Altair 8800 ──────────────────────────────────────────────────────────────
+// Puts a terminal on standard input into character-at-a-time mode without
+// local echo for the lifetime of the object, since the guest echoes what it
+// reads.  Signals stay enabled, so Ctrl-C still stops the run.
+class RawConsole {
+public:
+    RawConsole() {
+        if (!::isatty(0) || ::tcgetattr(0, &saved_) != 0) return;
+        termios raw = saved_;
+        raw.c_lflag &= tcflag_t(~(ICANON | ECHO));
+        raw.c_cc[VMIN]  = 1;
+        raw.c_cc[VTIME] = 0;
+        active_ = ::tcsetattr(0, TCSANOW, &raw) == 0;
+    }
+    ~RawConsole() {
+        if (active_) ::tcsetattr(0, TCSANOW, &saved_);
+    }
+    RawConsole(const RawConsole&)            = delete;
+    RawConsole& operator=(const RawConsole&) = delete;
+
+private:
+    termios saved_{};
+    bool    active_ = false;
+};
+
+// Run an image on the Altair with the 2SIO console on stdin/stdout.  A
+// program left waiting for input after stdin has ended counts as finished.
+static int run_altair(const char* image, uint16_t addr, uint8_t sense, const std::optional<ThrottleConfig>& pacing,
+                      const RunLimits& limits, const ProbeSpecs& probe_specs) {
+    AltairConfig config;
+    config.sense    = sense;
+    config.throttle = pacing;
+    auto altair = std::make_unique<Altair>(config);
+    try {
+        altair->load(image, addr);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Load error: %s\n", e.what());
+        return 1;
+    }
+    Runner& runner = altair->machine().runner();
+    ProbeSet probes(runner);
+    if (!add_probes(probes, probe_specs)) return 1;
+
+    std::fprintf(stderr, "Native8080: Altair 8800, '%s' at 0x%04X, %s...\n", image, addr,
+                 pacing ? "real time" : "unthrottled");
+    g_runner = &runner;
+    std::signal(SIGINT,  on_stop_signal);
+    std::signal(SIGTERM, on_stop_signal);
+
+    const auto started = std::chrono::steady_clock::now();
+    StopReason reason;
+    {
+        RawConsole console;
+        reason = altair->run(limits);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    g_runner = nullptr;
+
+    const Sio2::Stats io = altair->sio().stats();
+    report_break(probes, reason);
+    std::fprintf(stderr, "\nNative8080: CPU stopped (%s). PC=0x%04X cycles=%llu instructions=%llu\n",
+                 altair->sio().input_exhausted() ? "input ended" : StopReasonName(reason),
+                 altair->machine().state().PC,
+                 static_cast<unsigned long long>(runner.cycles()),
+                 static_cast<unsigned long long>(runner.instructions()));
+    std::fprintf(stderr, "Native8080: 2SIO %llu bytes in, %llu bytes out in %llu writes, "
+                 "%llu status reads, %llu idle slices; %.1f MIPS\n",
+                 static_cast<unsigned long long>(io.bytes_in), static_cast<unsigned long long>(io.bytes_out),
+                 static_cast<unsigned long long>(io.writes), static_cast<unsigned long long>(io.status_reads),
+                 static_cast<unsigned long long>(io.idles),
+                 seconds > 0.0 ? runner.instructions() / seconds / 1e6 : 0.0);
+    if (io.dropped)
+        std::fprintf(stderr, "Native8080: 2SIO dropped %llu bytes sent while the transmitter was busy\n",
+                     static_cast<unsigned long long>(io.dropped));
+    return StopReasonExitStatus(reason);
+}
+
+// ─── iSBC ─────────────────────────────────────────────────────────────────────
+// Run an image on the iSBC board with the 8251 console on stdin/stdout.
+static int run_isbc(const char* image, uint16_t addr, const std::optional<ThrottleConfig>& pacing,
+                    const RunLimits& limits, const ProbeSpecs& probe_specs) {
+    IsbcConfig config;
+    config.throttle = pacing;
+    auto board = std::make_unique<Isbc>(config);
+    try {
+        board->load(image, addr);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Load error: %s\n", e.what());
+        return 1;
+    }
+    Runner& runner = board->machine().runner();
+    ProbeSet probes(runner);
+    if (!add_probes(probes, probe_specs)) return 1;
+
+    std::fprintf(stderr, "Native8080: iSBC, '%s' at 0x%04X, %s...\n", image, addr,
+                 pacing ? "real time" : "unthrottled");
+    g_runner = &runner;
+    std::signal(SIGINT,  on_stop_signal);
+    std::signal(SIGTERM, on_stop_signal);
+
+    const auto started = std::chrono::steady_clock::now();
+    StopReason reason;
+    {
+        RawConsole console;
+        reason = board->run(limits);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    g_runner = nullptr;
+
+    const I8251::Stats io = board->usart().stats();
+    report_break(probes, reason);
+    std::fprintf(stderr, "\nNative8080: CPU stopped (%s). PC=0x%04X cycles=%llu instructions=%llu\n",
+                 board->usart().input_exhausted() ? "input ended" : StopReasonName(reason),
+                 board->machine().state().PC,
+                 static_cast<unsigned long long>(runner.cycles()),
+                 static_cast<unsigned long long>(runner.instructions()));
+    std::fprintf(stderr, "Native8080: 8251 %llu bytes in, %llu bytes out in %llu writes, "
+                 "%llu status reads; 8259 IMR %02X ISR %02X; %.1f MIPS\n",
+                 static_cast<unsigned long long>(io.bytes_in), static_cast<unsigned long long>(io.bytes_out),
+                 static_cast<unsigned long long>(io.writes), static_cast<unsigned long long>(io.status_reads),
+                 board->pic().imr(), board->pic().isr(),
+                 seconds > 0.0 ? runner.instructions() / seconds / 1e6 : 0.0);
+    if (io.dropped)
+        std::fprintf(stderr, "Native8080: 8251 dropped %llu bytes sent while the transmitter was busy\n",
+                     static_cast<unsigned long long>(io.dropped));
+    return StopReasonExitStatus(reason);
+}
+
+// ─── Board description ────────────────────────────────────────────────────────
+// Build the board a description file gives, with serial devices on
+// stdin/stdout, and run an image on it (or just its ROMs).  --clock
+// overrides the description's pacing.
+static int run_board(const char* file, const char* image, std::optional<uint16_t> addr,
+                     std::optional<ThrottleConfig> pacing, uint32_t slice_us,
+                     const RunLimits& limits, const ProbeSpecs& probe_specs) {
+    std::unique_ptr<::Board> board;
+    BoardSpec spec;
+    try {
+        spec = LoadBoardFile(file);
+        if (pacing) spec.throttle = pacing;
+        if (spec.throttle) spec.throttle->slice_us = slice_us;
+        board = std::make_unique<::Board>(spec);
+        if (image) board->load(image, addr.value_or(spec.load));
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Board error: %s\n", e.what());
+        return 1;
+    }
+    Runner& runner = board->machine().runner();
+    ProbeSet probes(runner);
+    if (!add_probes(probes, probe_specs)) return 1;
+
+    std::fprintf(stderr, "Native8080: %s (%zu devices)", spec.name.empty() ? file : spec.name.c_str(),
+                 spec.devices.size());
+    if (image) std::fprintf(stderr, ", '%s' at 0x%04X", image, addr.value_or(spec.load));
+    std::fprintf(stderr, ", %s...\n", spec.throttle ? "real time" : "unthrottled");
+    g_runner = &runner;
+    std::signal(SIGINT,  on_stop_signal);
+    std::signal(SIGTERM, on_stop_signal);
+
+    const auto started = std::chrono::steady_clock::now();
+    StopReason reason;
+    {
+        RawConsole console;
+        reason = board->run(limits);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    g_runner = nullptr;
+
+    report_break(probes, reason);
+    std::fprintf(stderr, "\nNative8080: CPU stopped (%s). PC=0x%04X cycles=%llu instructions=%llu; %.1f MIPS\n",
+                 StopReasonName(reason), board->machine().state().PC,
+                 static_cast<unsigned long long>(runner.cycles()),
+                 static_cast<unsigned long long>(runner.instructions()),
+                 seconds > 0.0 ? runner.instructions() / seconds / 1e6 : 0.0);
+    return StopReasonExitStatus(reason);
+}
+
+// ─── Command line ─────────────────────────────────────────────────────────────
+static void usage(const char* argv0) {
+    std::fprintf(stderr, "Usage: %s [options] <program.com> [load_offset_hex]\n", argv0);
+    std::fprintf(stderr, "       %s --machine invaders [options] <rom>\n", argv0);
+    std::fprintf(stderr, "       %s --machine altair|isbc [options] <image> [load_offset_hex]\n", argv0);
+    std::fprintf(stderr, "       %s --board FILE [options] [<image> [load_offset_hex]]\n", argv0);
+    std::fprintf(stderr, "  load_offset_hex defaults to 0100 (standard CP/M load address), 0000 for altair and isbc\n");
+    std::fprintf(stderr, "  rom: an 8 KB image or a directory with invaders.h/.g/.f/.e\n");
+    std::fprintf(stderr, "Options:\n");
+    std::fprintf(stderr, "  --machine cpm|invaders|altair|isbc  board to emulate (default cpm)\n");
+    std::fprintf(stderr, "  --board FILE    board from a description file (see boards/); the image is optional\n");
+    std::fprintf(stderr, "  --sense HEX     altair: front-panel sense switches read by IN 0FFh (default 00)\n");
+    std::fprintf(stderr, "  --frames N      invaders: stop after N video frames (default: run until stopped)\n");
+    std::fprintf(stderr, "  --capture PATTERN       invaders: write frames to PATTERN (.png or .ppm; '###' = frame number)\n");
+    std::fprintf(stderr, "  --capture-every N       capture every N-th frame (default 1)\n");
+    std::fprintf(stderr, "  --capture-from N        first frame to capture (frames count from 1)\n");
+    std::fprintf(stderr, "  --capture-dedup on|off  write repeated identical frames once (default on)\n");
+    std::fprintf(stderr, "  --capture-manifest FILE list every captured frame as 'FRAME HASH FILE'\n");
+    std::fprintf(stderr, "  --clock MHZ     pace execution to MHZ (e.g. 2 for a stock 8080); default: unthrottled\n");
+    std::fprintf(stderr, "  --slice US      emulated microseconds per pacing slice (default 1000)\n");
+    std::fprintf(stderr, "  --max-cycles N        stop after N clock cycles (exit status 2)\n");
+    std::fprintf(stderr, "  --max-instructions N  stop after N instructions (exit status 3)\n");
+    std::fprintf(stderr, "  --max-time SECONDS    stop after SECONDS of wall time (exit status 4)\n");
+    std::fprintf(stderr, "  --gdb unix:PATH | pty wait for a GDB remote session before running\n");
+    std::fprintf(stderr, "  --history MB          with --gdb: keep MB of checkpoints for reverse execution\n");
+    std::fprintf(stderr, "  --track-writes DEPTH  record the last DEPTH (1-16) writers of every byte\n");
+    std::fprintf(stderr, "  --dump-writes FILE    with --track-writes: write the index to FILE at exit\n");
+    std::fprintf(stderr, "  --break 'ADDR[ if EXPR]'  stop when ADDR is reached and EXPR holds (repeatable)\n");
+    std::fprintf(stderr, "  --trace 'ADDR[ if EXPR]'  log registers when ADDR is reached and EXPR holds\n");
+    std::fprintf(stderr, "  EXPR: C-style over registers, flags and [mem], e.g. 'HL == 0x2400 && CY'\n");
+    std::fprintf(stderr, "SIGINT/SIGTERM stop the run with exit status 5.\n");
+}
+
 // ─── Main ─────────────────────────────────────────────────────────────────────
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::fprintf(stderr, "Usage: %s <program.com> [load_offset_hex]\n", argv[0]);
-        std::fprintf(stderr, "  load_offset_hex defaults to 0100 (standard CP/M load address)\n");
+    std::optional<ThrottleConfig> pacing;
+    uint32_t slice_us = ThrottleConfig{}.slice_us;
+    RunLimits limits;
+    const char* gdb = nullptr;
+    size_t history_bytes = 0;
+    unsigned write_depth = 0;
+    const char* dump_writes = nullptr;
+    ProbeSpecs probe_specs;
+    enum class Board { Cpm, Invaders, Altair, Isbc } board = Board::Cpm;
+    std::optional<uint8_t> sense;
+    const char* board_file = nullptr;
+    uint64_t frames = 0;
+    std::optional<CaptureConfig> capture;
+    auto capture_option = [&]() -> CaptureConfig& {
+        if (!capture) capture.emplace();
+        return *capture;
+    };
+
+    // Options come first; the remaining arguments are positional.
+    int argi = 1;
+    for (; argi < argc && std::strncmp(argv[argi], "--", 2) == 0; ++argi) {
+        const char* opt = argv[argi];
+        if (argi + 1 >= argc) { usage(argv[0]); return 1; }
+        const char* val = argv[++argi];
+        if (std::strcmp(opt, "--clock") == 0) {
+            // At least 1 Hz (a zero clock cannot be paced), and NaN or
+            // anything too large to count in cycles is refused too.
+            const double hz = std::strtod(val, nullptr) * 1e6;
+            if (!(hz >= 1.0 && hz <= 1e15)) { std::fprintf(stderr, "Invalid --clock value: %s\n", val); return 1; }
+            pacing = ThrottleConfig{};
+            pacing->clock_hz = static_cast<uint64_t>(hz);
+        } else if (std::strcmp(opt, "--slice") == 0) {
+            slice_us = static_cast<uint32_t>(std::strtoul(val, nullptr, 10));
+            if (slice_us == 0) { std::fprintf(stderr, "Invalid --slice value: %s\n", val); return 1; }
+        } else if (std::strcmp(opt, "--max-cycles") == 0) {
+            limits.max_cycles = std::strtoull(val, nullptr, 0);
+        } else if (std::strcmp(opt, "--max-instructions") == 0) {
+            limits.max_instructions = std::strtoull(val, nullptr, 0);
+        } else if (std::strcmp(opt, "--max-time") == 0) {
+            limits.max_seconds = std::strtod(val, nullptr);
+        } else if (std::strcmp(opt, "--machine") == 0) {
+            if (std::strcmp(val, "invaders") == 0) {
+                board = Board::Invaders;
+            } else if (std::strcmp(val, "altair") == 0) {
+                board = Board::Altair;
+            } else if (std::strcmp(val, "isbc") == 0) {
+                board = Board::Isbc;
+            } else if (std::strcmp(val, "cpm") == 0) {
+                board = Board::Cpm;
+            } else {
+                std::fprintf(stderr, "Unknown machine: %s (expected cpm, invaders, altair or isbc)\n", val);
+                return 1;
+            }
+        } else if (std::strcmp(opt, "--board") == 0) {
+            board_file = val;
+        } else if (std::strcmp(opt, "--sense") == 0) {
+            sense = static_cast<uint8_t>(std::strtoul(val, nullptr, 16));
+        } else if (std::strcmp(opt, "--frames") == 0) {
+            frames = std::strtoull(val, nullptr, 0);
+        } else if (std::strcmp(opt, "--capture") == 0) {
+            capture_option().pattern = val;
+        } else if (std::strcmp(opt, "--capture-every") == 0) {
+            capture_option().interval = std::max<uint64_t>(1, std::strtoull(val, nullptr, 0));
+        } else if (std::strcmp(opt, "--capture-from") == 0) {
+            capture_option().first = std::strtoull(val, nullptr, 0);
+        } else if (std::strcmp(opt, "--capture-dedup") == 0) {
+            capture_option().dedup = std::strcmp(val, "off") != 0;
+        } else if (std::strcmp(opt, "--capture-manifest") == 0) {
+            capture_option().manifest = val;
+        } else if (std::strcmp(opt, "--gdb") == 0) {
+            if (std::strcmp(val, "pty") != 0 && std::strncmp(val, "unix:", 5) != 0) {
+                std::fprintf(stderr, "Invalid --gdb value: %s (expected unix:PATH or pty)\n", val);
+                return 1;
+            }
+            gdb = val;
+        } else if (std::strcmp(opt, "--history") == 0) {
+            double mb = std::strtod(val, nullptr);
+            if (mb <= 0.0) { std::fprintf(stderr, "Invalid --history value: %s\n", val); return 1; }
+            history_bytes = static_cast<size_t>(mb * 1048576.0);
+        } else if (std::strcmp(opt, "--track-writes") == 0) {
+            write_depth = static_cast<unsigned>(std::strtoul(val, nullptr, 10));
+            if (write_depth < 1 || write_depth > WriteIndex::MAX_DEPTH) {
+                std::fprintf(stderr, "Invalid --track-writes value: %s (expected 1-%u)\n", val, WriteIndex::MAX_DEPTH);
+                return 1;
+            }
+        } else if (std::strcmp(opt, "--dump-writes") == 0) {
+            dump_writes = val;
+        } else if (std::strcmp(opt, "--break") == 0) {
+            probe_specs.emplace_back(ProbeSet::Kind::Break, val);
+        } else if (std::strcmp(opt, "--trace") == 0) {
+            probe_specs.emplace_back(ProbeSet::Kind::Trace, val);
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", opt);
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (argi >= argc && !board_file) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (history_bytes && !gdb) {
+        std::fprintf(stderr, "--history needs --gdb\n");
         return 1;
     }
+    if (dump_writes && !write_depth) {
+        std::fprintf(stderr, "--dump-writes needs --track-writes\n");
+        return 1;
+    }
+    if (gdb && !probe_specs.empty()) {
+        std::fprintf(stderr, "--break/--trace cannot be combined with --gdb; use 'monitor cond' instead\n");
+        return 1;
+    }
+    if (board_file) {
+        if (board != Board::Cpm || sense || frames || capture || gdb || write_depth) {
+            std::fprintf(stderr, "--board cannot be combined with --machine, --sense, --frames, --capture, "
+                         "--gdb or --track-writes\n");
+            return 1;
+        }
+        const char* image = argi < argc ? argv[argi++] : nullptr;
+        std::optional<uint16_t> addr;
+        if (argi < argc) addr = static_cast<uint16_t>(std::strtoul(argv[argi], nullptr, 16));
+        return run_board(board_file, image, addr, pacing, slice_us, limits, probe_specs);
+    }
+    const char* program = argv[argi++];
 
-    // Optional second argument: hex load offset (default 0x0100 for CP/M .COM)
-    uint16_t load_offset = 0x0100;
-    if (argc >= 3) {
-        load_offset = static_cast<uint16_t>(std::strtoul(argv[2], nullptr, 16));
+    if (board == Board::Invaders) {
+        if (sense || gdb || write_depth || limits.max_cycles || limits.max_instructions || argi < argc) {
+            std::fprintf(stderr, "--machine invaders supports --frames, --clock, --slice, --max-time, --break and --trace\n");
+            return 1;
+        }
+        if (pacing) pacing->slice_us = slice_us;
+        return run_invaders(program, frames, pacing, limits.max_seconds, probe_specs, capture);
+    }
+    if (frames || capture) {
+        std::fprintf(stderr, "--frames and --capture need --machine invaders\n");
+        return 1;
+    }
+    if (board == Board::Altair) {
+        if (gdb || write_depth) {
+            std::fprintf(stderr, "--machine altair does not support --gdb or --track-writes\n");
+            return 1;
+        }
+        if (pacing) pacing->slice_us = slice_us;
+        const uint16_t addr = argi < argc ? static_cast<uint16_t>(std::strtoul(argv[argi], nullptr, 16)) : 0x0000;
+        return run_altair(program, addr, sense.value_or(0x00), pacing, limits, probe_specs);
+    }
+    if (sense) {
+        std::fprintf(stderr, "--sense needs --machine altair\n");
+        return 1;
+    }
+    if (board == Board::Isbc) {
+        if (gdb || write_depth) {
+            std::fprintf(stderr, "--machine isbc does not support --gdb or --track-writes\n");
+            return 1;
+        }
+        if (pacing) pacing->slice_us = slice_us;
+        const uint16_t addr = argi < argc ? static_cast<uint16_t>(std::strtoul(argv[argi], nullptr, 16)) : 0x0000;
+        return run_isbc(program, addr, pacing, limits, probe_specs);
+    }
+
+    // Optional positional argument: hex load offset (default 0x0100 for CP/M .COM)
+    uint16_t load_offset = CpmShim::TPA;
+    if (argi < argc) {
+        load_offset = static_cast<uint16_t>(std::strtoul(argv[argi], nullptr, 16));
     }
 
     State8080 state;
     IOBus     io = make_io_bus();
 
     // ── CP/M compatibility setup ──────────────────────────────────────────────
-    // Warm-boot vector: CALL 0x0000 at the start of the CP/M stack area
-    // Place a HLT at 0x0000 so reaching it terminates cleanly
-    state.mem[0x0000] = 0x76;   // HLT  — fall-through safety
-
-    // 0x0005 must be reachable as a CALL target for BDOS; we'll intercept
-    // it via cpm_bdos() before the CPU sees it.  Put a RET there anyway so
-    // a raw (unhooked) call still returns gracefully.
-    state.mem[0x0005] = 0xC9;   // RET
-
-    // Set CP/M default stack (just below the 64-KB top)
-    state.SP = 0xF000;
+    CpmShim cpm;
+    cpm.setup(state);
 
     try {
-        LoadBinary(state, argv[1], load_offset);
+        LoadBinary(state, program, load_offset);
     } catch (const std::exception& e) {
         std::fprintf(stderr, "Load error: %s\n", e.what());
         return 1;
@@ -92,20 +588,72 @@ int main(int argc, char* argv[]) {
     // Start execution at the CP/M program load address
     state.PC = load_offset;
 
-    std::fprintf(stderr, "Native8080: loaded '%s' at 0x%04X, running...\n",
-                 argv[1], load_offset);
+    std::optional<Throttle> throttle;
+    if (pacing) {
+        pacing->slice_us = slice_us;
+        throttle.emplace(*pacing);
+    }
+
+    std::fprintf(stderr, "Native8080: loaded '%s' at 0x%04X, running", program, load_offset);
+    if (throttle)
+        std::fprintf(stderr, " at %.3f MHz...\n", pacing->clock_hz / 1e6);
+    else
+        std::fprintf(stderr, "...\n");
 
     // ── Main execution loop ───────────────────────────────────────────────────
-    for (;;) {
-        // CP/M BDOS hook — intercept before fetch
-        if (cpm_bdos(state)) continue;
+    Runner runner(state, io);
+    cpm.attach(runner);
+    if (throttle) runner.set_throttle(&*throttle);
+
+    std::optional<WriteIndex>   writes;
+    std::optional<WriteTracker> tracker;
+    if (write_depth) {
+        writes.emplace(write_depth);
+        tracker.emplace(runner, *writes);
+    }
+
+    ProbeSet probes(runner);
+    if (!add_probes(probes, probe_specs)) return 1;
 
-        // Exit on HALT or when PC wraps to 0x0000 (warm-boot)
-        if (state.halted || state.PC == 0x0000) break;
+    g_runner = &runner;
+    std::signal(SIGINT,  on_stop_signal);
+    std::signal(SIGTERM, on_stop_signal);
 
-        Step8080(state, io);
+    const auto started = std::chrono::steady_clock::now();
+    StopReason reason;
+    if (gdb) {
+        std::optional<StopReason> debugged = debug_session(gdb, state, runner, io, cpm, history_bytes,
+                                                           writes ? &*writes : nullptr, limits);
+        if (!debugged) return 1;
+        reason = *debugged;
+    } else {
+        reason = runner.run(limits);
     }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    g_runner = nullptr;
+
+    report_break(probes, reason);
+    std::fprintf(stderr, "\nNative8080: CPU stopped (%s). PC=0x%04X cycles=%llu instructions=%llu\n",
+                 StopReasonName(reason), state.PC,
+                 static_cast<unsigned long long>(runner.cycles()),
+                 static_cast<unsigned long long>(runner.instructions()));
 
-    std::fprintf(stderr, "\nNative8080: CPU halted. PC=0x%04X\n", state.PC);
-    return 0;
+    // Tracking slows the run down; report what it recorded and at what speed.
+    if (writes) {
+        std::fprintf(stderr, "Native8080: tracked %llu writes (depth %u, %zu KiB index) at %.1f MIPS\n",
+                     static_cast<unsigned long long>(writes->writes()), writes->depth(),
+                     writes->memory_bytes() / 1024,
+                     seconds > 0.0 ? runner.instructions() / seconds / 1e6 : 0.0);
+        if (dump_writes) {
+            std::FILE* out = std::fopen(dump_writes, "w");
+            if (!out) {
+                std::fprintf(stderr, "Cannot write %s: %s\n", dump_writes, std::strerror(errno));
+                return 1;
+            }
+            writes->dump(out);
+            std::fclose(out);
+        }
+    }
+    return StopReasonExitStatus(reason);
 }
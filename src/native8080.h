@@ -0,0 +1,29 @@
+#pragma once
+// ─── Native8080 public API ────────────────────────────────────────────────────
+// Umbrella header for programs linking the native8080_core library:
+//
+//     find_package(Native8080 2.0 REQUIRED)
+//     target_link_libraries(app PRIVATE Native8080::core)
+//
+//     #include <native8080.h>
+//
+// These headers are the installed, versioned API: Machine and what it is
+// built from.  The rest of src/ (devices, boards, translated programs, the
+// constexpr interpreter, the debugger) is internal and may change in any
+// release; it is only on the include path of the build tree.
+//
+// NATIVE8080_VERSION_{MAJOR,MINOR,PATCH} give the version of these headers;
+// Native8080Version() returns the version of the library actually linked.
+
+#include "native8080_version.h"
+
+#include "cpm.h"
+#include "cpu8080.h"
+#include "machine.h"
+#include "runner.h"
+#include "scheduler.h"
+#include "throttle.h"
+#include "writes.h"
+
+// "MAJOR.MINOR.PATCH" of the linked library.
+const char* Native8080Version();
@@ -0,0 +1,263 @@
+#include "predicate.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace {
+
+enum Op : uint8_t {
+    PushConst,      // u16 immediate
+    PushReg8,       // u8 index: A B C D E H L F
+    PushPair,       // u8 index: BC DE HL SP PC PSW
+    PushFlag,       // u8 flag mask
+    Load8, Load16,
+    Neg, Not, BitNot,
+    Add, Sub,
+    Lt, Le, Gt, Ge, Eq, Ne,
+    BitAnd, BitXor, BitOr,
+    LogAnd, LogOr,
+};
+
+struct Name {
+    const char* name;
+    Op          op;
+    uint8_t     arg;
+};
+
+const Name NAMES[] = {
+    {"A",  PushReg8, 0}, {"B",  PushReg8, 1}, {"C",  PushReg8, 2}, {"D",  PushReg8, 3},
+    {"E",  PushReg8, 4}, {"H",  PushReg8, 5}, {"L",  PushReg8, 6}, {"F",  PushReg8, 7},
+    {"BC", PushPair, 0}, {"DE", PushPair, 1}, {"HL", PushPair, 2}, {"SP", PushPair, 3},
+    {"PC", PushPair, 4}, {"PSW", PushPair, 5},
+    {"CY", PushFlag, FLAG_CY}, {"Z", PushFlag, FLAG_Z}, {"S", PushFlag, FLAG_S},
+    {"P",  PushFlag, FLAG_P},  {"AC", PushFlag, FLAG_AC},
+};
+
+} // namespace
+
+// ─── Compiler ─────────────────────────────────────────────────────────────────
+// Recursive descent straight to bytecode, tracking the stack depth so that
+// evaluation can use a fixed-size array.
+class PredicateCompiler {
+public:
+    explicit PredicateCompiler(const std::string& text) : t_(text) {}
+
+    Predicate run() {
+        Predicate p;
+        p.text_ = t_;
+        out_ = &p.code_;
+        logical_or();
+        skip_ws();
+        if (pos_ != t_.size()) fail("unexpected character");
+        return p;
+    }
+
+private:
+    [[noreturn]] void fail(const char* what) const {
+        throw std::invalid_argument(std::string(what) + " at column " + std::to_string(pos_ + 1) +
+                                    " in '" + t_ + "'");
+    }
+
+    void skip_ws() { while (pos_ < t_.size() && std::isspace(static_cast<unsigned char>(t_[pos_]))) ++pos_; }
+
+    bool eat(const char* tok) {
+        skip_ws();
+        size_t n = std::char_traits<char>::length(tok);
+        if (t_.compare(pos_, n, tok) != 0) return false;
+        // Don't split "&&" into "&" "&", "<=" into "<" "=", etc.
+        if (n == 1 && pos_ + 1 < t_.size()) {
+            char next = t_[pos_ + 1];
+            if ((tok[0] == '&' && next == '&') || (tok[0] == '|' && next == '|') ||
+                ((tok[0] == '<' || tok[0] == '>' || tok[0] == '!' || tok[0] == '=') && next == '='))
+                return false;
+        }
+        pos_ += n;
+        return true;
+    }
+
+    void emit(uint8_t op, int push) {
+        out_->push_back(op);
+        depth_ += push;
+        if (depth_ > Predicate::MAX_DEPTH) fail("expression too deeply nested");
+    }
+
+    void binary(uint8_t op) { emit(op, -1); }
+
+    void logical_or()  { logical_and(); while (eat("||")) { logical_and(); binary(LogOr); } }
+    void logical_and() { bit_or();      while (eat("&&")) { bit_or();      binary(LogAnd); } }
+    void bit_or()      { bit_xor();     while (eat("|"))  { bit_xor();     binary(BitOr); } }
+    void bit_xor()     { bit_and();     while (eat("^"))  { bit_and();     binary(BitXor); } }
+    void bit_and()     { equality();    while (eat("&"))  { equality();    binary(BitAnd); } }
+
+    void equality() {
+        relational();
+        for (;;) {
+            if      (eat("==")) { relational(); binary(Eq); }
+            else if (eat("!=")) { relational(); binary(Ne); }
+            else return;
+        }
+    }
+
+    void relational() {
+        additive();
+        for (;;) {
+            if      (eat("<=")) { additive(); binary(Le); }
+            else if (eat(">=")) { additive(); binary(Ge); }
+            else if (eat("<"))  { additive(); binary(Lt); }
+            else if (eat(">"))  { additive(); binary(Gt); }
+            else return;
+        }
+    }
+
+    void additive() {
+        unary();
+        for (;;) {
+            if      (eat("+")) { unary(); binary(Add); }
+            else if (eat("-")) { unary(); binary(Sub); }
+            else return;
+        }
+    }
+
+    void unary() {
+        // Bound the recursion as well as the evaluation stack.
+        if (++nesting_ > 4 * Predicate::MAX_DEPTH) fail("expression too deeply nested");
+        struct Leave { int& n; ~Leave() { --n; } } leave{nesting_};
+        if (eat("!")) { unary(); emit(Not, 0);    return; }
+        if (eat("~")) { unary(); emit(BitNot, 0); return; }
+        if (eat("-")) { unary(); emit(Neg, 0);    return; }
+        primary();
+    }
+
+    void constant(uint32_t v) {
+        if (v > 0xFFFF) fail("constant wider than 16 bits");
+        emit(PushConst, 1);
+        out_->push_back(uint8_t(v));
+        out_->push_back(uint8_t(v >> 8));
+    }
+
+    void primary() {
+        skip_ws();
+        if (pos_ >= t_.size()) fail("expected operand");
+
+        if (eat("(")) {
+            logical_or();
+            if (!eat(")")) fail("expected ')'");
+            return;
+        }
+        if (eat("[")) {
+            logical_or();
+            if (!eat("]")) fail("expected ']'");
+            emit(Load8, 0);
+            return;
+        }
+
+        char c = t_[pos_];
+        if (c == '\'') {
+            if (pos_ + 2 >= t_.size() || t_[pos_ + 2] != '\'') fail("bad character constant");
+            uint8_t ch = uint8_t(t_[pos_ + 1]);
+            pos_ += 3;
+            constant(ch);
+            return;
+        }
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            size_t used = 0;
+            unsigned long v;
+            try {
+                v = std::stoul(t_.substr(pos_), &used, 0);
+            } catch (const std::exception&) {
+                fail("bad number");
+            }
+            pos_ += used;
+            constant(uint32_t(std::min<unsigned long>(v, 0x10000)));
+            return;
+        }
+        if (std::isalpha(static_cast<unsigned char>(c))) {
+            size_t start = pos_;
+            while (pos_ < t_.size() && std::isalnum(static_cast<unsigned char>(t_[pos_]))) ++pos_;
+            std::string word = t_.substr(start, pos_ - start);
+            for (char& ch : word) ch = char(std::toupper(static_cast<unsigned char>(ch)));
+
+            if (word == "BYTE" || word == "WORD") {
+                if (!eat("(")) fail("expected '('");
+                logical_or();
+                if (!eat(")")) fail("expected ')'");
+                emit(word == "BYTE" ? Load8 : Load16, 0);
+                return;
+            }
+            for (const Name& n : NAMES) {
+                if (word == n.name) {
+                    emit(n.op, 1);
+                    out_->push_back(n.arg);
+                    return;
+                }
+            }
+            pos_ = start;
+            fail("unknown name");
+        }
+        fail("expected operand");
+    }
+
+    const std::string&    t_;
+    size_t                pos_     = 0;
+    int                   depth_   = 0;
+    int                   nesting_ = 0;
+    std::vector<uint8_t>* out_     = nullptr;
+};
+
+Predicate Predicate::Compile(const std::string& text) {
+    return PredicateCompiler(text).run();
+}
+
+// ─── Evaluation ───────────────────────────────────────────────────────────────
+int32_t Predicate::eval(const State8080& s) const {
+    if (code_.empty()) return 1;
+
+    int32_t stack[MAX_DEPTH];
+    int     sp = 0;
+    const uint8_t* pc  = code_.data();
+    const uint8_t* end = pc + code_.size();
+
+    while (pc < end) {
+        uint8_t op = *pc++;
+        switch (op) {
+            case PushConst: stack[sp++] = int32_t(pc[0] | (pc[1] << 8)); pc += 2; break;
+            case PushReg8: {
+                const uint8_t regs[8] = {s.A, s.B, s.C, s.D, s.E, s.H, s.L, s.F};
+                stack[sp++] = regs[*pc++];
+                break;
+            }
+            case PushPair: {
+                const uint16_t pairs[6] = {s.BC(), s.DE(), s.HL(), s.SP, s.PC, s.PSW()};
+                stack[sp++] = pairs[*pc++];
+                break;
+            }
+            case PushFlag: stack[sp++] = (s.F & *pc++) ? 1 : 0; break;
+            case Load8:    stack[sp - 1] = s.read8(uint16_t(stack[sp - 1]));  break;
+            case Load16:   stack[sp - 1] = s.read16(uint16_t(stack[sp - 1])); break;
+            case Neg:      stack[sp - 1] = -stack[sp - 1]; break;
+            case Not:      stack[sp - 1] = !stack[sp - 1]; break;
+            case BitNot:   stack[sp - 1] = ~stack[sp - 1]; break;
+            default: {
+                int32_t b = stack[--sp];
+                int32_t& a = stack[sp - 1];
+                switch (op) {
+                    case Add:    a = a + b;  break;
+                    case Sub:    a = a - b;  break;
+                    case Lt:     a = a <  b; break;
+                    case Le:     a = a <= b; break;
+                    case Gt:     a = a >  b; break;
+                    case Ge:     a = a >= b; break;
+                    case Eq:     a = a == b; break;
+                    case Ne:     a = a != b; break;
+                    case BitAnd: a = a & b;  break;
+                    case BitXor: a = a ^ b;  break;
+                    case BitOr:  a = a | b;  break;
+                    case LogAnd: a = a && b; break;
+                    case LogOr:  a = a || b; break;
+                }
+            }
+        }
+    }
+    return stack[0];
+}
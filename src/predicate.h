@@ -0,0 +1,54 @@
+#pragma once
+#include "cpu8080.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ─── Compiled predicates ──────────────────────────────────────────────────────
+// Breakpoint and trace conditions such as
+//
+//     HL == 0x2400 && A > 0x10
+//     [HL] == 'A' || word(SP) == 0x0105
+//     CY && (B & 0x80) != 0
+//
+// are parsed once into a compact stack bytecode and evaluated without any
+// allocation or string handling.  They are only ever evaluated at the PCs
+// they are attached to (armed in the runner's trap bitmap), so the rest of
+// the program runs at full speed.
+//
+// Operands:  A B C D E H L F           8-bit registers
+//            BC DE HL SP PC PSW        16-bit registers
+//            CY Z S P AC               flags (0 or 1)
+//            [x]  byte(x)  word(x)     memory reads (little-endian word)
+//            123  0x7B  'c'            constants (up to 16 bits)
+// Operators, C precedence and semantics:
+//            ( )  ! ~ -  + -  < <= > >=  == !=  &  ^  |  &&  ||
+// Names are case-insensitive.  Arithmetic is done in 32 bits; the predicate
+// holds when the result is non-zero.
+
+class Predicate {
+public:
+    // Always true (an unconditional breakpoint).
+    Predicate() = default;
+
+    // Throws std::invalid_argument describing the error and its position.
+    static Predicate Compile(const std::string& text);
+
+    bool operator()(const State8080& s) const { return code_.empty() || eval(s) != 0; }
+
+    bool               always()   const { return code_.empty(); }
+    const std::string& text()     const { return text_; }
+    size_t             size()     const { return code_.size(); }   // bytecode bytes
+
+    // Raw value of the expression (1 for an unconditional predicate).
+    int32_t eval(const State8080& s) const;
+
+    static constexpr int MAX_DEPTH = 32;
+
+private:
+    friend class PredicateCompiler;
+
+    std::vector<uint8_t> code_;
+    std::string          text_;
+};
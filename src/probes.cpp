@@ -0,0 +1,84 @@
+#include "probes.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+ProbeSet::ProbeSet(Runner& runner, FILE* trace_out) : runner_(runner), trace_out_(trace_out) {
+    base_armed_   = runner_.traps.bitmap();
+    base_handler_ = runner_.traps.handler;
+    runner_.traps.handler = [this](State8080& s) { return trap(s); };
+}
+
+ProbeSet::~ProbeSet() {
+    runner_.traps.set_bitmap(base_armed_);
+    runner_.traps.handler = base_handler_;
+}
+
+void ProbeSet::add(Kind kind, uint16_t pc, Predicate cond) {
+    probes_.push_back(Probe{kind, pc, std::move(cond), 0});
+    rebuild();
+}
+
+void ProbeSet::add(Kind kind, const std::string& spec) {
+    const char* begin = spec.c_str();
+    char* end = nullptr;
+    unsigned long pc = std::strtoul(begin, &end, 0);
+    if (end == begin || pc > 0xFFFF)
+        throw std::invalid_argument("bad probe address in '" + spec + "'");
+
+    while (std::isspace(static_cast<unsigned char>(*end))) ++end;
+    Predicate cond;
+    if (*end) {
+        if (std::strncmp(end, "if", 2) != 0 || !std::isspace(static_cast<unsigned char>(end[2])))
+            throw std::invalid_argument("expected 'ADDR' or 'ADDR if EXPR', got '" + spec + "'");
+        cond = Predicate::Compile(end + 3);
+    }
+    add(kind, uint16_t(pc), std::move(cond));
+}
+
+void ProbeSet::remove(Kind kind, uint16_t pc) {
+    std::erase_if(probes_, [&](const Probe& p) { return p.kind == kind && p.pc == pc; });
+    rebuild();
+}
+
+void ProbeSet::rebuild() {
+    last_break_ = nullptr;
+    by_pc_.clear();
+    runner_.traps.set_bitmap(base_armed_);
+    // Tracepoints first, so that all of them have fired by the time a
+    // breakpoint at the same PC stops the run.
+    for (Kind kind : {Kind::Trace, Kind::Break}) {
+        for (size_t i = 0; i < probes_.size(); ++i) {
+            if (probes_[i].kind != kind) continue;
+            by_pc_[probes_[i].pc].push_back(i);
+            runner_.traps.arm(probes_[i].pc);
+        }
+    }
+}
+
+// ─── Trap handler ─────────────────────────────────────────────────────────────
+TrapAction ProbeSet::trap(State8080& s) {
+    auto it = by_pc_.find(s.PC);
+    if (it != by_pc_.end()) {
+        // Resuming from a breakpoint here: every probe has already run.
+        const bool resuming = runner_.instructions() == stopped_at_;
+        for (size_t i : it->second) {
+            Probe& p = probes_[i];
+            if (resuming || !p.cond(s)) continue;
+            ++p.hits;
+            if (p.kind == Kind::Break) {
+                last_break_ = &p;
+                stopped_at_ = runner_.instructions();
+                return TrapAction::Stop;
+            }
+            std::fprintf(trace_out_,
+                         "[trace] %04X  A=%02X F=%02X BC=%04X DE=%04X HL=%04X SP=%04X  cycles=%llu\n",
+                         s.PC, s.A, s.F, s.BC(), s.DE(), s.HL(), s.SP,
+                         static_cast<unsigned long long>(runner_.cycles()));
+        }
+    }
+    if (base_handler_) return base_handler_(s);
+    return TrapAction::Execute;
+}
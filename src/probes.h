@@ -0,0 +1,76 @@
+#pragma once
+#include "cpu8080.h"
+#include "predicate.h"
+#include "runner.h"
+
+#include <bitset>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// ─── Breakpoints and tracepoints ──────────────────────────────────────────────
+// Conditional breakpoints and tracepoints for runs without a debugger:
+//
+//     native8080 --break '0x0142 if HL == 0x2400' --trace '0x0105 if C == 9' prog.com
+//
+// Each probe arms its PC in the runner's trap bitmap; its compiled predicate
+// is only evaluated when execution reaches that PC, so everything else runs
+// with a single bit test per instruction.  A breakpoint whose predicate holds
+// stops the run with StopReason::Trap; a tracepoint prints the PC, registers
+// and cycle count to its stream and lets execution continue.
+//
+// Like GdbStub, the set chains onto whatever trap handler is installed when it
+// is constructed (e.g. the CP/M shim), so construct it after the shim's
+// attach().  Probes run before the chained handler.
+
+class ProbeSet {
+public:
+    enum class Kind { Break, Trace };
+
+    struct Probe {
+        Kind      kind = Kind::Break;
+        uint16_t  pc   = 0;
+        Predicate cond;
+        uint64_t  hits = 0;             // times reached with the predicate true
+    };
+
+    explicit ProbeSet(Runner& runner, FILE* trace_out = stderr);
+    ~ProbeSet();
+
+    ProbeSet(const ProbeSet&)            = delete;
+    ProbeSet& operator=(const ProbeSet&) = delete;
+
+    void add(Kind kind, uint16_t pc, Predicate cond = {});
+
+    // Parse "ADDR" or "ADDR if EXPR" (ADDR in C notation, e.g. 0x0142).
+    // Throws std::invalid_argument.
+    void add(Kind kind, const std::string& spec);
+
+    // Remove every probe of `kind` at `pc`.
+    void remove(Kind kind, uint16_t pc);
+
+    const std::vector<Probe>& probes() const { return probes_; }
+
+    // The breakpoint that ended the most recent run, if any.
+    const Probe* last_break() const { return last_break_; }
+
+private:
+    TrapAction trap(State8080& s);
+    void       rebuild();
+
+    Runner& runner_;
+    FILE*   trace_out_;
+
+    std::bitset<0x10000>                  base_armed_;
+    std::function<TrapAction(State8080&)> base_handler_;
+
+    std::vector<Probe>                                     probes_;
+    std::unordered_map<uint16_t, std::vector<size_t>>      by_pc_;   // indices into probes_
+    const Probe*                                           last_break_ = nullptr;
+
+    // Resuming from a breakpoint must not stop again before the instruction
+    // at that PC has executed.
+    uint64_t stopped_at_ = UINT64_MAX;
+};
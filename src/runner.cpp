@@ -0,0 +1,227 @@
+#include "runner.h"
+#include "aot.h"
+#include "step8080.h"
+#include "throttle.h"
+
+#include <algorithm>
+#include <chrono>
+
+const char* StopReasonName(StopReason reason) {
+    switch (reason) {
+        case StopReason::Halted:           return "halted";
+        case StopReason::Trap:             return "trap";
+        case StopReason::CycleLimit:       return "cycle limit";
+        case StopReason::InstructionLimit: return "instruction limit";
+        case StopReason::TimeLimit:        return "time limit";
+        case StopReason::StopRequested:    return "stop requested";
+    }
+    return "unknown";
+}
+
+int StopReasonExitStatus(StopReason reason) {
+    switch (reason) {
+        case StopReason::Halted:           return 0;
+        case StopReason::Trap:             return 0;
+        case StopReason::CycleLimit:       return 2;
+        case StopReason::InstructionLimit: return 3;
+        case StopReason::TimeLimit:        return 4;
+        case StopReason::StopRequested:    return 5;
+    }
+    return 1;
+}
+
+Runner::Runner(State8080& state, IOBus& io) : s_(state), io_(io) {
+    events.bound_slice(&slice_end_);
+}
+
+void Runner::set_throttle(Throttle* throttle) {
+    throttle_          = throttle;
+    throttle_anchored_ = false;
+}
+
+void Runner::set_translation(const AotProgram* program) {
+    aot_        = program;
+    aot_verify_ = false;
+    aot_on_     = false;
+    check_translation();
+}
+
+// Translated code runs only while no trap is armed inside it; once its bytes
+// differ from the image it runs verified, block by block, from then on.
+void Runner::check_translation() {
+    check_traps();
+    if (aot_ && !aot_verify_ && !aot_->intact(s_)) aot_verify_ = true;
+}
+
+// Only when the trap set has changed: after a trap handler, most of all
+// the BDOS, this must cost next to nothing.
+void Runner::check_traps() {
+    if (!aot_) {
+        aot_on_ = false;
+        return;
+    }
+    const bool was_on = aot_on_;
+    aot_traps_ = traps.generation();
+    aot_on_    = true;
+    for (size_t i = 0; i < aot_->code_range_count && aot_on_; ++i) {
+        const AotRange& r = aot_->code_ranges[i];
+        for (uint32_t a = r.first; a < uint32_t(r.first) + r.size; ++a)
+            if (traps.armed(uint16_t(a))) {
+                aot_on_ = false;
+                break;
+            }
+    }
+    // Stores were not watched while translation was off.
+    if (aot_on_ && !was_on && !aot_verify_ && !aot_->intact(s_)) aot_verify_ = true;
+}
+
+void Runner::note_stores(uint16_t addr, size_t len) {
+    if (!aot_) return;
+    for (size_t i = 0; i < len && !aot_verify_; ++i)
+        if (aot_->is_code(uint16_t(addr + i))) aot_verify_ = true;
+}
+
+StopReason Runner::run(const RunLimits& limits) {
+    using clock = std::chrono::steady_clock;
+
+    const uint64_t cycle_end = limits.max_cycles       ? cycles_ + limits.max_cycles             : UINT64_MAX;
+    const uint64_t insn_end  = limits.max_instructions ? instructions_ + limits.max_instructions : UINT64_MAX;
+    const auto     deadline  = clock::now() + std::chrono::duration_cast<clock::duration>(
+                                   std::chrono::duration<double>(limits.max_seconds));
+
+    const uint64_t slice = throttle_ ? throttle_->slice_cycles() : slice_cycles_;
+    // Anchored once, so that a program run in chunks (a frame at a time)
+    // keeps one schedule across calls; time spent between them is caught
+    // up, or dropped past the throttle's max_drift_us.
+    if (throttle_ && !throttle_anchored_) {
+        throttle_->start();
+        throttle_anchored_ = true;
+    }
+    if (aot_) check_translation();
+
+    for (;;) {
+        // ── Budget boundary: the only place events, interrupts, limits and
+        //    stop requests are seen ─────────────────────────────────────────
+        if (cycles_ >= events.next()) events.dispatch(cycles_);
+        if (irq_) take_interrupt();
+
+        if (stop_.exchange(false, std::memory_order_relaxed)) return StopReason::StopRequested;
+        if (cycles_ >= cycle_end)                             return StopReason::CycleLimit;
+        if (instructions_ >= insn_end)                        return StopReason::InstructionLimit;
+        if (limits.max_seconds > 0.0 && clock::now() >= deadline)
+            return StopReason::TimeLimit;
+
+        const uint64_t slice_start = cycles_;
+        const uint64_t slice_end   = std::min({cycle_end, cycles_ + slice, events.next()});
+
+        // A held interrupt is taken as soon as the CPU can accept it: with
+        // interrupts enabled step singly until then (the instruction after
+        // EI runs first); with them disabled run on, but stop where they
+        // are enabled again.
+        const uint64_t step_end = irq_ && s_.inte ? cycles_ + 1 : slice_end;
+        wait_ei_ = irq_ && !s_.inte;
+
+        slice_end_ = step_end;
+        std::optional<StopReason> stopped = hook ? run_slice<true>(insn_end) : run_slice<false>(insn_end);
+        if (idle_) ei_shadow_ = false;         // the wait loop ran instead
+        if (idle_ || (stopped == StopReason::Halted && s_.inte && events.next() != UINT64_MAX)) {
+            // Waiting for a device or an interrupt: let time pass up to the
+            // next event (which may have been scheduled during the slice).
+            idle_ = false;
+            if (!irq_) cycles_ = std::max(cycles_, slice_end_);
+        } else if (stopped) {
+            return *stopped;
+        }
+
+        if (throttle_) throttle_->slice_done(cycles_ - slice_start);
+    }
+}
+
+void Runner::clear_interrupt() {
+    irq_        = false;
+    irq_ack_    = false;
+    irq_vector_ = {};
+    ei_shadow_  = false;
+    wait_ei_    = false;
+    idle_       = false;
+}
+
+// The interrupt acknowledge executes the opcode on the bus like an
+// instruction; the instruction after EI still runs first.
+bool Runner::take_interrupt() {
+    if (!s_.inte || ei_shadow_) return false;
+    irq_ = false;                               // before the controller may raise it again
+    const InterruptVector v = !irq_ack_       ? irq_vector_
+                            : irq_controller_ ? irq_controller_()
+                                              : InterruptVector{};
+    cycles_ += uint64_t(Interrupt8080(s_, v.opcode, v.addr));
+    ++instructions_;
+    ei_shadow_ = false;
+    return true;
+}
+
+// ─── Slice: straight-line stepping with a bitmap test per fetch ───────────────
+// Returns a stop reason if the slice ended early (trap stop, HLT or hook).
+// The cycle count lives in the member throughout, so IN and OUT handlers
+// (lazily clocked devices) see it too.
+template <bool Hooked>
+std::optional<StopReason> Runner::run_slice(uint64_t insn_end) {
+    uint64_t insns = instructions_;
+    while (cycles_ < slice_end_ && insns < insn_end) {
+        if constexpr (Hooked) {
+            instructions_ = insns;
+            if (!hook(s_)) return StopReason::Trap;
+        }
+        if (traps.armed(s_.PC)) {
+            instructions_ = insns;          // handlers see exact counters
+            TrapAction action = traps.handler ? traps.handler(s_) : TrapAction::Execute;
+            if (aot_ && traps.generation() != aot_traps_) check_traps();
+            if (action == TrapAction::Stop) return StopReason::Trap;
+            if (action == TrapAction::Resume) {
+                ei_shadow_ = false;
+                continue;
+            }
+            if (action == TrapAction::Idle) {
+                idle_ = true;
+                return std::nullopt;
+            }
+        }
+        if (s_.halted) {
+            instructions_ = insns;
+            return StopReason::Halted;
+        }
+        if (wait_ei_ && s_.inte) [[unlikely]]
+            break;                          // EI (or a trap handler) enabled them
+        if constexpr (!Hooked) {
+            if (aot_on_) {
+                if (uint16_t(s_.PC - aot_->origin) < aot_->size && run_translated(insns, insn_end))
+                    continue;
+                if (!aot_verify_) note_pending_store();
+            }
+        }
+        ei_shadow_ = s_.mem[s_.PC] == 0xFB;
+        cycles_ += Step8080(s_, io_);
+        ++insns;
+    }
+    instructions_ = insns;
+    return std::nullopt;
+}
+
+// An interpreted store into translated code makes it run verified, as one
+// from a block does.
+void Runner::note_pending_store() {
+    const WriteSpan w = PendingWrite(s_);
+    note_stores(w.addr, w.len);
+}
+
+// Blocks keep the counters in the members themselves, as IN and OUT need.
+bool Runner::run_translated(uint64_t& insns, uint64_t insn_end) {
+    instructions_ = insns;
+    AotContext cx{s_, io_, *aot_, cycles_, instructions_, slice_end_,
+                  insn_end, aot_verify_ ? 0 : insn_end, aot_verify_};
+    const bool ran = aot_->run(cx);
+    insns = instructions_;
+    if (cx.smc) aot_verify_ = true;
+    if (ran) ei_shadow_ = cx.ei;
+    return ran;
+}
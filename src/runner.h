@@ -0,0 +1,223 @@
+#pragma once
+#include "cpu8080.h"
+#include "scheduler.h"
+
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+class Throttle;
+struct AotProgram;
+
+// ─── Stop reasons ─────────────────────────────────────────────────────────────
+enum class StopReason {
+    Halted,            // HLT executed
+    Trap,              // a trap handler asked to stop (e.g. CP/M warm boot)
+    CycleLimit,        // RunLimits::max_cycles reached
+    InstructionLimit,  // RunLimits::max_instructions reached
+    TimeLimit,         // RunLimits::max_seconds of wall time elapsed
+    StopRequested,     // Runner::request_stop() was called
+};
+
+const char* StopReasonName(StopReason reason);
+
+// The process exit status for a run that ended for `reason`: each reason
+// maps to a distinct status so batch drivers can tell a finished program
+// from one that was cut off.  1 is left for usage and load errors.
+int StopReasonExitStatus(StopReason reason);
+
+// ─── Run limits ───────────────────────────────────────────────────────────────
+// Zero means "unlimited".  Limits are only checked at budget boundaries, never
+// per instruction, so a run may overshoot a cycle limit by one instruction.
+struct RunLimits {
+    uint64_t max_cycles       = 0;
+    uint64_t max_instructions = 0;
+    double   max_seconds      = 0.0;
+};
+
+// ─── Traps ────────────────────────────────────────────────────────────────────
+// A trap is armed per address in a 64K-bit bitmap.  Before fetching at an armed
+// PC the runner calls the handler, which decides what happens next:
+//   Execute — nothing to do here, execute the instruction at PC normally
+//   Resume  — the handler changed the state (e.g. emulated a BDOS call and
+//             returned); re-examine the new PC before executing anything
+//   Stop    — end the run with StopReason::Trap
+//   Idle    — the CPU is spinning in a wait loop at PC (e.g. polling a
+//             device with nothing to report); as for a CPU halted with
+//             interrupts enabled, emulated time passes to the end of the
+//             slice without executing, and PC is re-examined after it
+// Unarmed addresses cost a single bit test.  Runner::cycles() and
+// instructions() are exact inside a handler.  Handlers that wrap a previous
+// one forward every PC they do not handle themselves, since the previous
+// handler may arm further traps while the program runs.
+//
+// A handler that stores to memory and lets the run go on reports the stores
+// with Runner::note_stores(), as translated code (aot.h) depends on them.
+enum class TrapAction { Execute, Resume, Stop, Idle };
+
+class TrapTable {
+public:
+    bool armed(uint16_t pc) const { return armed_[pc]; }
+    void arm(uint16_t pc, bool on = true) {
+        armed_[pc] = on;
+        ++generation_;
+    }
+
+    // The whole set at once, e.g. to restore it later.
+    const std::bitset<0x10000>& bitmap() const { return armed_; }
+    void set_bitmap(const std::bitset<0x10000>& armed) {
+        armed_ = armed;
+        ++generation_;
+    }
+
+    // Changes with every arm() and set_bitmap(), for what is worked out from
+    // the set.
+    uint64_t generation() const { return generation_; }
+
+    std::function<TrapAction(State8080&)> handler;
+
+private:
+    std::bitset<0x10000> armed_;
+    uint64_t             generation_ = 0;
+};
+
+// ─── Instruction hook ─────────────────────────────────────────────────────────
+// An optional callback run at every instruction boundary with exact counters,
+// before the trap check (so a trapped PC is seen both before its handler runs
+// and again at the PC it resumes at).  Returning false ends the run with
+// StopReason::Trap.  Runs with a hook use a separate loop, so leaving it unset
+// costs nothing.
+using InstructionHook = std::function<bool(const State8080&)>;
+
+// ─── Runner ───────────────────────────────────────────────────────────────────
+// Drives Step8080 in budget-sized slices.  Between slices it paces execution
+// through an optional Throttle and checks the run limits and stop requests.
+//
+// Slices also end at the next event on `events`, which is dispatched at that
+// boundary with exact counters, and interrupt requests are taken there; a
+// request raised during a slice (by an IN or OUT handler) ends it after the
+// current instruction.  A CPU halted with interrupts enabled sleeps until the
+// next event instead of stopping the run.
+class Runner {
+public:
+    // Default slice length when unthrottled: ~33 ms of 2 MHz emulated time,
+    // which bounds the latency of request_stop() and of wall-time limits.
+    static constexpr uint64_t DEFAULT_SLICE_CYCLES = 65'536;
+
+    Runner(State8080& state, IOBus& io);
+
+    TrapTable       traps;
+    InstructionHook hook;
+    Scheduler       events;
+
+    // Raise the interrupt line with `opcode` on the data bus (RST n).  The
+    // request is held until the CPU accepts it — at the next boundary with
+    // interrupts enabled, and not straight after EI — and a second request
+    // while one is pending replaces it.
+    void interrupt(uint8_t opcode) {
+        irq_        = true;
+        irq_vector_ = {opcode, 0};
+        irq_ack_    = false;
+        cut_slice();
+    }
+    bool interrupt_pending() const { return irq_; }
+
+    // Drop a held request and what the runner remembers about the last
+    // instruction (e.g. EI), as when rolling the CPU back to a snapshot.  A
+    // controller still asserting its line raises it again.
+    void clear_interrupt();
+
+    // What an interrupt controller puts on the data bus when the CPU
+    // acknowledges: RST n, or CALL (0xCD) and an address (an 8259 in 8080 mode).
+    struct InterruptVector {
+        uint8_t  opcode = 0xFF;
+        uint16_t addr   = 0;
+    };
+    using InterruptAck = std::function<InterruptVector()>;
+
+    // For an interrupt controller: set the level of the line it drives.  The
+    // CPU accepts an asserted line as for interrupt(), but the vector comes
+    // from `ack`, called at that moment (it may assert the line again for a
+    // further request).  Without an `ack` the bus floats and reads RST 7.
+    void set_interrupt_controller(InterruptAck ack) { irq_controller_ = std::move(ack); }
+    void interrupt_line(bool asserted) {
+        irq_     = asserted;
+        irq_ack_ = true;
+        if (asserted) cut_slice();
+    }
+
+    // Pace execution through `throttle` (nullptr = run flat out).  The slice
+    // length becomes the throttle's slice.  The schedule is anchored when the
+    // next run() starts and then carries on across runs.
+    void      set_throttle(Throttle* throttle);
+    Throttle* throttle() const { return throttle_; }
+
+    // Slice length used when unthrottled.
+    void set_slice_cycles(uint64_t cycles) { slice_cycles_ = cycles ? cycles : 1; }
+
+    // Execute the translated blocks of `program` (aot.h) instead of stepping
+    // through them (nullptr = interpret everything).  Runs with a hook always
+    // interpret.
+    void set_translation(const AotProgram* program);
+    const AotProgram* translation() const { return aot_; }
+
+    // For trap handlers that store to memory: `len` bytes from `addr` were
+    // written (see TrapTable).
+    void note_stores(uint16_t addr, size_t len);
+
+    // Run until the CPU halts, a trap stops it, a limit is hit or a stop is
+    // requested.  Counters accumulate across calls.
+    StopReason run(const RunLimits& limits = {});
+
+    // Ask a running run() to return with StopReason::StopRequested at the next
+    // slice boundary.  Safe to call from any thread or from a signal handler.
+    void request_stop() { stop_.store(true, std::memory_order_relaxed); }
+
+    // cycles() is also exact in IN and OUT handlers (as of the start of the
+    // instruction), for devices that work out their state from it.
+    uint64_t cycles()       const { return cycles_; }
+    uint64_t instructions() const { return instructions_; }
+
+    // Reset the counters, e.g. when rolling back to a snapshot.
+    void set_counters(uint64_t cycles, uint64_t instructions) {
+        cycles_       = cycles;
+        instructions_ = instructions;
+    }
+
+private:
+    template <bool Hooked>
+    std::optional<StopReason> run_slice(uint64_t insn_end);
+    bool take_interrupt();
+    bool run_translated(uint64_t& insns, uint64_t insn_end);
+    void check_translation();
+    void check_traps();
+    void note_pending_store();
+
+    // End the running slice after the current instruction, so a request
+    // raised by an I/O handler is seen at the next boundary.
+    void cut_slice() { slice_end_ = 0; }
+
+    State8080&        s_;
+    IOBus&            io_;
+    Throttle*         throttle_{nullptr};
+    bool              throttle_anchored_{false};
+    uint64_t          slice_cycles_{DEFAULT_SLICE_CYCLES};
+    uint64_t          cycles_{0};
+    uint64_t          instructions_{0};
+    std::atomic<bool> stop_{false};
+    uint64_t          slice_end_{0};          // the running slice ends here
+    bool              irq_{false};
+    bool              irq_ack_{false};        // the vector comes from irq_controller_
+    InterruptVector   irq_vector_;            // ... otherwise this one
+    InterruptAck      irq_controller_;
+    bool              ei_shadow_{false};      // the last instruction executed was EI
+    bool              wait_ei_{false};        // interrupt held while disabled: stop at EI
+    bool              idle_{false};           // a trap handler returned Idle
+    const AotProgram* aot_{nullptr};
+    bool              aot_on_{false};         // no trap armed in translated code
+    uint64_t          aot_traps_{0};          // traps.generation() aot_on_ is for
+    bool              aot_verify_{false};     // translated code was written to
+};
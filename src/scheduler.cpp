@@ -0,0 +1,75 @@
+#include "scheduler.h"
+
+#include <algorithm>
+
+namespace {
+// std::push_heap builds a max-heap; order by "later" to keep the earliest on top.
+struct Later {
+    template <class E>
+    bool operator()(const E& a, const E& b) const {
+        return a.when != b.when ? a.when > b.when : a.seq > b.seq;
+    }
+};
+} // namespace
+
+Scheduler::EventId Scheduler::add(uint64_t when, uint64_t period, Handler fn) {
+    const EventId id = EventId(slots_.size());
+    slots_.push_back(Slot{std::move(fn), when, period, 0, true});
+    push(id);
+    return id;
+}
+
+void Scheduler::push(EventId id) {
+    const uint64_t when = slots_[id].when;
+    if (slice_end_ && when < *slice_end_) *slice_end_ = when;
+    heap_.push_back(Entry{when, seq_++, id, slots_[id].gen});
+    std::push_heap(heap_.begin(), heap_.end(), Later{});
+}
+
+// Keep the heap top live, so next() is exact.  Stale entries further down
+// are dropped when they surface.
+void Scheduler::pop_stale() {
+    while (!heap_.empty() && heap_.front().gen != slots_[heap_.front().id].gen) {
+        std::pop_heap(heap_.begin(), heap_.end(), Later{});
+        heap_.pop_back();
+    }
+}
+
+void Scheduler::reschedule(EventId id, uint64_t when) {
+    Slot& slot = slots_[id];
+    ++slot.gen;
+    slot.when  = when;
+    slot.armed = true;
+    push(id);
+    pop_stale();
+}
+
+void Scheduler::cancel(EventId id) {
+    Slot& slot = slots_[id];
+    ++slot.gen;
+    slot.armed = false;
+    pop_stale();
+}
+
+void Scheduler::dispatch(uint64_t now) {
+    while (!heap_.empty() && heap_.front().when <= now) {
+        const Entry top = heap_.front();
+        std::pop_heap(heap_.begin(), heap_.end(), Later{});
+        heap_.pop_back();
+
+        Slot& slot = slots_[top.id];
+        if (slot.period) {
+            slot.when += slot.period;
+            push(top.id);
+        } else {
+            slot.armed = false;
+        }
+        slot.fn(top.when);
+        pop_stale();
+    }
+}
+
+void Scheduler::clear() {
+    slots_.clear();
+    heap_.clear();
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+// ─── Event scheduler ──────────────────────────────────────────────────────────
+// Device events keyed by the runner's cycle count: video interrupts, timer
+// expiries, serial character times.  The Runner ends each slice at the
+// earliest pending event and dispatches it at that instruction boundary, so
+// devices never need a per-instruction callback.  An event fires late by at
+// most the length of one instruction; handlers get the cycle it was due at.
+//
+// Events are one-shot or periodic.  Handlers may schedule, reschedule and
+// cancel events, including their own.
+
+class Scheduler {
+public:
+    using Handler = std::function<void(uint64_t due)>;
+    using EventId = uint32_t;
+
+    // Call `fn` once at cycle `when`.
+    EventId at(uint64_t when, Handler fn) { return add(when, 0, std::move(fn)); }
+
+    // Call `fn` at `first`, then every `period` cycles (period > 0).
+    EventId every(uint64_t first, uint64_t period, Handler fn) { return add(first, period, std::move(fn)); }
+
+    // Move a pending or finished event to `when`, keeping its handler and
+    // period.  Cancelling makes it pending no more; the id stays valid.
+    void reschedule(EventId id, uint64_t when);
+    void cancel(EventId id);
+
+    bool     pending(EventId id) const { return slots_[id].armed; }
+    uint64_t due(EventId id)     const { return slots_[id].when; }
+
+    // Cycle of the earliest pending event, UINT64_MAX if there is none.
+    uint64_t next() const { return heap_.empty() ? UINT64_MAX : heap_.front().when; }
+
+    // Fire every event due at or before `now`, earliest first; events due at
+    // the same cycle fire in the order they were scheduled.
+    void dispatch(uint64_t now);
+
+    // Forget all events (not from inside a handler).
+    void clear();
+
+    // Point at the running slice's end (the Runner does this), so an event
+    // scheduled during a slice — from an IN or OUT handler — before that end
+    // pulls it in and is not dispatched late.
+    void bound_slice(uint64_t* slice_end) { slice_end_ = slice_end; }
+
+private:
+    struct Slot {
+        Handler  fn;
+        uint64_t when   = 0;
+        uint64_t period = 0;
+        uint32_t gen    = 0;        // bumped whenever older heap entries go stale
+        bool     armed  = false;
+    };
+    struct Entry {
+        uint64_t when;
+        uint64_t seq;               // tie-break: scheduling order
+        EventId  id;
+        uint32_t gen;
+    };
+
+    EventId add(uint64_t when, uint64_t period, Handler fn);
+    void    push(EventId id);
+    void    pop_stale();
+
+    std::deque<Slot>   slots_;      // stable while handlers add events
+    std::vector<Entry> heap_;       // min-heap on (when, seq); may hold stale entries
+    uint64_t           seq_ = 0;
+    uint64_t*          slice_end_ = nullptr;
+};
@@ -0,0 +1,147 @@
+#include "serial.h"
+
+#include <cctype>
+#include <memory>
+
+SerialConsole::SerialConsole(Runner& runner, const State8080& s, const SerialConfig& config,
+                             uint8_t status_port, uint8_t idle_status)
+    : runner_(runner), s_(s), config_(config), status_port_(status_port), idle_status_(idle_status) {
+    base_handler_ = runner_.traps.handler;
+    runner_.traps.handler = [this](State8080& st) { return trap(st); };
+    if (config_.in_fd >= 0 || config_.out_fd >= 0)
+        host_ = std::make_unique<HostStream>(config_.in_fd, config_.out_fd);
+}
+
+SerialConsole::~SerialConsole() {
+    if (kick_) runner_.events.cancel(*kick_);
+    flush();
+    runner_.traps.handler = base_handler_;
+}
+
+// ─── Guest side ───────────────────────────────────────────────────────────────
+bool SerialConsole::rx_ready() {
+    return in_pos_ < in_.size() || (host_ && !host_->rx().empty());
+}
+
+void SerialConsole::status_read(bool rx) {
+    ++stats_.status_reads;
+    if (!rx) note_poll(uint16_t(s_.PC - 2));    // the IN starts two bytes back
+}
+
+uint8_t SerialConsole::read() {
+    uint8_t ch;
+    if (in_pos_ < in_.size()) {
+        ch = uint8_t(in_[in_pos_++]);
+        if (in_pos_ == in_.size()) {
+            in_.clear();
+            in_pos_ = 0;
+        }
+    } else if (!host_ || !host_->rx().try_pop(ch)) {
+        return last_rx_;
+    }
+    ++stats_.bytes_in;
+    if (config_.newlines && ch == '\n') ch = '\r';
+    if (config_.upper) ch = uint8_t(std::toupper(ch));
+    return last_rx_ = ch;
+}
+
+void SerialConsole::write(uint8_t ch) {
+    ch &= 0x7F;                                 // 7-bit terminal
+    if (ch == 0 || (config_.newlines && ch == '\r')) return;
+    ++stats_.bytes_out;
+    if (config_.capture) config_.capture->push_back(char(ch));
+    if (!host_) return;
+    if (!host_->tx().try_push(ch)) {            // sent while busy: lost, as on hardware
+        ++stats_.dropped;
+        return;
+    }
+    // One event, rescheduled for each flush window, so that output does not
+    // add a scheduler slot per window.
+    const uint64_t due = runner_.cycles() + FLUSH_CYCLES;
+    if (!kick_)
+        kick_ = runner_.events.at(due, [this](uint64_t) { host_->kick(); });
+    else if (!runner_.events.pending(*kick_))
+        runner_.events.reschedule(*kick_, due);
+}
+
+// ─── Host side ────────────────────────────────────────────────────────────────
+void SerialConsole::feed(const char* data, size_t size) {
+    in_.append(data, size);
+}
+
+// End of file is flagged after the last bytes are queued, so check it first.
+bool SerialConsole::input_ended() {
+    if (host_ && !host_->input_ended()) return false;
+    return !rx_ready();
+}
+
+void SerialConsole::flush() {
+    if (host_) host_->drain();
+}
+
+SerialConsole::Stats SerialConsole::stats() const {
+    Stats st = stats_;
+    st.writes = host_ ? host_->writes() : 0;
+    return st;
+}
+
+// ─── Poll loops ───────────────────────────────────────────────────────────────
+void SerialConsole::note_poll(uint16_t pc) {
+    if (!checked_[pc]) {
+        checked_[pc]    = true;
+        poll_sites_[pc] = is_poll_loop(pc);
+    }
+    // Arm lazily: a debugger or probe set may have rebuilt the bitmap.
+    if (poll_sites_[pc]) runner_.traps.arm(pc);
+}
+
+// IN status at `pc`, up to four instructions that only test A, and a
+// conditional jump back to `pc` that is taken when the status shows nothing
+// received: while no byte arrives, every pass through the loop is the same
+// and changes nothing but A and the flags.  The loop body is stepped on a
+// scratch CPU with either carry, as RAL and RAR shift it in.
+bool SerialConsole::is_poll_loop(uint16_t pc) {
+    if (s_.read8(pc) != 0xDB || s_.read8(uint16_t(pc + 1)) != status_port_) return false;
+    if (!scratch_) scratch_ = std::make_unique<State8080>();
+
+    IOBus none;
+    for (uint8_t carry : {uint8_t(0), FLAG_CY}) {
+        State8080& t = *scratch_;
+        for (uint16_t i = 0; i < 16; ++i) t.mem[uint16_t(pc + i)] = s_.read8(uint16_t(pc + i));
+        t.PC = uint16_t(pc + 2);
+        t.A  = idle_status_;
+        t.F  = uint8_t(FLAG_FIXED | carry);
+        for (int i = 0;; ++i) {
+            const uint8_t op = t.mem[t.PC];
+            const bool test = op == 0x07 || op == 0x0F || op == 0x17 || op == 0x1F ||   // rotates
+                              op == 0x2F || op == 0xA7 || op == 0xB7 ||                 // CMA ANA A ORA A
+                              op == 0xE6 || op == 0xEE || op == 0xF6 || op == 0xFE;     // ANI XRI ORI CPI
+            const bool jcc  = (op & 0xC7) == 0xC2;
+            if (i == 5 || !(test || jcc)) return false;
+            Step8080(t, none);
+            if (jcc) {
+                if (t.PC != pc) return false;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+TrapAction SerialConsole::trap(State8080& s) {
+    const bool ours = poll_sites_[s.PC] && s.read8(s.PC) == 0xDB && s.read8(uint16_t(s.PC + 1)) == status_port_;
+    if (!ours)
+        return base_handler_ ? base_handler_(s) : TrapAction::Execute;
+
+    if (rx_ready()) return TrapAction::Execute;
+    if (host_) {
+        host_->kick();                          // the program is waiting on the user: show its output
+        if (!runner_.throttle() && host_->wait_input(IDLE_WAIT_MS)) return TrapAction::Execute;
+    }
+    if (input_ended()) {
+        exhausted_ = true;
+        return TrapAction::Stop;
+    }
+    ++stats_.idles;
+    return TrapAction::Idle;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include "cpu8080.h"
+#include "hostio.h"
+#include "runner.h"
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+// ─── Serial console ───────────────────────────────────────────────────────────
+// The host end of a UART wired to the console: what the 88-2SIO (sio.h) and
+// the 8251 (i8251.h) share.  A UART model keeps its own registers and status
+// bits and asks this for bytes and room:
+//
+//   - Host I/O runs on a HostStream device thread; the guest side only
+//     touches its lock-free rings.  rx_ready() is true while the input ring
+//     (or feed()) has a byte, tx_ready() while the output ring has room, so
+//     a full ring reads as a busy transmitter and the guest waits, as on
+//     hardware.
+//   - Output is batched: the device thread is woken to write it
+//     FLUSH_CYCLES after the first byte queued since the last wake-up, when
+//     the program waits for input, or on flush(), and writes whatever has
+//     collected in one go.
+//   - Poll loops are fast-forwarded.  A status read with nothing received
+//     checks the code it came from; if it is a loop of IN status, a few
+//     tests of A and a conditional jump back to the IN that is taken while
+//     nothing has been received (not a wait for the transmitter), a trap is
+//     armed there.  While no input is pending the trap returns
+//     TrapAction::Idle, so emulated time passes to the next event without
+//     executing, and when the run is unthrottled the CPU thread waits for
+//     input for up to IDLE_WAIT_MS instead of spinning.  Once the input has
+//     ended the trap stops the run instead (input_exhausted()).
+
+struct SerialConfig {
+    int          in_fd    = 0;       // console input (-1 = only feed())
+    int          out_fd   = 1;       // console output (-1 = discard)
+    std::string* capture  = nullptr; // also append console output here
+    bool         upper    = false;   // fold input to upper case
+    bool         newlines = true;    // host LF <-> guest CR / CR LF
+};
+
+class SerialConsole {
+public:
+    static constexpr uint64_t FLUSH_CYCLES = 40'000;    // 20 ms at 2 MHz
+    static constexpr int      IDLE_WAIT_MS = 10;
+
+    struct Stats {
+        uint64_t status_reads = 0;
+        uint64_t bytes_in     = 0;
+        uint64_t bytes_out    = 0;
+        uint64_t dropped      = 0;   // bytes sent while the transmitter was busy
+        uint64_t writes       = 0;   // host write() calls
+        uint64_t idles        = 0;   // poll-loop traps that fast-forwarded
+    };
+
+    // Chains a trap handler onto `runner` (see TrapTable); the console must
+    // outlive the runner's use of it.  Reads the guest's code through `s`.
+    // `status_port` is the UART's status port and `idle_status` what it reads
+    // with nothing received and the transmitter ready: poll loops are
+    // classified by stepping them with that value.
+    SerialConsole(Runner& runner, const State8080& s, const SerialConfig& config,
+                  uint8_t status_port, uint8_t idle_status);
+    ~SerialConsole();                           // writes pending output
+
+    SerialConsole(const SerialConsole&)            = delete;
+    SerialConsole& operator=(const SerialConsole&) = delete;
+
+    // ── Guest side: only local state and the rings, no system calls ──────────
+    bool rx_ready();
+    bool tx_ready() { return !host_ || !host_->tx().full(); }
+
+    // Count a read of the status port, from an IN handler; `rx` is whether
+    // the status it returns shows a byte received.
+    void status_read(bool rx);
+
+    // The next input byte, mapped per the config; with none, the last again.
+    uint8_t read();
+
+    // Send a byte (7-bit; NUL dropped).  Lost if the output ring is full.
+    void write(uint8_t ch);
+
+    // ── Host side ─────────────────────────────────────────────────────────────
+    // Queue console input as if typed on the host (after the host's own).
+    void feed(const char* data, size_t size);
+
+    // Write any batched output now and wait until it has been written.
+    void flush();
+
+    // Wake the device thread to write what is queued and look for input.
+    void kick() { if (host_) host_->kick(); }
+
+    // The input has ended and everything in it has been read.
+    bool input_ended();
+
+    // The console input ended and the program then waited for more.
+    bool  input_exhausted() const { return exhausted_; }
+    Stats stats() const;
+
+private:
+    void       note_poll(uint16_t pc);
+    bool       is_poll_loop(uint16_t pc);
+    TrapAction trap(State8080& s);
+
+    Runner&          runner_;
+    const State8080& s_;
+    SerialConfig     config_;
+    uint8_t          status_port_;
+    uint8_t          idle_status_;
+    std::function<TrapAction(State8080&)> base_handler_;   // the handler this console wraps
+
+    std::unique_ptr<HostStream> host_;  // none without host descriptors
+    std::string in_;                    // feed()'s bytes, read before host input
+    size_t      in_pos_     = 0;
+    bool        exhausted_  = false;
+    uint8_t     last_rx_    = 0;
+    std::optional<Scheduler::EventId> kick_;   // the flush-window event, once created
+
+    std::bitset<0x10000> checked_;      // IN sites classified so far
+    std::bitset<0x10000> poll_sites_;   // ... and those that are poll loops
+    std::unique_ptr<State8080> scratch_;  // for stepping loop bodies
+    Stats                stats_;
+};
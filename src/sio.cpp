@@ -0,0 +1,38 @@
+#include "sio.h"
+
+Sio2::Sio2(Runner& runner, const State8080& s, const Sio2Config& config)
+    : base_(config.base), console_(runner, s, config, config.base, TDRE) {}
+
+// ─── Ports ────────────────────────────────────────────────────────────────────
+uint8_t Sio2::in(uint8_t port) {
+    switch (uint8_t(port - base_)) {
+        case 0: {
+            const bool rx = console_.rx_ready();
+            console_.status_read(rx);
+            return uint8_t((console_.tx_ready() ? TDRE : 0) | (rx ? RDRF : 0));
+        }
+        case 1:  return console_.read();
+        case 2:  return TDRE;                   // channel B: nothing attached
+        default: return 0x00;
+    }
+}
+
+void Sio2::out(uint8_t port, uint8_t val) {
+    switch (uint8_t(port - base_)) {
+        case 0: control_[0] = val; break;
+        case 1: console_.write(val); break;
+        case 2: control_[1] = val; break;
+        default: break;
+    }
+}
+
+// ─── Snapshots ────────────────────────────────────────────────────────────────
+void Sio2::save(StateWriter& w) const {
+    w.u8(control_[0]);
+    w.u8(control_[1]);
+}
+
+void Sio2::restore(StateReader& r) {
+    control_[0] = r.u8();
+    control_[1] = r.u8();
+}
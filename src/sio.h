@@ -0,0 +1,73 @@
+#pragma once
+#include "cpu8080.h"
+#include "device.h"
+#include "runner.h"
+#include "serial.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ─── MITS 88-2SIO ─────────────────────────────────────────────────────────────
+// The Altair's two-port serial board: two Motorola 6850 ACIAs, each with a
+// status/control port and a data port.
+//
+//   IN  base       status: bit 0 RDRF (byte received), bit 1 TDRE (ready to
+//                  send); DCD and CTS read as asserted
+//   OUT base       control (stored; 3 = master reset)
+//   IN  base + 1   received byte
+//   OUT base + 1   byte to send
+//
+// Channel A (base, base + 1) is the console and talks to the host through a
+// SerialConsole (serial.h): ring-buffered host I/O on a device thread,
+// batched output and fast-forwarded poll loops.  Channel B (base + 2,
+// base + 3) is present but unconnected.  Programs use the board the way
+// Altair BASIC does: read status until RDRF is set, then read the data port.
+//
+// The ACIAs' interrupt enables are stored but raise nothing.
+
+struct Sio2Config : SerialConfig {
+    uint8_t base = 0x10;             // channel A status/control port
+};
+
+class Sio2 : public Device {
+public:
+    static constexpr uint8_t RDRF = 0x01;
+    static constexpr uint8_t TDRE = 0x02;
+
+    using Stats = SerialConsole::Stats;
+
+    // Chains a trap handler onto `runner` (see TrapTable); the device must
+    // outlive the runner's use of it.  Reads the guest's code through `s`.
+    Sio2(Runner& runner, const State8080& s, const Sio2Config& config = {});
+
+    Sio2(const Sio2&)            = delete;
+    Sio2& operator=(const Sio2&) = delete;
+
+    bool    owns(uint8_t port) const { return uint8_t(port - base_) < 4; }
+    uint8_t in(uint8_t port) override;
+    void    out(uint8_t port, uint8_t val) override;
+
+    SerialConsole& console() { return console_; }
+
+    // Queue console input as if typed on the host (after the host's own).
+    void feed(const char* data, size_t size) { console_.feed(data, size); }
+
+    // Write any batched output now and wait until it has been written.
+    void flush() override { console_.flush(); }
+
+    // ── Device ────────────────────────────────────────────────────────────────
+    std::vector<PortRange> ports() const override { return {{base_, uint8_t(base_ + 3)}}; }
+    void reset() override { control_[0] = control_[1] = 0; }
+    void save(StateWriter& w) const override;
+    void restore(StateReader& r) override;
+
+    // The console input ended and the program then waited for more.
+    bool  input_exhausted() const { return console_.input_exhausted(); }
+    Stats stats() const           { return console_.stats(); }
+
+private:
+    uint8_t       base_;
+    SerialConsole console_;
+    uint8_t       control_[2] = {0, 0};
+};
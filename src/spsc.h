@@ -0,0 +1,114 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <span>
+
+// ─── Single-producer/single-consumer ring ─────────────────────────────────────
+// A bounded lock-free queue between exactly two threads, e.g. the CPU thread
+// and a device thread doing host I/O.  Each side owns one index and keeps a
+// cached copy of the other's, re-reading the shared one only when the cache
+// says the ring is full (producer) or empty (consumer); the indices sit on
+// separate cache lines.  Nothing blocks: a full ring is the back-pressure
+// signal, and waking a sleeping peer is left to the caller.
+//
+// Besides single elements there are contiguous spans for bulk transfer, so
+// a device thread can read() into and write() from the ring directly.
+// N must be a power of two.
+
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    static constexpr size_t CAPACITY = N;
+
+    // Elements queued, from either side; exact only when the other side is
+    // idle (e.g. to see that a consumer has drained the ring).
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    // ── Producer ──────────────────────────────────────────────────────────────
+    bool try_push(const T& v) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ == N) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ == N) return false;
+        }
+        buf_[head & (N - 1)] = v;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool full() { return write_span().empty(); }
+
+    // The free space up to the end of the buffer; fill a prefix, then commit().
+    std::span<T> write_span() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ == N) tail_cache_ = tail_.load(std::memory_order_acquire);
+        const size_t at = head & (N - 1);
+        return {buf_.data() + at, std::min(N - (head - tail_cache_), N - at)};
+    }
+    void commit(size_t n) { head_.store(head_.load(std::memory_order_relaxed) + n, std::memory_order_release); }
+
+    // Push up to `n` elements; returns how many fitted.
+    size_t push(const T* data, size_t n) {
+        size_t done = 0;
+        for (int part = 0; part < 2 && done < n; ++part) {
+            const std::span<T> room = write_span();
+            const size_t k = std::min(room.size(), n - done);
+            std::copy_n(data + done, k, room.data());
+            commit(k);
+            done += k;
+        }
+        return done;
+    }
+
+    // ── Consumer ──────────────────────────────────────────────────────────────
+    bool try_pop(T& out) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_cache_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail == head_cache_) return false;
+        }
+        out = buf_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() { return read_span().empty(); }
+
+    // The queued elements up to the end of the buffer; use a prefix, then
+    // consume().
+    std::span<const T> read_span() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_cache_) head_cache_ = head_.load(std::memory_order_acquire);
+        const size_t at = tail & (N - 1);
+        return {buf_.data() + at, std::min(head_cache_ - tail, N - at)};
+    }
+    void consume(size_t n) { tail_.store(tail_.load(std::memory_order_relaxed) + n, std::memory_order_release); }
+
+    // Pop up to `max` elements into `out`; returns how many.
+    size_t pop(T* out, size_t max) {
+        size_t done = 0;
+        for (int part = 0; part < 2 && done < max; ++part) {
+            const std::span<const T> queued = read_span();
+            const size_t k = std::min(queued.size(), max - done);
+            std::copy_n(queued.data(), k, out + done);
+            consume(k);
+            done += k;
+        }
+        return done;
+    }
+
+private:
+    static constexpr size_t LINE = 64;
+
+    alignas(LINE) std::atomic<size_t> head_{0};   // next slot to fill (producer)
+    size_t tail_cache_ = 0;                        // producer's copy of tail_
+    alignas(LINE) std::atomic<size_t> tail_{0};   // next slot to drain (consumer)
+    size_t head_cache_ = 0;                        // consumer's copy of head_
+    alignas(LINE) std::array<T, N> buf_{};
+};
@@ -0,0 +1,67 @@
+#include "throttle.h"
+
+#include <cerrno>
+#include <stdexcept>
+
+// ─── timespec arithmetic ──────────────────────────────────────────────────────
+
+static constexpr int64_t NS_PER_SEC = 1'000'000'000;
+
+static int64_t to_ns(const std::timespec& t) {
+    return int64_t(t.tv_sec) * NS_PER_SEC + t.tv_nsec;
+}
+
+static std::timespec from_ns(int64_t ns) {
+    std::timespec t;
+    t.tv_sec  = static_cast<std::time_t>(ns / NS_PER_SEC);
+    t.tv_nsec = static_cast<long>(ns % NS_PER_SEC);
+    return t;
+}
+
+static std::timespec now_monotonic() {
+    std::timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t;
+}
+
+// ─── Throttle ─────────────────────────────────────────────────────────────────
+
+Throttle::Throttle(const ThrottleConfig& cfg) : cfg_(cfg) {
+    if (cfg_.clock_hz == 0 || cfg_.slice_us == 0)
+        throw std::invalid_argument("Throttle: clock and slice must be non-zero");
+    slice_cycles_ = cfg_.clock_hz * cfg_.slice_us / 1'000'000;
+    if (slice_cycles_ == 0) slice_cycles_ = 1;
+}
+
+void Throttle::start() {
+    anchor_ = now_monotonic();
+    cycles_ = 0;
+}
+
+void Throttle::slice_done(uint64_t cycles) {
+    cycles_ += cycles;
+
+    // Deadline = anchor + cycles / clock.  Split the division so that the
+    // intermediate product cannot overflow on long runs.
+    uint64_t whole = cycles_ / cfg_.clock_hz;
+    uint64_t frac  = cycles_ % cfg_.clock_hz;
+    int64_t  deadline = to_ns(anchor_) + int64_t(whole) * NS_PER_SEC
+                      + int64_t(frac * NS_PER_SEC / cfg_.clock_hz);
+
+    int64_t now = to_ns(now_monotonic());
+    if (now >= deadline) {
+        // Behind schedule: keep running to catch up, unless the lag is too
+        // large to recover from gracefully.
+        if (now - deadline > int64_t(cfg_.max_drift_us) * 1000) {
+            anchor_ = from_ns(now);
+            cycles_ = 0;
+            ++resyncs_;
+        }
+        return;
+    }
+
+    std::timespec until = from_ns(deadline);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, nullptr) == EINTR) {
+        // Absolute deadline: simply retry after a signal.
+    }
+}
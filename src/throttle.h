@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <ctime>
+
+// ─── Real-time pacing ─────────────────────────────────────────────────────────
+// The CPU runs in slices of emulated time (default 1 ms).  After each slice the
+// host sleeps with clock_nanosleep() until the absolute deadline at which that
+// much emulated time should have elapsed.  Sleeping once per slice instead of
+// once per instruction keeps host CPU usage low at real 8080 clock rates.
+//
+// When the host falls behind, the following slices run back-to-back without
+// sleeping until the schedule is met again (catch-up).  If the lag exceeds
+// `max_drift_us` the schedule is re-anchored to "now" and the missed time is
+// dropped, so a stall (debugger, SIGSTOP, slow disk) never causes a long burst
+// of full-speed execution afterwards.
+
+struct ThrottleConfig {
+    uint64_t clock_hz     = 2'000'000;  // emulated CPU clock
+    uint32_t slice_us     = 1'000;      // emulated time per slice
+    uint32_t max_drift_us = 50'000;     // lag tolerated before re-anchoring
+};
+
+class Throttle {
+public:
+    explicit Throttle(const ThrottleConfig& cfg);
+
+    // Number of clock cycles that make up one slice.
+    uint64_t slice_cycles() const { return slice_cycles_; }
+
+    // Anchor the schedule to the current host time.
+    void start();
+
+    // Account `cycles` of executed emulated time and sleep until its deadline.
+    void slice_done(uint64_t cycles);
+
+    // Number of times the schedule was re-anchored because of excess drift.
+    uint64_t resyncs() const { return resyncs_; }
+
+private:
+    ThrottleConfig  cfg_;
+    uint64_t        slice_cycles_;
+    std::timespec   anchor_{};       // host time corresponding to cycle 0
+    uint64_t        cycles_{0};      // cycles executed since the anchor
+    uint64_t        resyncs_{0};
+};
@@ -0,0 +1,237 @@
+#include "timeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+Timeline::Timeline(State8080& state, Runner& runner, IOBus& io, const TimelineConfig& config)
+    : s_(state), runner_(runner), io_(io), config_(config) {
+    if (config_.checkpoint_cycles == 0) config_.checkpoint_cycles = 1;
+
+    base_in_  = io_.in_handler;
+    base_out_ = io_.out_handler;
+
+    // Inputs are logged live and served from the log while replaying.
+    io_.in_handler = [this](uint8_t port) -> uint8_t {
+        if (cursor_ < inputs_.size()) return inputs_[cursor_++];
+        uint8_t v = base_in_ ? base_in_(port) : 0xFF;
+        inputs_.push_back(v);
+        ++cursor_;
+        return v;
+    };
+    io_.out_handler = [this](uint8_t port, uint8_t val) {
+        if (!replaying_ && base_out_) base_out_(port, val);
+    };
+
+    frontier_ = now();
+    take_checkpoint();
+}
+
+Timeline::~Timeline() {
+    io_.in_handler  = base_in_;
+    io_.out_handler = base_out_;
+}
+
+// ─── Checkpoints ──────────────────────────────────────────────────────────────
+void Timeline::take_checkpoint() {
+    Checkpoint cp;
+    cp.A = s_.A; cp.B = s_.B; cp.C = s_.C; cp.D = s_.D;
+    cp.E = s_.E; cp.H = s_.H; cp.L = s_.L; cp.F = s_.F;
+    cp.PC           = s_.PC;
+    cp.SP           = s_.SP;
+    cp.inte         = s_.inte;
+    cp.halted       = s_.halted;
+    cp.cycles       = runner_.cycles();
+    cp.instructions = now();
+    cp.input_pos    = cursor_;
+
+    // Share every page that has not changed since the previous checkpoint.
+    const Checkpoint* prev = checkpoints_.empty() ? nullptr : &checkpoints_.back();
+    for (size_t p = 0; p < PAGES; ++p) {
+        const uint8_t* live   = s_.mem.data() + p * PAGE_SIZE;
+        uint8_t*       shadow = shadow_.data() + p * PAGE_SIZE;
+        if (prev && std::memcmp(live, shadow, PAGE_SIZE) == 0) {
+            cp.pages[p] = prev->pages[p];
+        } else {
+            auto page = std::make_shared<Page>();
+            std::memcpy(page->data(), live, PAGE_SIZE);
+            std::memcpy(shadow, live, PAGE_SIZE);
+            cp.pages[p] = std::move(page);
+            bytes_ += PAGE_SIZE;
+        }
+    }
+    bytes_ += sizeof(Checkpoint);
+    checkpoints_.push_back(std::move(cp));
+
+    while (bytes_ > config_.budget_bytes && checkpoints_.size() > 1) {
+        drop(checkpoints_.front());
+        checkpoints_.pop_front();
+    }
+}
+
+// Account for the pages only `cp` holds; the caller removes it.
+void Timeline::drop(const Checkpoint& cp) {
+    for (const auto& page : cp.pages)
+        if (page.use_count() == 1) bytes_ -= PAGE_SIZE;
+    bytes_ -= sizeof(Checkpoint);
+}
+
+void Timeline::restore(const Checkpoint& cp) {
+    s_.A = cp.A; s_.B = cp.B; s_.C = cp.C; s_.D = cp.D;
+    s_.E = cp.E; s_.H = cp.H; s_.L = cp.L; s_.F = cp.F;
+    s_.PC     = cp.PC;
+    s_.SP     = cp.SP;
+    s_.inte   = cp.inte;
+    s_.halted = cp.halted;
+    for (size_t p = 0; p < PAGES; ++p)
+        std::memcpy(s_.mem.data() + p * PAGE_SIZE, cp.pages[p]->data(), PAGE_SIZE);
+    runner_.set_counters(cp.cycles, cp.instructions);
+    runner_.clear_interrupt();
+    cursor_ = cp.input_pos;
+}
+
+size_t Timeline::checkpoint_before(uint64_t n) const {
+    size_t i = checkpoints_.size() - 1;
+    while (i > 0 && checkpoints_[i].instructions > n) --i;
+    return i;
+}
+
+void Timeline::diverge() {
+    frontier_ = now();
+    while (!checkpoints_.empty() && checkpoints_.back().instructions >= frontier_) {
+        drop(checkpoints_.back());
+        checkpoints_.pop_back();
+    }
+    if (!checkpoints_.empty()) {
+        for (size_t p = 0; p < PAGES; ++p)
+            std::memcpy(shadow_.data() + p * PAGE_SIZE, checkpoints_.back().pages[p]->data(), PAGE_SIZE);
+    }
+    inputs_.resize(cursor_);
+    take_checkpoint();
+}
+
+// ─── Forward execution ────────────────────────────────────────────────────────
+void Timeline::set_replaying(bool on) {
+    if (on == replaying_) return;
+    replaying_ = on;
+    if (replay_hook_) replay_hook_(on);
+}
+
+StopReason Timeline::run(const RunLimits& limits) {
+    using clock = std::chrono::steady_clock;
+
+    const uint64_t cycle_end = limits.max_cycles       ? runner_.cycles() + limits.max_cycles : UINT64_MAX;
+    const uint64_t insn_end  = limits.max_instructions ? now() + limits.max_instructions      : UINT64_MAX;
+    const auto     started   = clock::now();
+
+    // Run in chunks that end at the edge of the recorded history and at each
+    // checkpoint due.
+    for (;;) {
+        if (runner_.cycles() >= cycle_end) return StopReason::CycleLimit;
+        if (now() >= insn_end)             return StopReason::InstructionLimit;
+
+        const bool replay = now() < frontier_;
+        if (!replay && runner_.cycles() >= checkpoints_.back().cycles + config_.checkpoint_cycles)
+            take_checkpoint();
+
+        const uint64_t insn_stop  = replay ? std::min(insn_end, frontier_) : insn_end;
+        const uint64_t cycle_stop = replay ? cycle_end
+                                           : std::min(cycle_end, checkpoints_.back().cycles + config_.checkpoint_cycles);
+        RunLimits chunk;
+        chunk.max_cycles       = cycle_stop == UINT64_MAX ? 0 : cycle_stop - runner_.cycles();
+        chunk.max_instructions = insn_stop  == UINT64_MAX ? 0 : insn_stop - now();
+        if (limits.max_seconds > 0.0) {
+            chunk.max_seconds = limits.max_seconds - std::chrono::duration<double>(clock::now() - started).count();
+            if (chunk.max_seconds <= 0.0) return StopReason::TimeLimit;
+        }
+
+        set_replaying(replay);
+        StopReason reason = runner_.run(chunk);
+        set_replaying(false);
+        frontier_ = std::max(frontier_, now());
+
+        if (reason != StopReason::CycleLimit && reason != StopReason::InstructionLimit) return reason;
+    }
+}
+
+// ─── Travelling ───────────────────────────────────────────────────────────────
+void Timeline::enter_seek() {
+    seeking_        = true;
+    saved_throttle_ = runner_.throttle();
+    saved_hook_     = std::move(runner_.hook);
+    runner_.set_throttle(nullptr);
+    runner_.hook = nullptr;
+    set_replaying(true);
+}
+
+void Timeline::leave_seek() {
+    set_replaying(false);
+    runner_.hook = std::move(saved_hook_);
+    runner_.set_throttle(saved_throttle_);
+    seeking_ = false;
+}
+
+// Re-execute from the current state up to instant n.  Stops early only where
+// the recorded run itself ended (a trap stop or HLT).
+void Timeline::replay_to(uint64_t n) {
+    while (now() < n) {
+        const uint64_t before = now();
+        RunLimits limits;
+        limits.max_instructions = n - before;
+        runner_.run(limits);
+        if (now() == before) break;
+    }
+}
+
+bool Timeline::seek(uint64_t n) {
+    if (n < begin() || n > frontier_) return false;
+    if (n == now()) return true;
+
+    enter_seek();
+    const Checkpoint& cp = checkpoints_[checkpoint_before(n)];
+    if (n < now() || cp.instructions > now()) restore(cp);
+    replay_to(n);
+    leave_seek();
+    return now() == n;
+}
+
+std::optional<uint64_t> Timeline::find_last(const std::function<bool(const State8080&)>& pred) {
+    const uint64_t origin = now();
+    if (origin <= begin()) return std::nullopt;
+
+    enter_seek();
+
+    // Scan the segments between checkpoints newest first; within a segment
+    // the last match wins.
+    std::optional<uint64_t> found;
+    for (size_t i = checkpoint_before(origin - 1);; --i) {
+        const uint64_t seg_end = i + 1 < checkpoints_.size()
+                                     ? std::min(origin, checkpoints_[i + 1].instructions)
+                                     : origin;
+        restore(checkpoints_[i]);
+        runner_.hook = [&](const State8080& s) {
+            if (pred(s)) found = runner_.instructions();
+            return true;
+        };
+        replay_to(seg_end);
+        runner_.hook = nullptr;
+        if (found || i == 0) break;
+    }
+
+    const uint64_t target = found ? *found : origin;
+    restore(checkpoints_[checkpoint_before(target)]);
+    replay_to(target);
+
+    // The match may lie past a trap handler at that instant (e.g. at the
+    // return address of an emulated BDOS call): run the handlers up to it.
+    if (found && !pred(s_)) {
+        runner_.hook = [&](const State8080& s) { return !pred(s); };
+        RunLimits limits;
+        limits.max_instructions = 1;
+        runner_.run(limits);
+        runner_.hook = nullptr;
+    }
+
+    leave_seek();
+    return found;
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include "cpu8080.h"
+#include "runner.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// ─── Reverse execution ────────────────────────────────────────────────────────
+// A Timeline records enough of a run to travel back in it: periodic
+// checkpoints of the registers and memory, plus a log of every value read by
+// IN.  Going back to an earlier instant restores the nearest checkpoint before
+// it and re-executes forward; with the inputs replayed from the log the CPU
+// retraces exactly the same path.
+//
+// Checkpoints are incremental.  Memory is split into 256-byte pages that are
+// shared between checkpoints; at each checkpoint only the pages that differ
+// from the previous one are copied, found by comparison against a shadow copy
+// so the interpreter's store path stays untouched.  When the checkpoints
+// outgrow the memory budget the oldest are dropped, which moves the start of
+// the reachable history forward.
+//
+// Instants are instruction counts (Runner::instructions()): instant n is the
+// state before the n-th instruction executes.  While history is re-executed,
+// OUT is suppressed and set_replay_hook() is told, so that host-visible side
+// effects (e.g. CP/M console output) are not repeated.
+//
+// The Timeline wraps the IOBus handlers installed when it is constructed and
+// restores them on destruction.
+
+struct TimelineConfig {
+    uint64_t checkpoint_cycles = 1'000'000;   // live cycles between checkpoints
+    size_t   budget_bytes      = 64u << 20;   // memory for checkpoints
+};
+
+class Timeline {
+public:
+    Timeline(State8080& state, Runner& runner, IOBus& io, const TimelineConfig& config = {});
+    ~Timeline();
+
+    Timeline(const Timeline&)            = delete;
+    Timeline& operator=(const Timeline&) = delete;
+
+    // Called with true when re-execution of recorded history starts and with
+    // false when it ends.
+    void set_replay_hook(std::function<void(bool replaying)> fn) { replay_hook_ = std::move(fn); }
+
+    // Run forward like Runner::run().  Up to end() this replays the recorded
+    // history; beyond it, execution is live and checkpoints are taken.
+    StopReason run(const RunLimits& limits = {});
+
+    // Move to instant `n`, in [begin(), end()].  Returns false (and stays put)
+    // outside that range.
+    bool seek(uint64_t n);
+
+    // Move back `n` instructions; false if that is before begin().
+    bool step_back(uint64_t n = 1) { return now() >= n && seek(now() - n); }
+
+    // Search the history before now for the latest instruction boundary at
+    // which `pred` holds, and move there.  `pred` sees every state the Runner's
+    // instruction hook would, so a trapped PC is seen both before and after
+    // its handler.  Returns the instant, or nothing (staying put) if no state
+    // in the reachable history matches.
+    std::optional<uint64_t> find_last(const std::function<bool(const State8080&)>& pred);
+
+    // The state at the current instant was changed from outside (e.g. by a
+    // debugger): forget the recorded future and checkpoint the new state.
+    void diverge();
+
+    // True while the Timeline is moving the CPU to another instant.  Trap
+    // handlers that stop the run (breakpoints) should stay quiet meanwhile.
+    bool seeking() const { return seeking_; }
+
+    uint64_t now()   const { return runner_.instructions(); }
+    uint64_t begin() const { return checkpoints_.front().instructions; }
+    uint64_t end()   const { return frontier_; }
+
+    size_t checkpoints()  const { return checkpoints_.size(); }
+    size_t memory_bytes() const { return bytes_; }
+
+private:
+    static constexpr size_t PAGE_SIZE = 256;
+    static constexpr size_t PAGES     = 0x10000 / PAGE_SIZE;
+    using Page = std::array<uint8_t, PAGE_SIZE>;
+
+    struct Checkpoint {
+        uint8_t  A, B, C, D, E, H, L, F;
+        uint16_t PC, SP;
+        bool     inte, halted;
+        uint64_t cycles, instructions;
+        size_t   input_pos;
+        std::array<std::shared_ptr<const Page>, PAGES> pages;
+    };
+
+    void   take_checkpoint();
+    void   drop(const Checkpoint& cp);
+    void   restore(const Checkpoint& cp);
+    size_t checkpoint_before(uint64_t n) const;     // index of the latest at or before n
+    void   replay_to(uint64_t n);
+    void   set_replaying(bool on);
+    void   enter_seek();
+    void   leave_seek();
+
+    State8080&     s_;
+    Runner&        runner_;
+    IOBus&         io_;
+    TimelineConfig config_;
+
+    std::function<uint8_t(uint8_t)>       base_in_;
+    std::function<void(uint8_t, uint8_t)> base_out_;
+    std::function<void(bool)>             replay_hook_;
+
+    std::deque<Checkpoint>          checkpoints_;
+    std::array<uint8_t, 0x10000>    shadow_{};     // memory at checkpoints_.back()
+    size_t                          bytes_ = 0;
+
+    std::vector<uint8_t> inputs_;                  // every IN value, in order
+    size_t               cursor_ = 0;              // next input to replay
+
+    uint64_t frontier_  = 0;                       // newest instant ever executed
+    bool     replaying_ = false;
+    bool     seeking_   = false;
+
+    // Suspended while seeking: pacing and any instruction hook.
+    Throttle*       saved_throttle_ = nullptr;
+    InstructionHook saved_hook_;
+};
@@ -0,0 +1,225 @@
+#include "video.h"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Each path broadcasts the byte to every lane, tests lane i against bit i and
+// selects fg or bg by the resulting mask.
+void ExpandBits(const uint8_t* bits, size_t bytes, uint32_t* out, uint32_t fg, uint32_t bg) {
+#if defined(__AVX2__)
+    const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256i f = _mm256_set1_epi32(int(fg));
+    const __m256i b = _mm256_set1_epi32(int(bg));
+    for (size_t i = 0; i < bytes; ++i, out += 8) {
+        const __m256i v = _mm256_and_si256(_mm256_set1_epi32(bits[i]), lanes);
+        const __m256i m = _mm256_cmpeq_epi32(v, lanes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_blendv_epi8(b, f, m));
+    }
+#elif defined(__SSE2__)
+    const __m128i lo = _mm_setr_epi32(1, 2, 4, 8);
+    const __m128i hi = _mm_setr_epi32(16, 32, 64, 128);
+    const __m128i f  = _mm_set1_epi32(int(fg));
+    const __m128i b  = _mm_set1_epi32(int(bg));
+    auto select = [&](__m128i v, __m128i lanes) {
+        const __m128i m = _mm_cmpeq_epi32(_mm_and_si128(v, lanes), lanes);
+        return _mm_or_si128(_mm_and_si128(m, f), _mm_andnot_si128(m, b));
+    };
+    for (size_t i = 0; i < bytes; ++i, out += 8) {
+        const __m128i v = _mm_set1_epi32(bits[i]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),     select(v, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), select(v, hi));
+    }
+#elif defined(__ARM_NEON)
+    static const uint32_t LO[4] = {1, 2, 4, 8}, HI[4] = {16, 32, 64, 128};
+    const uint32x4_t lo = vld1q_u32(LO), hi = vld1q_u32(HI);
+    const uint32x4_t f  = vdupq_n_u32(fg), b = vdupq_n_u32(bg);
+    for (size_t i = 0; i < bytes; ++i, out += 8) {
+        const uint32x4_t v = vdupq_n_u32(bits[i]);
+        vst1q_u32(out,     vbslq_u32(vtstq_u32(v, lo), f, b));
+        vst1q_u32(out + 4, vbslq_u32(vtstq_u32(v, hi), f, b));
+    }
+#else
+    for (size_t i = 0; i < bytes; ++i)
+        for (int bit = 0; bit < 8; ++bit) *out++ = (bits[i] >> bit) & 1 ? fg : bg;
+#endif
+}
+
+const char* ExpandBitsIsa() {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#elif defined(__ARM_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+// ─── Hashing ──────────────────────────────────────────────────────────────────
+uint64_t HashFrame(const Framebuffer& fb) {
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ (uint64_t(fb.width) << 32 | uint32_t(fb.height));
+    const size_t n = fb.pixels.size();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        uint64_t v;
+        std::memcpy(&v, &fb.pixels[i], 8);
+        h = (h ^ v) * 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 32;
+    }
+    if (i < n) h = (h ^ fb.pixels[i]) * 0xFF51AFD7ED558CCDULL;
+    return h ^ (h >> 29);
+}
+
+// ─── PPM ──────────────────────────────────────────────────────────────────────
+std::vector<uint8_t> EncodePpm(const Framebuffer& fb) {
+    char header[32];
+    const int len = std::snprintf(header, sizeof header, "P6\n%d %d\n255\n", fb.width, fb.height);
+    std::vector<uint8_t> out(header, header + len);
+    out.reserve(out.size() + fb.pixels.size() * 3);
+    const uint8_t* px = reinterpret_cast<const uint8_t*>(fb.pixels.data());
+    for (size_t i = 0; i < fb.pixels.size(); ++i, px += 4)
+        out.insert(out.end(), px, px + 3);
+    return out;
+}
+
+// ─── PNG ──────────────────────────────────────────────────────────────────────
+namespace {
+
+// Deflate bit stream: values go in least significant bit first, Huffman
+// codes most significant bit first (RFC 1951, 3.1.1).
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    void bits(uint32_t v, int count) {
+        acc_ |= v << fill_;
+        fill_ += count;
+        for (; fill_ >= 8; fill_ -= 8, acc_ >>= 8) out_.push_back(uint8_t(acc_));
+    }
+    void code(uint32_t v, int count) {
+        uint32_t reversed = 0;
+        for (int i = 0; i < count; ++i) reversed |= ((v >> i) & 1) << (count - 1 - i);
+        bits(reversed, count);
+    }
+    void flush() {
+        if (fill_) out_.push_back(uint8_t(acc_));
+        acc_  = 0;
+        fill_ = 0;
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+    uint32_t              acc_  = 0;
+    int                   fill_ = 0;
+};
+
+// Fixed literal/length code (RFC 1951, 3.2.6).
+void fixed_symbol(BitWriter& w, unsigned sym) {
+    if      (sym < 144) w.code(0x30  + sym,         8);
+    else if (sym < 256) w.code(0x190 + sym - 144,   9);
+    else if (sym < 280) w.code(sym - 256,           7);
+    else                w.code(0xC0  + sym - 280,   8);
+}
+
+// Repeat the previous byte `len` (3..258) times: a match at distance 1.
+void run_match(BitWriter& w, unsigned len) {
+    static constexpr uint16_t BASE[29]  = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27,
+                                           31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static constexpr uint8_t  EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                           2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    int i = 28;
+    while (BASE[i] > len) --i;
+    fixed_symbol(w, 257 + unsigned(i));
+    w.bits(len - BASE[i], EXTRA[i]);
+    w.code(0, 5);                                   // distance code 0: distance 1
+}
+
+// zlib stream of one fixed-Huffman block with greedy run-length matches.
+std::vector<uint8_t> zlib_compress(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> out = {0x78, 0x01};
+    BitWriter w(out);
+    w.bits(1, 1);                                   // BFINAL
+    w.bits(1, 2);                                   // BTYPE = fixed Huffman
+    for (size_t i = 0; i < data.size();) {
+        size_t run = 0;
+        if (i > 0)
+            while (run < 258 && i + run < data.size() && data[i + run] == data[i - 1]) ++run;
+        if (run >= 3) {
+            run_match(w, unsigned(run));
+            i += run;
+        } else {
+            fixed_symbol(w, data[i++]);
+        }
+    }
+    fixed_symbol(w, 256);                           // end of block
+    w.flush();
+
+    uint32_t a = 1, b = 0;                          // Adler-32
+    for (uint8_t v : data) {
+        a = (a + v) % 65521;
+        b = (b + a) % 65521;
+    }
+    for (int shift = 24; shift >= 0; shift -= 8) out.push_back(uint8_t(((b << 16) | a) >> shift));
+    return out;
+}
+
+constexpr std::array<uint32_t, 256> CRC_TABLE = [] {
+    std::array<uint32_t, 256> t{};
+    for (uint32_t n = 0; n < 256; ++n) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        t[n] = c;
+    }
+    return t;
+}();
+
+void put32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int shift = 24; shift >= 0; shift -= 8) out.push_back(uint8_t(v >> shift));
+}
+
+void chunk(std::vector<uint8_t>& out, const char type[4], const std::vector<uint8_t>& body) {
+    put32(out, uint32_t(body.size()));
+    const size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), body.begin(), body.end());
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = start; i < out.size(); ++i) crc = CRC_TABLE[(crc ^ out[i]) & 0xFF] ^ (crc >> 8);
+    put32(out, crc ^ 0xFFFFFFFFu);
+}
+
+} // namespace
+
+std::vector<uint8_t> EncodePng(const Framebuffer& fb) {
+    // Rows of RGB, each with the Sub filter: flat runs become zeros.
+    const size_t stride = size_t(fb.width) * 3;
+    std::vector<uint8_t> raw;
+    raw.reserve((stride + 1) * size_t(fb.height));
+    for (int y = 0; y < fb.height; ++y) {
+        const uint8_t* px = reinterpret_cast<const uint8_t*>(fb.row(y));
+        raw.push_back(1);
+        for (size_t x = 0; x < stride; ++x) {
+            const size_t  i    = x / 3 * 4 + x % 3;
+            const uint8_t left = x >= 3 ? px[i - 4] : 0;
+            raw.push_back(uint8_t(px[i] - left));
+        }
+    }
+
+    std::vector<uint8_t> ihdr;
+    put32(ihdr, uint32_t(fb.width));
+    put32(ihdr, uint32_t(fb.height));
+    ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0});       // 8-bit RGB, no interlace
+
+    std::vector<uint8_t> out = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    chunk(out, "IHDR", ihdr);
+    chunk(out, "IDAT", zlib_compress(raw));
+    chunk(out, "IEND", {});
+    return out;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ─── Framebuffers ─────────────────────────────────────────────────────────────
+// Headless video output for machine profiles: an RGBA image in host memory,
+// row-major, top row first, with bytes R, G, B, A in memory order.
+
+struct Framebuffer {
+    int                   width  = 0;
+    int                   height = 0;
+    std::vector<uint32_t> pixels;      // width * height
+
+    void resize(int w, int h) {
+        width  = w;
+        height = h;
+        pixels.assign(size_t(w) * size_t(h), 0);
+    }
+    uint32_t*       row(int y)       { return pixels.data() + size_t(y) * size_t(width); }
+    const uint32_t* row(int y) const { return pixels.data() + size_t(y) * size_t(width); }
+};
+
+// One pixel value with bytes R, G, B, A in memory order on any host.
+constexpr uint32_t Rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 0xFF) {
+    if constexpr (std::endian::native == std::endian::little)
+        return uint32_t(r) | uint32_t(g) << 8 | uint32_t(b) << 16 | uint32_t(a) << 24;
+    else
+        return uint32_t(r) << 24 | uint32_t(g) << 16 | uint32_t(b) << 8 | uint32_t(a);
+}
+
+// ─── 1bpp expansion ───────────────────────────────────────────────────────────
+// Expand `bytes` bytes of a 1-bit-per-pixel bitmap into 8 * bytes pixels:
+// `fg` where a bit is set, `bg` where it is clear, least significant bit
+// first.  Uses SSE2, AVX2 or NEON compare-and-select when the build targets
+// them (8 pixels per byte in one or two vector stores), plain C++ otherwise.
+void ExpandBits(const uint8_t* bits, size_t bytes, uint32_t* out, uint32_t fg, uint32_t bg);
+
+// Name of the ExpandBits() implementation compiled in ("avx2", "sse2",
+// "neon" or "scalar").
+const char* ExpandBitsIsa();
+
+// ─── Image files ──────────────────────────────────────────────────────────────
+// 64-bit hash of the pixels, for spotting repeated frames.
+uint64_t HashFrame(const Framebuffer& fb);
+
+// Complete PPM (binary P6) and PNG (8-bit RGB) files; alpha is dropped.  PNG
+// uses a small built-in deflate (fixed Huffman codes with run-length
+// matches on Sub-filtered rows), so there is no zlib dependency and flat
+// video images still compress well.
+std::vector<uint8_t> EncodePpm(const Framebuffer& fb);
+std::vector<uint8_t> EncodePng(const Framebuffer& fb);
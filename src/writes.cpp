@@ -0,0 +1,93 @@
+#include "writes.h"
+#include "step8080.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+WriteIndex::WriteIndex(unsigned depth) : depth_(std::clamp(depth, 1u, MAX_DEPTH)) {
+    records_.assign(size_t(0x10000) * depth_, 0);
+    if (depth_ > 1) heads_.assign(0x10000, 0);
+}
+
+std::optional<WriteRecord> WriteIndex::last(uint16_t addr) const {
+    const uint64_t rec = records_[size_t(addr) * depth_ + (depth_ > 1 ? heads_[addr] : 0)];
+    if (!rec) return std::nullopt;
+    return WriteRecord{(rec >> 16) - 1, uint16_t(rec)};
+}
+
+std::vector<WriteRecord> WriteIndex::writers(uint16_t addr) const {
+    std::vector<WriteRecord> out;
+    const uint64_t* ring = records_.data() + size_t(addr) * depth_;
+    const unsigned  head = depth_ > 1 ? heads_[addr] : 0;
+    for (unsigned i = 0; i < depth_; ++i) {
+        const uint64_t rec = ring[(head + depth_ - i) % depth_];
+        if (!rec) break;
+        out.push_back({(rec >> 16) - 1, uint16_t(rec)});
+    }
+    return out;
+}
+
+void WriteIndex::clear() {
+    std::fill(records_.begin(), records_.end(), 0);
+    std::fill(heads_.begin(), heads_.end(), 0);
+    writes_ = 0;
+}
+
+void WriteIndex::dump(std::FILE* out) const {
+    for (uint32_t addr = 0; addr < 0x10000; ++addr) {
+        const std::vector<WriteRecord> w = writers(uint16_t(addr));
+        if (w.empty()) continue;
+        std::fprintf(out, "%04X ", addr);
+        for (const WriteRecord& r : w)
+            std::fprintf(out, " %04X@%llu", r.pc, static_cast<unsigned long long>(r.cycle));
+        std::fputc('\n', out);
+    }
+}
+
+// ─── Encoding ─────────────────────────────────────────────────────────────────
+//   u8 depth  u64 writes  records: 64K * depth * u64  heads: 64K * u8 (depth > 1)
+void WriteIndex::serialize(std::vector<uint8_t>& out) const {
+    auto put64 = [&](uint64_t v) {
+        for (int i = 0; i < 8; ++i) out.push_back(uint8_t(v >> (8 * i)));
+    };
+    out.reserve(out.size() + 9 + records_.size() * 8 + heads_.size());
+    out.push_back(uint8_t(depth_));
+    put64(writes_);
+    for (uint64_t rec : records_) put64(rec);
+    out.insert(out.end(), heads_.begin(), heads_.end());
+}
+
+WriteIndex WriteIndex::deserialize(const uint8_t*& p, const uint8_t* end) {
+    auto get64 = [&] {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) v |= uint64_t(*p++) << (8 * i);
+        return v;
+    };
+    if (end - p < 9 || p[0] < 1 || p[0] > MAX_DEPTH)
+        throw std::runtime_error("Malformed write index");
+    WriteIndex index(*p++);
+    const size_t need = index.records_.size() * 8 + index.heads_.size();
+    if (size_t(end - p) < 8 + need) throw std::runtime_error("Truncated write index");
+    index.writes_ = get64();
+    for (uint64_t& rec : index.records_) rec = get64();
+    for (uint8_t& head : index.heads_) {
+        head = *p++;
+        if (head >= index.depth_) throw std::runtime_error("Malformed write index");
+    }
+    return index;
+}
+
+// ─── WriteTracker ─────────────────────────────────────────────────────────────
+WriteTracker::WriteTracker(Runner& runner, WriteIndex& index)
+    : runner_(runner), index_(index), base_hook_(runner.hook) {
+    runner_.hook = [this](const State8080& s) {
+        const WriteSpan w = PendingWrite(s);
+        for (uint8_t i = 0; i < w.len; ++i)
+            index_.record(uint16_t(w.addr + i), runner_.cycles(), s.PC);
+        return !base_hook_ || base_hook_(s);
+    };
+}
+
+WriteTracker::~WriteTracker() {
+    runner_.hook = std::move(base_hook_);
+}
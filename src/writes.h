@@ -0,0 +1,98 @@
+#pragma once
+#include "cpu8080.h"
+#include "runner.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <vector>
+
+// ─── Last-writer index ────────────────────────────────────────────────────────
+// For every byte of memory: the PC of the instruction that last stored to it
+// and the cycle count at which that instruction started, optionally with the
+// previous few writers as well.  Answers "who wrote this byte?" after the
+// fact without re-running anything.
+//
+// Each record is packed into 8 bytes (48-bit cycle, 16-bit PC), so the index
+// is a flat side array of 512 KiB per level of history, plus a 64 KiB ring
+// position table when more than one level is kept.
+
+struct WriteRecord {
+    uint64_t cycle;                 // cycle count when the storing instruction began
+    uint16_t pc;                    // address of the storing instruction
+};
+
+class WriteIndex {
+public:
+    static constexpr unsigned MAX_DEPTH = 16;
+
+    // Keep the last `depth` writers of each byte (1..MAX_DEPTH).
+    explicit WriteIndex(unsigned depth = 1);
+
+    // Record a store to `addr`.  Records must arrive in cycle order; a store
+    // no newer than the latest one recorded for that byte (e.g. history being
+    // re-executed by a Timeline) is ignored.
+    void record(uint16_t addr, uint64_t cycle, uint16_t pc) {
+        const uint64_t rec = ((cycle + 1) << 16) | pc;        // 0 = empty
+        uint64_t* ring = records_.data() + size_t(addr) * depth_;
+        uint8_t   head = depth_ > 1 ? heads_[addr] : 0;
+        if ((ring[head] >> 16) >= (rec >> 16)) return;
+        if (depth_ > 1) {
+            head = uint8_t((head + 1) % depth_);
+            heads_[addr] = head;
+        }
+        ring[head] = rec;
+        ++writes_;
+    }
+
+    // The latest writer of `addr`, if it was written since tracking began.
+    std::optional<WriteRecord> last(uint16_t addr) const;
+
+    // Up to depth() writers of `addr`, most recent first.
+    std::vector<WriteRecord> writers(uint16_t addr) const;
+
+    unsigned depth()        const { return depth_; }
+    uint64_t writes()       const { return writes_; }     // stores recorded
+    size_t   memory_bytes() const { return records_.size() * sizeof(uint64_t) + heads_.size(); }
+
+    void clear();
+
+    // One line per written byte: "ADDR  PC@CYCLE [PC@CYCLE ...]", newest first.
+    void dump(std::FILE* out) const;
+
+    // Flat little-endian encoding, used inside snapshot files.  Decoding
+    // throws std::runtime_error on malformed input and advances `p`.
+    void          serialize(std::vector<uint8_t>& out) const;
+    static WriteIndex deserialize(const uint8_t*& p, const uint8_t* end);
+
+private:
+    unsigned              depth_;
+    std::vector<uint64_t> records_;    // depth_ records per byte, a ring
+    std::vector<uint8_t>  heads_;      // newest slot per byte (depth_ > 1)
+    uint64_t              writes_ = 0;
+};
+
+// ─── Write tracking ───────────────────────────────────────────────────────────
+// Feeds a WriteIndex from a Runner through its instruction hook: before each
+// instruction executes, PendingWrite() (step8080.h) tells which bytes it is
+// about to store.  The cost is bounded — a decode of one opcode and at most
+// two records per instruction — but it moves the runner onto its hooked loop;
+// tracked runs are typically 1.5-2x slower.  `native8080_macrobench
+// --track-writes N` measures the slowdown per workload.
+//
+// The tracker chains onto any hook already installed; attach and detach
+// hooks in LIFO order.
+
+class WriteTracker {
+public:
+    WriteTracker(Runner& runner, WriteIndex& index);
+    ~WriteTracker();
+
+    WriteTracker(const WriteTracker&)            = delete;
+    WriteTracker& operator=(const WriteTracker&) = delete;
+
+private:
+    Runner&         runner_;
+    WriteIndex&     index_;
+    InstructionHook base_hook_;
+};
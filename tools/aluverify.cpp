@@ -0,0 +1,335 @@
+// ─── native8080_aluverify ─────────────────────────────────────────────────────
+// Exhaustive conformance check of the accumulator/flag logic on every engine.
+//
+// For every ALU opcode and every operand byte, all 1024 combinations of
+// (A, CY, AC) are executed and the resulting A and flags are compared with an
+// independent bit-level model of the 8080 ALU.  Every other engine must
+// additionally reproduce the reference engine's results and cycle count
+// exactly.
+//
+// Each job is one (opcode, operand) pair.  Its inputs are a table of 1024 PSW
+// words; the generated program walks the table with
+//
+//     POP PSW ; <op> ; PUSH PSW ; INX SP ; INX SP
+//
+// so the results overwrite the inputs in place and the engine under test
+// runs thousands of instructions per call.  Jobs are spread over all cores.
+//
+// Exit status: 0 = all engines conform, 1 = mismatch, 2 = usage error.
+
+#include "cpu8080.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint16_t CODE_ORG    = 0x0100;
+constexpr uint16_t OPERAND_M   = 0x3000;   // HL target for the M forms
+constexpr uint16_t TABLE_ORG   = 0x8000;   // 1024 PSW words
+constexpr int      LANES       = 1024;     // A (256) x CY (2) x AC (2)
+constexpr uint8_t  OTHER_FLAGS = FLAG_S | FLAG_Z | FLAG_P;
+
+enum class Operand { Reg, Mem, Imm, Self, None };
+
+struct Opcode {
+    const char* name;
+    uint8_t     op;
+    Operand     operand;
+};
+
+const std::vector<Opcode>& opcodes() {
+    static const std::vector<Opcode> v = [] {
+        static const char* const alu[8]  = {"ADD B", "ADC B", "SUB B", "SBB B", "ANA B", "XRA B", "ORA B", "CMP B"};
+        static const char* const mem[8]  = {"ADD M", "ADC M", "SUB M", "SBB M", "ANA M", "XRA M", "ORA M", "CMP M"};
+        static const char* const imm[8]  = {"ADI",   "ACI",   "SUI",   "SBI",   "ANI",   "XRI",   "ORI",   "CPI"};
+        static const char* const self[8] = {"ADD A", "ADC A", "SUB A", "SBB A", "ANA A", "XRA A", "ORA A", "CMP A"};
+        std::vector<Opcode> out;
+        for (uint8_t i = 0; i < 8; ++i) out.push_back({alu[i],  uint8_t(0x80 | (i << 3) | 0), Operand::Reg});
+        for (uint8_t i = 0; i < 8; ++i) out.push_back({mem[i],  uint8_t(0x80 | (i << 3) | 6), Operand::Mem});
+        for (uint8_t i = 0; i < 8; ++i) out.push_back({imm[i],  uint8_t(0xC6 | (i << 3)),     Operand::Imm});
+        for (uint8_t i = 0; i < 8; ++i) out.push_back({self[i], uint8_t(0x80 | (i << 3) | 7), Operand::Self});
+        out.push_back({"INR A", 0x3C, Operand::None});
+        out.push_back({"DCR A", 0x3D, Operand::None});
+        out.push_back({"DAA",   0x27, Operand::None});
+        out.push_back({"RLC",   0x07, Operand::None});
+        out.push_back({"RRC",   0x0F, Operand::None});
+        out.push_back({"RAL",   0x17, Operand::None});
+        out.push_back({"RAR",   0x1F, Operand::None});
+        out.push_back({"CMA",   0x2F, Operand::None});
+        out.push_back({"STC",   0x37, Operand::None});
+        out.push_back({"CMC",   0x3F, Operand::None});
+        return out;
+    }();
+    return v;
+}
+
+// Input PSW for lane `i`.  S, Z and P are preset to a pattern so that the
+// opcodes which must preserve them are checked too.
+uint16_t lane_psw(int i) {
+    uint8_t a  = uint8_t(i >> 2);
+    uint8_t f  = FLAG_FIXED;
+    if (i & 1) f |= FLAG_CY;
+    if (i & 2) f |= FLAG_AC;
+    if (a & 1) f |= OTHER_FLAGS;
+    return uint16_t(a << 8) | f;
+}
+
+// ─── Independent ALU model ────────────────────────────────────────────────────
+// Written as a ripple-carry adder rather than in terms of the interpreter's
+// nibble arithmetic.  Subtraction is A + ~B + !borrow with CY reporting a
+// borrow; AC follows the same borrow convention as CY (set on a borrow out of
+// bit 3), matching this emulator's documented behaviour.
+struct Sum {
+    uint8_t value;
+    bool    c3;     // carry out of bit 3
+    bool    c7;     // carry out of bit 7
+};
+
+Sum ripple_add(uint8_t a, uint8_t b, bool cin) {
+    Sum s{0, false, false};
+    bool c = cin;
+    for (int bit = 0; bit < 8; ++bit) {
+        bool x = (a >> bit) & 1, y = (b >> bit) & 1;
+        if (x ^ y ^ c) s.value |= uint8_t(1 << bit);
+        c = (x & y) | (c & (x ^ y));
+        if (bit == 3) s.c3 = c;
+    }
+    s.c7 = c;
+    return s;
+}
+
+uint8_t szp(uint8_t v) {
+    uint8_t f = 0;
+    if (v & 0x80) f |= FLAG_S;
+    if (v == 0)   f |= FLAG_Z;
+    int ones = 0;
+    for (int bit = 0; bit < 8; ++bit) ones += (v >> bit) & 1;
+    if ((ones & 1) == 0) f |= FLAG_P;
+    return f;
+}
+
+uint16_t model(uint8_t op, uint8_t operand, uint16_t psw) {
+    uint8_t a  = uint8_t(psw >> 8);
+    uint8_t f  = uint8_t(psw);
+    bool    cy = f & FLAG_CY, ac = f & FLAG_AC;
+    auto pack = [](uint8_t r, uint8_t flags) { return uint16_t(r << 8) | uint8_t(flags | FLAG_FIXED); };
+
+    if ((op & 0xC0) == 0x80 || (op & 0xC7) == 0xC6) {
+        uint8_t b = (op & 0xC7) == 0x87 ? a : operand;
+        switch ((op >> 3) & 7) {
+            case 0: case 1: {                          // ADD / ADC
+                Sum s = ripple_add(a, b, ((op >> 3) & 1) && cy);
+                return pack(s.value, szp(s.value) | (s.c3 ? FLAG_AC : 0) | (s.c7 ? FLAG_CY : 0));
+            }
+            case 2: case 3: case 7: {                  // SUB / SBB / CMP
+                bool borrow = ((op >> 3) & 7) == 3 && cy;
+                Sum s = ripple_add(a, uint8_t(~b), !borrow);
+                uint8_t flags = szp(s.value) | (s.c3 ? 0 : FLAG_AC) | (s.c7 ? 0 : FLAG_CY);
+                return pack(((op >> 3) & 7) == 7 ? a : s.value, flags);
+            }
+            case 4: {                                  // ANA: AC = bit 3 of either operand
+                uint8_t r = a & b;
+                return pack(r, szp(r) | (((a | b) & 0x08) ? FLAG_AC : 0));
+            }
+            case 5:  { uint8_t r = a ^ b; return pack(r, szp(r)); }
+            default: { uint8_t r = a | b; return pack(r, szp(r)); }
+        }
+    }
+
+    uint8_t keep = f & (OTHER_FLAGS | FLAG_AC);
+    switch (op) {
+        case 0x3C: {                                   // INR A: CY preserved
+            Sum s = ripple_add(a, 1, false);
+            return pack(s.value, szp(s.value) | (s.c3 ? FLAG_AC : 0) | (cy ? FLAG_CY : 0));
+        }
+        case 0x3D: {                                   // DCR A: CY preserved
+            Sum s = ripple_add(a, 0xFF, false);
+            return pack(s.value, szp(s.value) | (s.c3 ? 0 : FLAG_AC) | (cy ? FLAG_CY : 0));
+        }
+        case 0x27: {                                   // DAA
+            uint8_t corr = 0;
+            bool    out_cy = false;
+            if (ac || (a & 0x0F) > 9) corr |= 0x06;
+            if (cy || a > 0x99)       { corr |= 0x60; out_cy = true; }
+            Sum s = ripple_add(a, corr, false);
+            return pack(s.value, szp(s.value) | (s.c3 ? FLAG_AC : 0) | (out_cy ? FLAG_CY : 0));
+        }
+        case 0x07: return pack(uint8_t((a << 1) | (a >> 7)),  keep | ((a & 0x80) ? FLAG_CY : 0));
+        case 0x0F: return pack(uint8_t((a >> 1) | (a << 7)),  keep | ((a & 0x01) ? FLAG_CY : 0));
+        case 0x17: return pack(uint8_t((a << 1) | (cy ? 1 : 0)),    keep | ((a & 0x80) ? FLAG_CY : 0));
+        case 0x1F: return pack(uint8_t((a >> 1) | (cy ? 0x80 : 0)), keep | ((a & 0x01) ? FLAG_CY : 0));
+        case 0x2F: return pack(uint8_t(~a), f);
+        case 0x37: return pack(a, f | FLAG_CY);
+        default:   return pack(a, f ^ FLAG_CY);        // CMC
+    }
+}
+
+// ─── Jobs ─────────────────────────────────────────────────────────────────────
+struct Job {
+    const Opcode* opcode;
+    uint8_t       operand;
+};
+
+// One engine's view of a job: the result table, cycles and registers that
+// the program must leave untouched.
+struct Outcome {
+    uint16_t psw[LANES];
+    uint64_t cycles;
+    uint8_t  B;
+    uint16_t HL, SP, PC;
+    bool     halted;
+};
+
+uint64_t program_instructions() { return uint64_t(LANES) * 5 + 1; }
+
+void prepare(State8080& s, const Job& job) {
+    const Opcode& o = *job.opcode;
+    uint16_t pc = CODE_ORG;
+    for (int i = 0; i < LANES; ++i) {
+        s.mem[pc++] = 0xF1;                            // POP PSW
+        s.mem[pc++] = o.op;
+        if (o.operand == Operand::Imm) s.mem[pc++] = job.operand;
+        s.mem[pc++] = 0xF5;                            // PUSH PSW
+        s.mem[pc++] = 0x33;                            // INX SP
+        s.mem[pc++] = 0x33;                            // INX SP
+    }
+    s.mem[pc] = 0x76;                                  // HLT
+    for (int i = 0; i < LANES; ++i) s.write16(uint16_t(TABLE_ORG + 2 * i), lane_psw(i));
+    s.mem[OPERAND_M] = job.operand;
+
+    s.A = 0; s.F = FLAG_FIXED;
+    s.B = job.operand; s.C = 0; s.D = 0; s.E = 0;
+    s.setHL(OPERAND_M);
+    s.SP = TABLE_ORG;
+    s.PC = CODE_ORG;
+    s.inte = false;
+    s.halted = false;
+}
+
+void execute(const Engine& engine, State8080& s, IOBus& io, const Job& job, Outcome& out) {
+    prepare(s, job);
+    out.cycles = engine.run(s, io, program_instructions());
+    for (int i = 0; i < LANES; ++i) out.psw[i] = s.read16(uint16_t(TABLE_ORG + 2 * i));
+    out.B = s.B; out.HL = s.HL(); out.SP = s.SP; out.PC = s.PC;
+    out.halted = s.halted;
+}
+
+// ─── Reporting ────────────────────────────────────────────────────────────────
+class Report {
+public:
+    explicit Report(uint64_t limit) : limit_(limit) {}
+
+    void lane(const char* engine, const Job& job, int i, uint16_t expected, uint16_t got, const char* against) {
+        std::lock_guard<std::mutex> lock(m_);
+        if (++failures_ > limit_) return;
+        uint16_t in = lane_psw(i);
+        std::printf("MISMATCH %-10s %-6s operand=%02X  in: A=%02X CY=%d AC=%d  %s: A=%02X F=%02X  got: A=%02X F=%02X\n",
+                    engine, job.opcode->name, job.operand, in >> 8, (in & FLAG_CY) != 0, (in & FLAG_AC) != 0,
+                    against, expected >> 8, expected & 0xFF, got >> 8, got & 0xFF);
+    }
+    void state(const char* engine, const Job& job, const char* what) {
+        std::lock_guard<std::mutex> lock(m_);
+        if (++failures_ > limit_) return;
+        std::printf("MISMATCH %-10s %-6s operand=%02X  %s differs from reference\n",
+                    engine, job.opcode->name, job.operand, what);
+    }
+    uint64_t failures() const { return failures_; }
+
+private:
+    std::mutex m_;
+    uint64_t   failures_ = 0;
+    uint64_t   limit_;
+};
+
+void usage(const char* argv0) {
+    std::fprintf(stderr, "Usage: %s [--threads N] [--engine NAME] [--max-report N]\n", argv0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    unsigned    threads     = std::max(1u, std::thread::hardware_concurrency());
+    const char* only_engine = nullptr;
+    uint64_t    max_report  = 20;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) { usage(argv[0]); return 2; }
+        if      (std::strcmp(argv[i], "--threads")    == 0) threads     = unsigned(std::max(1, std::atoi(argv[++i])));
+        else if (std::strcmp(argv[i], "--engine")     == 0) only_engine = argv[++i];
+        else if (std::strcmp(argv[i], "--max-report") == 0) max_report  = std::strtoull(argv[++i], nullptr, 0);
+        else { usage(argv[0]); return 2; }
+    }
+
+    const std::vector<Engine>& engines = Engines();
+    std::vector<const Engine*> checked;
+    for (const Engine& e : engines)
+        if (!only_engine || std::strcmp(e.name, only_engine) == 0) checked.push_back(&e);
+    if (checked.empty()) {
+        std::fprintf(stderr, "Unknown engine '%s'\n", only_engine);
+        return 2;
+    }
+
+    std::vector<Job> jobs;
+    for (const Opcode& o : opcodes()) {
+        bool takes_operand = o.operand == Operand::Reg || o.operand == Operand::Mem || o.operand == Operand::Imm;
+        for (int v = 0; v < (takes_operand ? 256 : 1); ++v) jobs.push_back({&o, uint8_t(v)});
+    }
+
+    Report report(max_report);
+    std::atomic<size_t> next{0};
+    auto t0 = std::chrono::steady_clock::now();
+
+    auto worker = [&] {
+        State8080 s;
+        IOBus     io;
+        Outcome   ref, got;
+        for (size_t j; (j = next.fetch_add(1, std::memory_order_relaxed)) < jobs.size();) {
+            const Job& job = jobs[j];
+            execute(engines[0], s, io, job, ref);
+
+            for (const Engine* e : checked) {
+                const Outcome* o = &ref;
+                if (e != &engines[0]) {
+                    execute(*e, s, io, job, got);
+                    o = &got;
+                    if (o->cycles != ref.cycles) report.state(e->name, job, "cycle count");
+                    if (o->B != ref.B || o->HL != ref.HL || o->SP != ref.SP || o->PC != ref.PC || o->halted != ref.halted)
+                        report.state(e->name, job, "register state");
+                }
+                for (int i = 0; i < LANES; ++i) {
+                    uint16_t in       = lane_psw(i);
+                    uint8_t  operand  = job.opcode->operand == Operand::Self ? uint8_t(in >> 8) : job.operand;
+                    uint16_t expected = model(job.opcode->op, operand, in);
+                    if (o->psw[i] != expected) report.lane(e->name, job, i, expected, o->psw[i], "model");
+                    if (o != &ref && o->psw[i] != ref.psw[i])
+                        report.lane(e->name, job, i, ref.psw[i], o->psw[i], "reference");
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) pool.emplace_back(worker);
+    for (std::thread& t : pool) t.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    uint64_t cases = uint64_t(jobs.size()) * LANES;
+    std::printf("%zu opcodes, %llu cases x %zu engine(s) on %u thread(s) in %.2f s: ",
+                opcodes().size(), static_cast<unsigned long long>(cases), checked.size(), threads, seconds);
+    if (report.failures()) {
+        std::printf("%llu mismatches\n", static_cast<unsigned long long>(report.failures()));
+        return 1;
+    }
+    std::printf("all conform\n");
+    return 0;
+}
@@ -0,0 +1,804 @@
+// ─── native8080_aot ───────────────────────────────────────────────────────────
+// Ahead-of-time translator: turns an 8080 program image into a C++ source
+// file that, compiled and linked against the core, runs the program's code
+// natively (see aot.h for how translated code runs and stays exact).
+//
+//   native8080_aot [-o OUT.cpp] [--name NAME] [--origin ADDR] [--entry ADDR]... IMAGE
+//
+// The origin defaults to 0x0100 (a CP/M .COM) and is the first entry point.
+// Code is found by recursive descent from the entries: both ways of every
+// conditional branch, call targets and the return sites after them (a call
+// is assumed to return), RST vectors, and the instruction after a HLT.
+// Control transfers whose target cannot be known (RET, PCHL) go through a
+// dispatch switch over all blocks at run time, and code never found here —
+// reached through a computed jump, or written at run time — is interpreted.
+// Every block ends at a control transfer, at IN, OUT or EI, or where another
+// block starts.  Within a block, flags that are set again before anything
+// reads them are not computed, and registers the block has loaded with
+// constants are folded into operands and addresses; both are exact wherever
+// the block leaves.
+//
+// Link the output with tools/aotmain.cpp for a stand-alone CP/M program, or
+// into a program that calls Runner::set_translation() itself.
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::string format(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+std::string format(const char* fmt, ...) {
+    char buf[512];
+    va_list ap;
+    va_start(ap, fmt);
+    std::vsnprintf(buf, sizeof buf, fmt, ap);
+    va_end(ap);
+    return buf;
+}
+
+// ─── Decoding ─────────────────────────────────────────────────────────────────
+const char* const REG[8]  = {"B", "C", "D", "E", "H", "L", "M", "A"};
+const char* const RP[4]   = {"B", "D", "H", "SP"};
+const char* const COND[8] = {"NZ", "Z", "NC", "C", "PO", "PE", "P", "M"};
+const char* const ALU[8]  = {"ADD", "ADC", "SUB", "SBB", "ANA", "XRA", "ORA", "CMP"};
+const char* const ALUI[8] = {"ADI", "ACI", "SUI", "SBI", "ANI", "XRI", "ORI", "CPI"};
+
+int length(uint8_t op) {
+    switch (op) {
+        case 0x01: case 0x11: case 0x21: case 0x31:            // LXI
+        case 0x22: case 0x2A: case 0x32: case 0x3A:            // SHLD LHLD STA LDA
+        case 0xC3: case 0xCB:                                  // JMP
+        case 0xCD: case 0xDD: case 0xED: case 0xFD:            // CALL
+            return 3;
+        case 0xD3: case 0xDB:                                  // OUT IN
+            return 2;
+    }
+    if ((op & 0xC7) == 0xC2 || (op & 0xC7) == 0xC4) return 3;  // Jcc Ccc
+    if ((op & 0xC7) == 0x06 || (op & 0xC7) == 0xC6) return 2;  // MVI, ALU immediate
+    return 1;
+}
+
+struct Insn {
+    uint16_t addr;
+    uint8_t  op;
+    uint8_t  imm8;
+    uint16_t imm16;
+    int      len;
+
+    bool is_jmp()  const { return op == 0xC3 || op == 0xCB; }
+    bool is_jcc()  const { return (op & 0xC7) == 0xC2; }
+    bool is_call() const { return op == 0xCD || op == 0xDD || op == 0xED || op == 0xFD; }
+    bool is_ccc()  const { return (op & 0xC7) == 0xC4; }
+    bool is_ret()  const { return op == 0xC9 || op == 0xD9; }
+    bool is_rcc()  const { return (op & 0xC7) == 0xC0; }
+    bool is_rst()  const { return (op & 0xC7) == 0xC7; }
+    bool is_io()   const { return op == 0xD3 || op == 0xDB; }
+
+    // Ends a block.
+    bool ends() const {
+        return is_jmp() || is_jcc() || is_call() || is_ccc() || is_ret() || is_rcc() || is_rst() ||
+               op == 0xE9 || op == 0x76 || op == 0xFB || is_io();
+    }
+    // Execution may continue with the next instruction.
+    bool falls_through() const { return !(is_jmp() || is_ret() || op == 0xE9); }
+    // A static target: jump and call destinations and RST vectors.
+    bool has_target() const { return is_jmp() || is_jcc() || is_call() || is_ccc() || is_rst(); }
+    uint16_t target() const { return is_rst() ? uint16_t(op & 0x38) : imm16; }
+    uint16_t next()   const { return uint16_t(addr + len); }
+
+    std::string text() const;
+};
+
+std::string Insn::text() const {
+    const uint8_t ddd = (op >> 3) & 7, sss = op & 7, rp = (op >> 4) & 3;
+    if (op == 0x76)                 return "HLT";
+    if (op >= 0x40 && op < 0x80)    return format("MOV  %s,%s", REG[ddd], REG[sss]);
+    if (op >= 0x80 && op < 0xC0)    return format("%s  %s", ALU[ddd], REG[sss]);
+    if ((op & 0xC7) == 0x06)        return format("MVI  %s,%02XH", REG[ddd], imm8);
+    if ((op & 0xC7) == 0xC6)        return format("%s  %02XH", ALUI[ddd], imm8);
+    if ((op & 0xC7) == 0x04)        return format("INR  %s", REG[ddd]);
+    if ((op & 0xC7) == 0x05)        return format("DCR  %s", REG[ddd]);
+    if ((op & 0xCF) == 0x01)        return format("LXI  %s,%04XH", RP[rp], imm16);
+    if ((op & 0xCF) == 0x03)        return format("INX  %s", RP[rp]);
+    if ((op & 0xCF) == 0x0B)        return format("DCX  %s", RP[rp]);
+    if ((op & 0xCF) == 0x09)        return format("DAD  %s", RP[rp]);
+    if ((op & 0xCF) == 0xC5)        return format("PUSH %s", rp == 3 ? "PSW" : RP[rp]);
+    if ((op & 0xCF) == 0xC1)        return format("POP  %s", rp == 3 ? "PSW" : RP[rp]);
+    if (is_jmp())                   return format("JMP  %04XH", imm16);
+    if (is_jcc())                   return format("J%-3s %04XH", COND[ddd], imm16);
+    if (is_call())                  return format("CALL %04XH", imm16);
+    if (is_ccc())                   return format("C%-3s %04XH", COND[ddd], imm16);
+    if (is_ret())                   return "RET";
+    if (is_rcc())                   return format("R%s", COND[ddd]);
+    if (is_rst())                   return format("RST  %d", ddd);
+    switch (op) {
+        case 0x02: return "STAX B";
+        case 0x12: return "STAX D";
+        case 0x0A: return "LDAX B";
+        case 0x1A: return "LDAX D";
+        case 0x22: return format("SHLD %04XH", imm16);
+        case 0x2A: return format("LHLD %04XH", imm16);
+        case 0x32: return format("STA  %04XH", imm16);
+        case 0x3A: return format("LDA  %04XH", imm16);
+        case 0x07: return "RLC";
+        case 0x0F: return "RRC";
+        case 0x17: return "RAL";
+        case 0x1F: return "RAR";
+        case 0x27: return "DAA";
+        case 0x2F: return "CMA";
+        case 0x37: return "STC";
+        case 0x3F: return "CMC";
+        case 0xD3: return format("OUT  %02XH", imm8);
+        case 0xDB: return format("IN   %02XH", imm8);
+        case 0xE3: return "XTHL";
+        case 0xE9: return "PCHL";
+        case 0xEB: return "XCHG";
+        case 0xF3: return "DI";
+        case 0xF9: return "SPHL";
+        case 0xFB: return "EI";
+    }
+    return "NOP";
+}
+
+// Cycles the instruction takes; the longer way for conditional calls and
+// returns.
+int cycles(const Insn& in) {
+    const uint8_t op = in.op;
+    if (op == 0x76) return 7;
+    if (op >= 0x40 && op < 0x80) return ((op & 7) == 6 || (op & 0x38) == 0x30) ? 7 : 5;
+    if (op >= 0x80 && op < 0xC0) return (op & 7) == 6 ? 7 : 4;
+    if ((op & 0xC7) == 0x06) return (op & 0x38) == 0x30 ? 10 : 7;
+    if ((op & 0xC7) == 0xC6) return 7;
+    if ((op & 0xC6) == 0x04) return (op & 0x38) == 0x30 ? 10 : 5;   // INR DCR
+    if ((op & 0xCF) == 0x01) return 10;
+    if ((op & 0xC7) == 0x03) return 5;                               // INX DCX
+    if ((op & 0xCF) == 0x09) return 10;
+    if ((op & 0xCF) == 0xC5) return 11;
+    if ((op & 0xCF) == 0xC1) return 10;
+    if (in.is_jmp() || in.is_jcc()) return 10;
+    if (in.is_call() || in.is_ccc()) return 17;
+    if (in.is_ret()) return 10;
+    if (in.is_rcc() || in.is_rst()) return 11;
+    switch (op) {
+        case 0x02: case 0x12: case 0x0A: case 0x1A: return 7;
+        case 0x22: case 0x2A: return 16;
+        case 0x32: case 0x3A: return 13;
+        case 0xD3: case 0xDB: return 10;
+        case 0xE3: return 18;
+        case 0xE9: case 0xF9: return 5;
+    }
+    return 4;
+}
+
+// ── Flags ──
+constexpr uint8_t FLAG_S = 0x80, FLAG_Z = 0x40, FLAG_AC = 0x10, FLAG_P = 0x04, FLAG_CY = 0x01;
+constexpr uint8_t FLAGS  = FLAG_S | FLAG_Z | FLAG_AC | FLAG_P | FLAG_CY;
+
+// The flags an instruction sets.
+uint8_t flags_set(const Insn& in) {
+    const uint8_t op = in.op;
+    if ((op >= 0x80 && op < 0xC0) || (op & 0xC7) == 0xC6) return FLAGS;      // ALU
+    if ((op & 0xC6) == 0x04) return FLAGS & ~FLAG_CY;                       // INR DCR
+    if ((op & 0xCF) == 0x09) return FLAG_CY;                                 // DAD
+    switch (op) {
+        case 0x07: case 0x0F: case 0x17: case 0x1F:                          // rotates
+        case 0x37: case 0x3F:                                                // STC CMC
+            return FLAG_CY;
+        case 0x27: case 0xF1:                                                // DAA, POP PSW
+            return FLAGS;
+    }
+    return 0;
+}
+
+// The flags an instruction reads.
+uint8_t flags_used(const Insn& in) {
+    static const uint8_t COND_FLAG[8] = {FLAG_Z, FLAG_Z, FLAG_CY, FLAG_CY, FLAG_P, FLAG_P, FLAG_S, FLAG_S};
+    const uint8_t op = in.op;
+    if (in.is_jcc() || in.is_ccc() || in.is_rcc()) return COND_FLAG[(op >> 3) & 7];
+    if ((op & 0xF0) == 0x80 && (op & 0x08)) return FLAG_CY;                  // ADC
+    if ((op & 0xF0) == 0x90 && (op & 0x08)) return FLAG_CY;                  // SBB
+    switch (op) {
+        case 0xCE: case 0xDE:                                                // ACI SBI
+        case 0x17: case 0x1F: case 0x3F:                                     // RAL RAR CMC
+            return FLAG_CY;
+        case 0x27: return FLAG_AC | FLAG_CY;                                 // DAA
+        case 0xF5: return FLAGS;                                             // PUSH PSW
+    }
+    return 0;
+}
+
+// ─── Constants ────────────────────────────────────────────────────────────────
+// Registers known to hold a constant at an instruction, from what the block
+// itself loads (MVI, LXI, and what follows from those).  Translation folds
+// them into operands and memory addresses; the registers are still written,
+// so the state is exact wherever the block leaves.
+struct Known {
+    std::optional<uint8_t> reg[8];                  // by operand number; M never
+
+    bool has_pair(uint8_t rp) const { return rp < 3 && reg[rp * 2] && reg[rp * 2 + 1]; }
+    uint16_t pair(uint8_t rp) const { return uint16_t(*reg[rp * 2] << 8 | *reg[rp * 2 + 1]); }
+
+    void set_pair(uint8_t rp, std::optional<uint16_t> v) {
+        if (rp == 3) return;                        // SP is not tracked
+        reg[rp * 2]     = v ? std::optional<uint8_t>(uint8_t(*v >> 8)) : std::nullopt;
+        reg[rp * 2 + 1] = v ? std::optional<uint8_t>(uint8_t(*v)) : std::nullopt;
+    }
+
+    // The address the instruction reaches memory at through HL, BC or DE,
+    // if it does and the pair is known.
+    std::optional<uint16_t> address(const Insn& in) const {
+        const uint8_t op = in.op;
+        const bool m = (op >= 0x40 && op < 0xC0 && op != 0x76 && ((op & 7) == 6 || (op & 0xF8) == 0x70)) ||
+                       op == 0x34 || op == 0x35 || op == 0x36;
+        const int rp = m ? 2 : op == 0x02 || op == 0x0A ? 0 : op == 0x12 || op == 0x1A ? 1 : -1;
+        if (rp < 0 || !has_pair(uint8_t(rp))) return std::nullopt;
+        return pair(uint8_t(rp));
+    }
+
+    // What is known after the instruction.
+    void step(const Insn& in);
+};
+
+void Known::step(const Insn& in) {
+    const uint8_t op = in.op, ddd = (op >> 3) & 7, sss = op & 7, rp = (op >> 4) & 3;
+    std::optional<uint8_t>& a = reg[7];
+    if (op >= 0x40 && op < 0x80) {                                          // MOV
+        if (ddd != 6) reg[ddd] = sss == 6 ? std::nullopt : reg[sss];
+    } else if ((op >= 0x80 && op < 0xC0) || (op & 0xC7) == 0xC6) {          // ALU
+        const bool    has_v = op >= 0xC0 || (sss != 6 && reg[sss]);
+        const uint8_t v     = op >= 0xC0 ? in.imm8 : has_v ? *reg[sss] : 0;
+        if (op == 0x97 || op == 0xAF) a = 0;                                 // SUB A, XRA A
+        else if (ddd == 7) {}                                                // CMP
+        else if (ddd == 1 || ddd == 3 || !a || !has_v) a = std::nullopt;
+        else if (ddd == 0) a = uint8_t(*a + v);
+        else if (ddd == 2) a = uint8_t(*a - v);
+        else if (ddd == 4) a = uint8_t(*a & v);
+        else if (ddd == 5) a = uint8_t(*a ^ v);
+        else a = uint8_t(*a | v);
+    } else if ((op & 0xC7) == 0x06) {                                       // MVI
+        if (ddd != 6) reg[ddd] = in.imm8;
+    } else if ((op & 0xC6) == 0x04) {                                       // INR DCR
+        if (ddd != 6 && reg[ddd]) reg[ddd] = uint8_t(*reg[ddd] + (op & 1 ? -1 : 1));
+    } else if ((op & 0xCF) == 0x01) {                                       // LXI
+        set_pair(rp, in.imm16);
+    } else if ((op & 0xC7) == 0x03) {                                       // INX DCX
+        set_pair(rp, has_pair(rp) ? std::optional<uint16_t>(uint16_t(pair(rp) + (op & 8 ? -1 : 1)))
+                                  : std::nullopt);
+    } else if ((op & 0xCF) == 0x09) {                                       // DAD
+        set_pair(2, has_pair(2) && has_pair(rp) ? std::optional<uint16_t>(uint16_t(pair(2) + pair(rp)))
+                                                : std::nullopt);
+    } else if ((op & 0xCF) == 0xC1) {                                       // POP
+        if (rp == 3) a = std::nullopt;
+        else set_pair(rp, std::nullopt);
+    } else {
+        switch (op) {
+            case 0x0A: case 0x1A: case 0x3A: case 0x17: case 0x1F: case 0x27: case 0xDB:
+                a = std::nullopt;
+                break;
+            case 0x2A: case 0xE3: set_pair(2, std::nullopt); break;      // LHLD XTHL
+            case 0xEB: std::swap(reg[2], reg[4]); std::swap(reg[3], reg[5]); break;
+            case 0x2F: if (a) a = uint8_t(~*a); break;
+            case 0x07: if (a) a = uint8_t(*a << 1 | *a >> 7); break;
+            case 0x0F: if (a) a = uint8_t(*a >> 1 | *a << 7); break;
+        }
+    }
+}
+
+// Whether the instruction may store into [first, end), knowing `k`.
+bool may_write(const Insn& in, const Known& k, uint16_t first, uint16_t end) {
+    if (first == end) return false;
+    const auto inside = [&](uint16_t a) { return uint16_t(a - first) < uint16_t(end - first); };
+    const uint8_t op = in.op;
+    if (op == 0x32) return inside(in.imm16);                                 // STA
+    if (op == 0x22) return inside(in.imm16) || inside(uint16_t(in.imm16 + 1)); // SHLD
+    const bool store = (op >= 0x70 && op < 0x78 && op != 0x76) || op == 0x34 || op == 0x35 || op == 0x36 ||
+                       op == 0x02 || op == 0x12;
+    if (store) {
+        const std::optional<uint16_t> addr = k.address(in);
+        return !addr || inside(*addr);
+    }
+    return op == 0xE3 || (op & 0xCF) == 0xC5;                               // XTHL PUSH
+}
+
+// ─── Control flow ─────────────────────────────────────────────────────────────
+struct Block {
+    uint16_t          addr;
+    std::vector<Insn> insns;
+    int               max_cycles = 0;
+    uint16_t          size       = 0;    // bytes
+};
+
+class Program {
+public:
+    Program(std::vector<uint8_t> image, uint16_t origin) : image_(std::move(image)), origin_(origin) {
+        if (image_.empty()) throw std::runtime_error("empty image");
+        if (origin_ + image_.size() > 0x10000) throw std::runtime_error("image runs past 0xFFFF");
+    }
+
+    void discover(const std::vector<uint16_t>& entries);
+    void form_blocks();
+
+    std::string emit(const std::string& name, const std::string& source) const;
+
+private:
+    // The instruction at `addr`, if it lies wholly inside the image.
+    bool decode(uint16_t addr, Insn& in) const {
+        if (addr < origin_ || addr >= origin_ + image_.size()) return false;
+        const size_t   at = addr - origin_;
+        const uint8_t  op = image_[at];
+        const int      n  = length(op);
+        if (at + n > image_.size()) return false;
+        in = {addr, op, n > 1 ? image_[at + 1] : uint8_t(0),
+              n > 2 ? uint16_t(image_[at + 1] | image_[at + 2] << 8) : uint16_t(0), n};
+        return true;
+    }
+
+    bool is_block(uint16_t addr) const { return blocks_.count(addr) != 0; }
+    bool is_code(uint16_t addr) const { return code_[addr >> 6] >> (addr & 63) & 1; }
+
+    std::string emit_block(const Block& b, std::set<uint16_t>& chained) const;
+    std::string operation(const Insn& in, uint8_t live, const Known& k) const;
+    std::string reg_write(uint8_t r, const std::string& value, const Known& k) const;
+    std::string store(const std::string& addr, std::optional<uint16_t> known, const std::string& value) const;
+    std::string jump(uint16_t target, std::set<uint16_t>& chained) const;
+
+    std::vector<uint8_t>       image_;
+    uint16_t                   origin_;
+    std::map<uint16_t, Insn>   insns_;      // every instruction found
+    std::set<uint16_t>         leaders_;
+    std::map<uint16_t, Block>  blocks_;
+    std::vector<uint64_t>      code_;       // 64K-bit map of the blocks' bytes
+};
+
+void Program::discover(const std::vector<uint16_t>& entries) {
+    std::vector<uint16_t> work(entries.begin(), entries.end());
+    for (uint16_t e : entries) leaders_.insert(e);
+    while (!work.empty()) {
+        const uint16_t addr = work.back();
+        work.pop_back();
+        Insn in;
+        if (insns_.count(addr) || !decode(addr, in)) continue;
+        insns_[addr] = in;
+        if (in.has_target()) {
+            leaders_.insert(in.target());
+            work.push_back(in.target());
+        }
+        if (in.falls_through()) {
+            if (in.ends()) leaders_.insert(in.next());
+            work.push_back(in.next());
+        }
+    }
+}
+
+// Blocks run from each leader to the first instruction that ends one or
+// reaches the next leader.  Blocks are capped in length so that one always
+// fits in a short slice.
+void Program::form_blocks() {
+    constexpr size_t MAX_INSNS = 64;
+    for (auto it = leaders_.begin(); it != leaders_.end(); ++it) {
+        if (!insns_.count(*it)) continue;           // outside the image
+        Block b{*it, {}};
+        uint16_t pc = *it;
+        for (;;) {
+            const Insn& in = insns_.at(pc);
+            b.insns.push_back(in);
+            b.max_cycles += cycles(in);
+            b.size        = uint16_t(b.size + in.len);
+            pc = in.next();
+            if (in.ends() || leaders_.count(pc) || !insns_.count(pc)) break;
+            if (b.insns.size() == MAX_INSNS) {
+                leaders_.insert(pc);                // visited later by this loop
+                break;
+            }
+        }
+        blocks_[b.addr] = std::move(b);
+    }
+    code_.assign(1024, 0);
+    for (const auto& [addr, b] : blocks_)
+        for (const Insn& in : b.insns)
+            for (int i = 0; i < in.len; ++i) {
+                const uint16_t a = uint16_t(in.addr + i);
+                code_[a >> 6] |= uint64_t(1) << (a & 63);
+            }
+}
+
+// ─── Emission ─────────────────────────────────────────────────────────────────
+// Each instruction becomes a statement or two over the registers, which run()
+// keeps in locals (A, F, B, C, D, E, H, L, SP) for as long as it runs, with
+// its operands as literals; the counters are locals too, added to once per
+// exit from a block.  The State8080 and the runner see them at `done` and
+// around IN and OUT only.
+// Registers known to be constant (Known) read as literals, and a store to a
+// known address outside translated code is a plain write.
+// Operations that set flags compute only those read before being set again
+// (their template argument; ALL for every flag).
+// A block has two labels: B_xxxx, reached from another block, which checks
+// that it fits in what is left of the slice, and E_xxxx, reached from the
+// dispatch switch, which has checked that already.
+
+std::string hex16(uint16_t v) { return format("0x%04X", v); }
+
+std::string reg_read(uint8_t r, const Known& k) {
+    static const char* const R[8] = {"B", "C", "D", "E", "H", "L", "m[pair(H, L)]", "A"};
+    if (r == 6) return k.has_pair(2) ? "m[" + hex16(k.pair(2)) + "]" : R[6];
+    return k.reg[r] ? format("0x%02X", *k.reg[r]) : R[r];
+}
+
+std::string pair_read(uint8_t rp, const Known& k) {
+    static const char* const RP_READ[4] = {"pair(B, C)", "pair(D, E)", "pair(H, L)", "SP"};
+    return k.has_pair(rp) ? hex16(k.pair(rp)) : RP_READ[rp];
+}
+
+std::string pair_write(uint8_t rp, const std::string& value) {
+    static const char* const HI_LO[3] = {"B, C", "D, E", "H, L"};
+    if (rp == 3) return "SP = " + value + ";";
+    return format("split(%s, ", HI_LO[rp]) + value + ");";
+}
+
+std::string condition(uint8_t ccc) {
+    static const char* const C[8] = {"!(F & FLAG_Z)", "F & FLAG_Z", "!(F & FLAG_CY)", "F & FLAG_CY",
+                                     "!(F & FLAG_P)", "F & FLAG_P", "!(F & FLAG_S)",  "F & FLAG_S"};
+    return C[ccc & 7];
+}
+
+std::string mask(uint8_t live) { return live == FLAGS ? "ALL" : format("0x%02X", live); }
+
+// Store `value` at `addr`, or at the constant `known` if there is one.
+std::string Program::store(const std::string& addr, std::optional<uint16_t> known,
+                           const std::string& value) const {
+    if (!known) return "m.store(" + addr + ", " + value + ");";
+    if (is_code(*known)) return "m.store(" + hex16(*known) + ", " + value + ");";
+    return "m.mem[" + hex16(*known) + "] = " + value + ";";
+}
+
+std::string Program::reg_write(uint8_t r, const std::string& value, const Known& k) const {
+    if (r == 6) return store("pair(H, L)", k.has_pair(2) ? std::optional<uint16_t>(k.pair(2)) : std::nullopt, value);
+    static const char* const R[8] = {"B", "C", "D", "E", "H", "L", "", "A"};
+    return R[r] + (" = " + value) + ";";
+}
+
+// The statement for a plain (non-control) instruction, computing the flags
+// in `live` of those it sets, with what is known before it.
+std::string Program::operation(const Insn& in, uint8_t live, const Known& k) const {
+    const uint8_t op = in.op, ddd = (op >> 3) & 7, sss = op & 7, rp = (op >> 4) & 3;
+    const std::string imm8  = format("0x%02X", in.imm8);
+    const std::string imm16 = hex16(in.imm16);
+    const std::string m     = format("<%s>", mask(live).c_str());
+
+    if (op >= 0x40 && op < 0x80) return reg_write(ddd, reg_read(sss, k), k);
+    if ((op >= 0x80 && op < 0xC0) || (op & 0xC7) == 0xC6) {
+        const std::string v = op < 0xC0 ? reg_read(sss, k) : imm8;
+        switch (ddd) {
+            case 0: return "add" + m + "(A, F, " + v + ");";
+            case 1: return "add" + m + "(A, F, " + v + ", F & FLAG_CY);";
+            case 2: return "sub" + m + "(A, F, " + v + ");";
+            case 3: return "sub" + m + "(A, F, " + v + ", F & FLAG_CY);";
+            case 4: return "ana" + m + "(A, F, " + v + ");";
+            case 5: return "xra" + m + "(A, F, " + v + ");";
+            case 6: return "ora" + m + "(A, F, " + v + ");";
+            default: return live ? "cmp" + m + "(A, F, " + v + ");" : "";
+        }
+    }
+    if ((op & 0xC7) == 0x06) return reg_write(ddd, imm8, k);
+    if ((op & 0xC7) == 0x04 || (op & 0xC7) == 0x05)
+        return reg_write(ddd, std::string((op & 1) ? "dcr" : "inr") + m + "(F, " + reg_read(ddd, k) + ")", k);
+    if ((op & 0xCF) == 0x01) return pair_write(rp, imm16);
+    if ((op & 0xC7) == 0x03) {
+        const int d = op & 8 ? -1 : 1;
+        if (k.has_pair(rp)) return pair_write(rp, hex16(uint16_t(k.pair(rp) + d)));
+        return pair_write(rp, "uint16_t(" + pair_read(rp, k) + (d > 0 ? " + 1)" : " - 1)"));
+    }
+    if ((op & 0xCF) == 0x09) return pair_write(2, "dad" + m + "(F, " + pair_read(2, k) + ", " + pair_read(rp, k) + ")");
+    if ((op & 0xCF) == 0xC5) return "push(m, SP, " + (rp == 3 ? std::string("pair(A, F)") : pair_read(rp, k)) + ");";
+    if ((op & 0xCF) == 0xC1) {
+        if (rp != 3) return pair_write(rp, "pop(m, SP)");
+        return "{ const uint16_t t = pop(m, SP); A = uint8_t(t >> 8); F = uint8_t(t | FLAG_FIXED); }";
+    }
+    switch (op) {
+        case 0x02: case 0x12: return store(pair_read(rp, k), k.address(in), "A");
+        case 0x0A: case 0x1A: return "A = m[" + pair_read(rp, k) + "];";
+        case 0x22: return store(imm16, in.imm16, "L") + " " + store("", uint16_t(in.imm16 + 1), "H");
+        case 0x2A: return "L = m[" + imm16 + "]; H = m[" + hex16(uint16_t(in.imm16 + 1)) + "];";
+        case 0x32: return store(imm16, in.imm16, "A");
+        case 0x3A: return "A = m[" + imm16 + "];";
+        case 0x07: return "rlc" + m + "(A, F);";
+        case 0x0F: return "rrc" + m + "(A, F);";
+        case 0x17: return "ral" + m + "(A, F);";
+        case 0x1F: return "rar" + m + "(A, F);";
+        case 0x27: return "daa" + m + "(A, F);";
+        case 0x2F: return "A = uint8_t(~A);";
+        case 0x37: return live ? "F |= FLAG_CY;" : "";
+        case 0x3F: return live ? "F ^= FLAG_CY;" : "";
+        case 0xE3:
+            return "{ const uint8_t l = m[SP], h = m[uint16_t(SP + 1)]; "
+                   "m.store(SP, L); m.store(uint16_t(SP + 1), H); L = l; H = h; }";
+        case 0xEB: return "std::swap(H, D); std::swap(L, E);";
+        case 0xF3: return "s.inte = false;";
+        case 0xF9: return "SP = " + pair_read(2, k) + ";";
+        case 0xFB: return "s.inte = true;";
+    }
+    return "";                                      // NOP and its aliases
+}
+
+std::string tick(int cycles, int insns) { return format("cycles += %d; insns += %d;", cycles, insns); }
+
+std::string leave(uint16_t pc) { return "{ s.PC = " + hex16(pc) + "; goto done; }"; }
+
+// Continue at `target`: in its block if it has one, else back in the runner.
+std::string Program::jump(uint16_t target, std::set<uint16_t>& chained) const {
+    if (!is_block(target)) return leave(target);
+    chained.insert(target);
+    return format("goto B_%04X;", target);
+}
+
+std::string Program::emit_block(const Block& b, std::set<uint16_t>& chained) const {
+    // ── Constants, forwards from the start of the block, where nothing is
+    //    known ──
+    const size_t   count = b.insns.size();
+    const uint16_t end   = uint16_t(b.addr + b.size);
+    std::vector<Known> known(count);
+    for (size_t i = 1; i < count; ++i) {
+        known[i] = known[i - 1];
+        known[i].step(b.insns[i - 1]);
+    }
+
+    // ── Flag liveness, backwards from the end of the block: every flag is
+    //    live wherever the block may leave, which between its ends is only
+    //    after a store that may have changed the block's own remaining bytes ──
+    std::vector<bool>    checked(count);
+    std::vector<uint8_t> live(count);
+    uint8_t after = FLAGS;
+    for (size_t i = count; i-- > 0;) {
+        const Insn& in = b.insns[i];
+        checked[i] = may_write(in, known[i], in.next(), end);
+        if (checked[i]) after = FLAGS;
+        live[i] = after & flags_set(in);
+        after   = uint8_t((after & ~flags_set(in)) | flags_used(in));
+    }
+
+    std::string out;
+    const auto line = [&](const std::string& code, const Insn* in = nullptr) {
+        std::string l = "    " + code;
+        if (in) {
+            if (l.size() < 60) l.resize(60, ' ');
+            l += format("  // %04X  %s", in->addr, in->text().c_str());
+        }
+        out += l + "\n";
+    };
+
+    int cyc = 0, n = 0;                             // not yet added to the counters
+    for (size_t i = 0; i < count; ++i) {
+        const Insn&       in   = b.insns[i];
+        const std::string next = hex16(in.next());
+        ++n;
+        if (in.is_io()) {
+            // The handler sees the counters as of the start of the instruction
+            // and the registers and PC as the interpreter has them (a console
+            // poll looks at PC), and may change any of them.
+            if (n > 1) line(tick(cyc, n - 1));
+            line("s.PC = " + next + "; spill();", &in);
+            line(in.op == 0xDB ? format("s.A = in(cx, 0x%02X);", in.imm8)
+                               : format("out(cx, 0x%02X, s.A);", in.imm8));
+            line("reload(); " + tick(10, 1));
+            n = 0;
+        } else if (in.is_jcc()) {
+            line(tick(cyc + 10, n), &in);
+            line("if (" + condition(in.op >> 3) + ") " + jump(in.target(), chained));
+            n = 0;
+        } else if (in.is_ccc()) {
+            line("if (" + condition(in.op >> 3) + ") {", &in);
+            line("    " + tick(cyc + 17, n));
+            line("    push(m, SP, " + next + ");");
+            line("    " + jump(in.target(), chained));
+            line("}");
+            line(tick(cyc + 11, n));
+            n = 0;
+        } else if (in.is_rcc()) {
+            line("if (" + condition(in.op >> 3) + ") {", &in);
+            line("    " + tick(cyc + 11, n));
+            line("    s.PC = pop(m, SP);");
+            line("    goto dispatch;");
+            line("}");
+            line(tick(cyc + 5, n));
+            n = 0;
+        } else if (in.is_jmp()) {
+            line(tick(cyc + 10, n), &in);
+            line(jump(in.target(), chained));
+            n = 0;
+        } else if (in.is_call() || in.is_rst()) {
+            // A push into translated code stops the chain at the target.
+            line(tick(cyc + cycles(in), n), &in);
+            line("push(m, SP, " + next + ");");
+            line(jump(in.target(), chained));
+            n = 0;
+        } else if (in.op == 0xE9 && known[i].has_pair(2)) {
+            line(tick(cyc + cycles(in), n), &in);    // PCHL to a known address
+            line(jump(known[i].pair(2), chained));
+            n = 0;
+        } else if (in.is_ret() || in.op == 0xE9) {
+            line(tick(cyc + cycles(in), n), &in);
+            line(in.op == 0xE9 ? "s.PC = pair(H, L);" : "s.PC = pop(m, SP);");
+            line("goto dispatch;");
+            n = 0;
+        } else if (in.op == 0x76) {
+            line("s.halted = true;", &in);
+            line(tick(cyc + 7, n));
+            line(leave(in.next()));
+            n = 0;
+        } else if (in.op == 0xFB) {
+            // Back to the runner, which must not take an interrupt before
+            // the next instruction.
+            line("s.inte = true; cx.ei = true;", &in);
+            line(tick(cyc + 4, n));
+            line(leave(in.next()));
+            n = 0;
+        } else {
+            cyc += cycles(in);
+            line(operation(in, live[i], known[i]), &in);
+            if (checked[i])
+                line(format("if (cx.smc && changed(cx, %s, %u)) { %s s.PC = %s; goto done; }", next.c_str(),
+                            unsigned(uint16_t(end - in.next())), tick(cyc, n).c_str(), next.c_str()));
+            if (i + 1 == count) {
+                line(tick(cyc, n));
+                n = 0;
+            }
+        }
+    }
+    // Fall through into the next block; a call or RST continues there only
+    // by way of a return.
+    const Insn& last = b.insns.back();
+    if (last.falls_through() && !last.is_call() && !last.is_rst() && last.op != 0x76 && last.op != 0xFB)
+        line(jump(last.next(), chained));
+    return out;
+}
+
+std::string Program::emit(const std::string& name, const std::string& source) const {
+    std::vector<std::pair<uint16_t, uint16_t>> ranges;
+    for (uint32_t a = 0; a < 0x10000; ++a) {
+        if (!is_code(uint16_t(a))) continue;
+        if (!ranges.empty() && ranges.back().first + ranges.back().second == a) ++ranges.back().second;
+        else ranges.push_back({uint16_t(a), 1});
+    }
+
+    std::set<uint16_t> chained;
+    std::map<uint16_t, std::string> bodies;
+    size_t insns = 0;
+    for (const auto& [addr, b] : blocks_) {
+        bodies[addr] = emit_block(b, chained);
+        insns += b.insns.size();
+    }
+
+    std::string out;
+    out += format("// Generated by native8080_aot from %s: do not edit.\n", source.c_str());
+    out += format("// %zu bytes at 0x%04X, %zu blocks, %zu instructions.\n\n",
+                  image_.size(), origin_, blocks_.size(), insns);
+    out += "#include \"aot.h\"\n\nnamespace {\n\n";
+
+    out += "const uint8_t IMAGE[] = {\n";
+    for (size_t i = 0; i < image_.size(); ++i)
+        out += format("%s0x%02X,%s", i % 16 ? " " : "    ", image_[i], i % 16 == 15 || i + 1 == image_.size() ? "\n" : "");
+    out += "};\n\nconst uint64_t CODE[1024] = {\n";
+    for (size_t i = 0; i < code_.size(); ++i)
+        out += format("%s0x%016llX,%s", i % 4 ? " " : "    ", static_cast<unsigned long long>(code_[i]),
+                      i % 4 == 3 ? "\n" : "");
+    out += "};\n\nconst AotRange CODE_RANGES[] = {\n";
+    for (const auto& [first, size] : ranges) out += format("    {0x%04X, %u},\n", first, size);
+    out += "};\n\n";
+
+    // Labels are only emitted where jumped to, so the output compiles
+    // without warnings.
+    const auto jumped_to = [&](const char* label) {
+        const std::string jump = std::string("goto ") + label + ";";
+        return std::any_of(bodies.begin(), bodies.end(),
+                           [&](const auto& body) { return body.second.find(jump) != std::string::npos; });
+    };
+    const bool dispatch_used = jumped_to("dispatch");
+    const bool done_used     = !chained.empty() || jumped_to("done");
+
+    out += "bool run(AotContext& cx) {\n"
+           "    using namespace aot;\n"
+           "    State8080&   s = cx.s;\n"
+           "    const Memory m{s.mem.data(), cx.program.code, cx};\n"
+           "    uint8_t      A = s.A, F = s.F, B = s.B, C = s.C, D = s.D, E = s.E, H = s.H, L = s.L;\n"
+           "    uint16_t     SP = s.SP;\n"
+           "    uint64_t     cycles = cx.cycles, insns = cx.instructions, slice_end = cx.slice_end;\n"
+           "    const uint64_t start = insns;\n"
+           "    const auto spill = [&] {\n"
+           "        s.A = A; s.F = F; s.B = B; s.C = C; s.D = D; s.E = E; s.H = H; s.L = L; s.SP = SP;\n"
+           "        cx.cycles = cycles; cx.instructions = insns;\n"
+           "    };\n"
+           "    [[maybe_unused]] const auto reload = [&] {\n"
+           "        A = s.A; F = s.F; B = s.B; C = s.C; D = s.D; E = s.E; H = s.H; L = s.L; SP = s.SP;\n"
+           "        cycles = cx.cycles; insns = cx.instructions; slice_end = cx.slice_end;\n"
+           "    };\n\n";
+    if (dispatch_used) out += "dispatch:\n";
+    out += "    switch (s.PC) {\n";
+    for (const auto& [addr, b] : blocks_)
+        out += format("        case 0x%04X: if (enter(cx, cycles, insns, slice_end, %d, %zu, 0x%04X, %u)) goto E_%04X; break;\n",
+                      addr, b.max_cycles, b.insns.size(), addr, b.size, addr);
+    out += "    }\n";
+    if (done_used) out += "done:\n";
+    out += "    spill();\n"
+           "    return insns != start;\n";
+
+    for (const auto& [addr, b] : blocks_) {
+        out += "\n";
+        if (chained.count(addr)) {
+            out += format("B_%04X:\n", addr);
+            out += format("    if (cycles + %d > slice_end || insns + %zu > cx.chain_insn_end) %s\n",
+                          b.max_cycles, b.insns.size(), leave(addr).c_str());
+        }
+        out += format("E_%04X:\n", addr);
+        out += bodies.at(addr);
+    }
+    out += "}\n\n";
+
+    out += "const AotProgram PROGRAM{\n";
+    out += format("    \"%s\", 0x%04X, IMAGE, sizeof IMAGE, CODE, CODE_RANGES,\n", name.c_str(), origin_);
+    out += format("    sizeof CODE_RANGES / sizeof CODE_RANGES[0], %zu, run,\n", blocks_.size());
+    out += "};\n\nconst AotRegistration registration(PROGRAM);\n\n}  // namespace\n";
+    return out;
+}
+
+void usage(const char* argv0) {
+    std::fprintf(stderr, "Usage: %s [-o OUT.cpp] [--name NAME] [--origin ADDR] [--entry ADDR]... IMAGE\n", argv0);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input, output, name;
+    uint16_t    origin = 0x0100;
+    std::vector<uint16_t> entries;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) output = argv[++i];
+        else if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) name = argv[++i];
+        else if (std::strcmp(argv[i], "--origin") == 0 && i + 1 < argc)
+            origin = uint16_t(std::strtoul(argv[++i], nullptr, 0));
+        else if (std::strcmp(argv[i], "--entry") == 0 && i + 1 < argc)
+            entries.push_back(uint16_t(std::strtoul(argv[++i], nullptr, 0)));
+        else if (argv[i][0] == '-' || !input.empty()) { usage(argv[0]); return 1; }
+        else input = argv[i];
+    }
+    if (input.empty()) { usage(argv[0]); return 1; }
+    const size_t slash = input.find_last_of('/');
+    const std::string file = slash == std::string::npos ? input : input.substr(slash + 1);
+    if (name.empty()) name = file.substr(0, file.find_last_of('.'));
+    if (output.empty()) output = input.substr(0, input.find_last_of('.')) + ".cpp";
+    entries.insert(entries.begin(), origin);
+
+    std::ifstream in(input, std::ios::binary);
+    if (!in) {
+        std::perror(input.c_str());
+        return 1;
+    }
+    std::vector<uint8_t> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    try {
+        Program program(std::move(image), origin);
+        program.discover(entries);
+        program.form_blocks();
+        const std::string text = program.emit(name, file);
+
+        std::FILE* f = std::fopen(output.c_str(), "w");
+        if (!f) { std::perror(output.c_str()); return 1; }
+        std::fwrite(text.data(), 1, text.size(), f);
+        std::fclose(f);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s: %s\n", input.c_str(), e.what());
+        return 1;
+    }
+    return 0;
+}
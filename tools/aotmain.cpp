@@ -0,0 +1,7 @@
+// ─── Stand-alone translated program ───────────────────────────────────────────
+// Linked with one source from native8080_aot, runs that program under the
+// CP/M shim; see AotMain() in aot.h.
+
+#include "aot.h"
+
+int main(int argc, char* argv[]) { return AotMain(argc, argv); }
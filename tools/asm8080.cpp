@@ -0,0 +1,560 @@
+// ─── native8080_asm ───────────────────────────────────────────────────────────
+// Small two-pass Intel 8080 assembler.  The build uses it to turn the
+// benchmark workloads in bench/workloads/*.asm into .COM images, so the
+// corpus needs nothing beyond this repository.
+//
+// Syntax (Intel mnemonics, case-insensitive; symbols are case-sensitive):
+//   label:  MNEMONIC operand, operand   ; comment
+//   NAME    EQU   expr
+//   ORG expr / DB expr|'string', ... / DW expr, ... / DS expr / END
+//   INCLUDE "file"                      ; relative to the including file
+// Expressions: decimal, 0x1F, 1FH, 1010B, 'c', $ (current address), symbols,
+// HIGH(x), LOW(x) and the C operators  ( ) ~ - * / % + - << >> & ^ |
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Line {
+    std::string              file;
+    int                      lineno = 0;
+    std::string              label;
+    std::string              op;       // upper-cased mnemonic / directive
+    std::vector<std::string> args;
+};
+
+struct AsmError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+std::string upper(std::string s) {
+    for (char& c : s) c = char(std::toupper(static_cast<unsigned char>(c)));
+    return s;
+}
+
+std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return {};
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+bool is_ident_start(char c) { return std::isalpha(static_cast<unsigned char>(c)) || c == '_' || c == '.'; }
+bool is_ident_char (char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.'; }
+
+// Strip a trailing comment, ignoring ';' inside quotes.
+std::string strip_comment(const std::string& s) {
+    char quote = 0;
+    for (size_t i = 0; i < s.size(); ++i) {
+        char c = s[i];
+        if (quote) { if (c == quote) quote = 0; }
+        else if (c == '\'' || c == '"') quote = c;
+        else if (c == ';') return s.substr(0, i);
+    }
+    return s;
+}
+
+// Split operands on commas outside quotes and parentheses.
+std::vector<std::string> split_args(const std::string& s) {
+    std::vector<std::string> out;
+    std::string cur;
+    char quote = 0;
+    int  depth = 0;
+    for (char c : s) {
+        if (quote) { cur += c; if (c == quote) quote = 0; continue; }
+        if (c == '\'' || c == '"') { quote = c; cur += c; continue; }
+        if (c == '(') ++depth;
+        if (c == ')') --depth;
+        if (c == ',' && depth == 0) { out.push_back(trim(cur)); cur.clear(); continue; }
+        cur += c;
+    }
+    if (!trim(cur).empty() || !out.empty()) out.push_back(trim(cur));
+    return out;
+}
+
+// ─── Assembler ────────────────────────────────────────────────────────────────
+class Assembler {
+public:
+    void load(const std::string& path, int depth = 0);
+    std::vector<uint8_t> assemble(uint16_t& origin);
+
+private:
+    // Expression evaluation
+    struct Expr {
+        const std::string& text;
+        size_t             pos = 0;
+    };
+    int32_t eval(const std::string& text);
+    int32_t parse_or (Expr& e);
+    int32_t parse_xor(Expr& e);
+    int32_t parse_and(Expr& e);
+    int32_t parse_shift(Expr& e);
+    int32_t parse_add(Expr& e);
+    int32_t parse_mul(Expr& e);
+    int32_t parse_unary(Expr& e);
+    int32_t parse_primary(Expr& e);
+    void    skip_ws(Expr& e);
+
+    // Emission
+    void emit8 (int32_t v);
+    void emit16(int32_t v);
+    void line(const Line& l);
+    uint8_t reg(const std::string& s);
+    uint8_t rp (const std::string& s, bool psw);
+    [[noreturn]] void fail(const std::string& msg) const;
+    void want_args(size_t n) const;
+
+    std::vector<Line>              lines_;
+    std::map<std::string, int32_t> symbols_;
+    const Line*                    cur_ = nullptr;
+    int                            pass_ = 1;
+    bool                           unresolved_ = false;
+    uint32_t                       pc_ = 0;
+    std::vector<uint8_t>           image_ = std::vector<uint8_t>(0x10000, 0);
+    uint32_t                       lo_ = 0x10000, hi_ = 0;
+    bool                           ended_ = false;
+};
+
+void Assembler::fail(const std::string& msg) const {
+    std::ostringstream os;
+    if (cur_) os << cur_->file << ":" << cur_->lineno << ": ";
+    os << msg;
+    throw AsmError(os.str());
+}
+
+void Assembler::load(const std::string& path, int depth) {
+    if (depth > 8) throw AsmError(path + ": INCLUDE nested too deeply");
+    std::ifstream in(path);
+    if (!in) throw AsmError("cannot open " + path);
+
+    std::string dir;
+    size_t slash = path.find_last_of('/');
+    if (slash != std::string::npos) dir = path.substr(0, slash + 1);
+
+    std::string raw;
+    int lineno = 0;
+    while (std::getline(in, raw)) {
+        ++lineno;
+        std::string s = trim(strip_comment(raw));
+        if (s.empty()) continue;
+
+        Line l;
+        l.file   = path;
+        l.lineno = lineno;
+
+        // Leading "label:" or "NAME EQU ..."
+        size_t i = 0;
+        if (is_ident_start(s[0])) {
+            while (i < s.size() && is_ident_char(s[i])) ++i;
+            if (i < s.size() && s[i] == ':') {
+                l.label = s.substr(0, i);
+                s = trim(s.substr(i + 1));
+            } else {
+                std::string rest = trim(s.substr(i));
+                size_t j = 0;
+                while (j < rest.size() && is_ident_char(rest[j])) ++j;
+                if (upper(rest.substr(0, j)) == "EQU") {
+                    l.label = s.substr(0, i);
+                    s = rest;
+                }
+            }
+        }
+
+        if (!s.empty()) {
+            size_t j = 0;
+            while (j < s.size() && !std::isspace(static_cast<unsigned char>(s[j]))) ++j;
+            l.op = upper(s.substr(0, j));
+            std::string rest = trim(s.substr(j));
+            if (!rest.empty()) l.args = split_args(rest);
+        }
+
+        if (l.op == "INCLUDE") {
+            if (l.args.size() != 1 || l.args[0].size() < 2)
+                throw AsmError(path + ":" + std::to_string(lineno) + ": INCLUDE needs a file name");
+            std::string name = l.args[0];
+            if (name.front() == '"' || name.front() == '\'') name = name.substr(1, name.size() - 2);
+            if (!l.label.empty()) { l.op.clear(); l.args.clear(); lines_.push_back(l); }
+            load(name[0] == '/' ? name : dir + name, depth + 1);
+            continue;
+        }
+        lines_.push_back(std::move(l));
+    }
+}
+
+// ── Expressions ─────────────────────────────────────────────────────────────
+void Assembler::skip_ws(Expr& e) {
+    while (e.pos < e.text.size() && std::isspace(static_cast<unsigned char>(e.text[e.pos]))) ++e.pos;
+}
+
+int32_t Assembler::eval(const std::string& text) {
+    Expr e{text};
+    int32_t v = parse_or(e);
+    skip_ws(e);
+    if (e.pos != text.size()) fail("unexpected '" + text.substr(e.pos) + "' in expression");
+    return v;
+}
+
+int32_t Assembler::parse_or(Expr& e) {
+    int32_t v = parse_xor(e);
+    for (;;) {
+        skip_ws(e);
+        if (e.pos < e.text.size() && e.text[e.pos] == '|') { ++e.pos; v |= parse_xor(e); }
+        else return v;
+    }
+}
+
+int32_t Assembler::parse_xor(Expr& e) {
+    int32_t v = parse_and(e);
+    for (;;) {
+        skip_ws(e);
+        if (e.pos < e.text.size() && e.text[e.pos] == '^') { ++e.pos; v ^= parse_and(e); }
+        else return v;
+    }
+}
+
+int32_t Assembler::parse_and(Expr& e) {
+    int32_t v = parse_shift(e);
+    for (;;) {
+        skip_ws(e);
+        if (e.pos < e.text.size() && e.text[e.pos] == '&') { ++e.pos; v &= parse_shift(e); }
+        else return v;
+    }
+}
+
+int32_t Assembler::parse_shift(Expr& e) {
+    int32_t v = parse_add(e);
+    for (;;) {
+        skip_ws(e);
+        if (e.text.compare(e.pos, 2, "<<") == 0)      { e.pos += 2; v = int32_t(uint32_t(v) << (parse_add(e) & 31)); }
+        else if (e.text.compare(e.pos, 2, ">>") == 0) { e.pos += 2; v = int32_t(uint32_t(v) >> (parse_add(e) & 31)); }
+        else return v;
+    }
+}
+
+int32_t Assembler::parse_add(Expr& e) {
+    int32_t v = parse_mul(e);
+    for (;;) {
+        skip_ws(e);
+        if (e.pos >= e.text.size()) return v;
+        char c = e.text[e.pos];
+        if (c == '+')      { ++e.pos; v += parse_mul(e); }
+        else if (c == '-') { ++e.pos; v -= parse_mul(e); }
+        else return v;
+    }
+}
+
+int32_t Assembler::parse_mul(Expr& e) {
+    int32_t v = parse_unary(e);
+    for (;;) {
+        skip_ws(e);
+        if (e.pos >= e.text.size()) return v;
+        char c = e.text[e.pos];
+        if (c != '*' && c != '/' && c != '%') return v;
+        ++e.pos;
+        int32_t r = parse_unary(e);
+        if (c == '*') { v *= r; continue; }
+        if (r == 0) { if (unresolved_) { v = 0; continue; } fail("division by zero"); }
+        v = (c == '/') ? v / r : v % r;
+    }
+}
+
+int32_t Assembler::parse_unary(Expr& e) {
+    skip_ws(e);
+    if (e.pos < e.text.size()) {
+        char c = e.text[e.pos];
+        if (c == '-') { ++e.pos; return -parse_unary(e); }
+        if (c == '+') { ++e.pos; return  parse_unary(e); }
+        if (c == '~') { ++e.pos; return ~parse_unary(e); }
+    }
+    return parse_primary(e);
+}
+
+int32_t Assembler::parse_primary(Expr& e) {
+    skip_ws(e);
+    const std::string& t = e.text;
+    if (e.pos >= t.size()) fail("missing operand in expression");
+    char c = t[e.pos];
+
+    if (c == '(') {
+        ++e.pos;
+        int32_t v = parse_or(e);
+        skip_ws(e);
+        if (e.pos >= t.size() || t[e.pos] != ')') fail("missing ')'");
+        ++e.pos;
+        return v;
+    }
+    if (c == '$') {
+        ++e.pos;
+        return int32_t(pc_);
+    }
+    if (c == '\'' || c == '"') {
+        if (e.pos + 2 >= t.size() || t[e.pos + 2] != c) fail("bad character literal");
+        int32_t v = static_cast<unsigned char>(t[e.pos + 1]);
+        e.pos += 3;
+        return v;
+    }
+    if (std::isdigit(static_cast<unsigned char>(c))) {
+        size_t b = e.pos;
+        while (e.pos < t.size() && std::isalnum(static_cast<unsigned char>(t[e.pos]))) ++e.pos;
+        std::string tok = upper(t.substr(b, e.pos - b));
+        int base = 10;
+        if (tok.size() > 2 && tok[0] == '0' && tok[1] == 'X') { tok = tok.substr(2); base = 16; }
+        else if (tok.back() == 'H') { tok.pop_back(); base = 16; }
+        else if (tok.back() == 'B' && tok.find_first_not_of("01", 0) == tok.size() - 1) { tok.pop_back(); base = 2; }
+        size_t used = 0;
+        long v = 0;
+        try { v = std::stol(tok, &used, base); } catch (...) { used = 0; }
+        if (tok.empty() || used != tok.size()) fail("bad number '" + t.substr(b, e.pos - b) + "'");
+        return int32_t(v);
+    }
+    if (is_ident_start(c)) {
+        size_t b = e.pos;
+        while (e.pos < t.size() && is_ident_char(t[e.pos])) ++e.pos;
+        std::string name = t.substr(b, e.pos - b);
+        std::string uname = upper(name);
+        if (uname == "HIGH" || uname == "LOW") {
+            int32_t v = parse_primary(e);
+            return uname == "HIGH" ? (v >> 8) & 0xFF : v & 0xFF;
+        }
+        auto it = symbols_.find(name);
+        if (it == symbols_.end()) {
+            if (pass_ == 2) fail("undefined symbol '" + name + "'");
+            unresolved_ = true;
+            return 0;
+        }
+        return it->second;
+    }
+    fail(std::string("unexpected '") + c + "' in expression");
+}
+
+// ── Operands ────────────────────────────────────────────────────────────────
+uint8_t Assembler::reg(const std::string& s) {
+    static const char* const names[8] = {"B", "C", "D", "E", "H", "L", "M", "A"};
+    std::string u = upper(s);
+    for (uint8_t i = 0; i < 8; ++i)
+        if (u == names[i]) return i;
+    fail("expected register, got '" + s + "'");
+}
+
+uint8_t Assembler::rp(const std::string& s, bool psw) {
+    std::string u = upper(s);
+    if (u == "B" || u == "BC") return 0;
+    if (u == "D" || u == "DE") return 1;
+    if (u == "H" || u == "HL") return 2;
+    if (!psw && u == "SP")  return 3;
+    if (psw  && u == "PSW") return 3;
+    fail("expected register pair, got '" + s + "'");
+}
+
+void Assembler::want_args(size_t n) const {
+    if (cur_->args.size() != n)
+        fail(cur_->op + " expects " + std::to_string(n) + " operand(s)");
+}
+
+void Assembler::emit8(int32_t v) {
+    if (pass_ == 2 && (v < -128 || v > 255)) fail("byte value out of range: " + std::to_string(v));
+    if (pc_ > 0xFFFF) fail("program exceeds 64 KB");
+    if (pass_ == 2) {
+        image_[pc_] = uint8_t(v);
+        lo_ = std::min(lo_, pc_);
+        hi_ = std::max(hi_, pc_ + 1);
+    }
+    ++pc_;
+}
+
+void Assembler::emit16(int32_t v) {
+    if (pass_ == 2 && (v < -32768 || v > 0xFFFF)) fail("word value out of range: " + std::to_string(v));
+    emit8(v & 0xFF);
+    emit8((v >> 8) & 0xFF);
+}
+
+// ── One source line ─────────────────────────────────────────────────────────
+void Assembler::line(const Line& l) {
+    cur_ = &l;
+    const std::string& op = l.op;
+    const auto& a = l.args;
+
+    if (op == "EQU") {
+        if (l.label.empty()) fail("EQU without a name");
+        want_args(1);
+        unresolved_ = false;
+        int32_t v = eval(a[0]);
+        if (pass_ == 1 && symbols_.count(l.label) && !unresolved_ && symbols_[l.label] != v)
+            fail("symbol '" + l.label + "' redefined");
+        symbols_[l.label] = v;
+        return;
+    }
+
+    if (!l.label.empty()) {
+        if (pass_ == 1 && symbols_.count(l.label)) fail("duplicate label '" + l.label + "'");
+        symbols_[l.label] = int32_t(pc_);
+    }
+    if (op.empty()) return;
+
+    // ── Directives ──
+    if (op == "ORG") {
+        want_args(1);
+        unresolved_ = false;
+        int32_t v = eval(a[0]);
+        if (unresolved_) fail("ORG needs a value known in pass 1");
+        pc_ = uint32_t(v) & 0xFFFF;
+        return;
+    }
+    if (op == "DS") {
+        want_args(1);
+        unresolved_ = false;
+        int32_t v = eval(a[0]);
+        if (unresolved_ || v < 0) fail("DS needs a non-negative value known in pass 1");
+        pc_ += uint32_t(v);
+        return;
+    }
+    if (op == "DB") {
+        for (const std::string& s : a) {
+            if (s.size() >= 2 && (s.front() == '"' || (s.front() == '\'' && s.size() != 3)) && s.back() == s.front()) {
+                for (size_t i = 1; i + 1 < s.size(); ++i) emit8(static_cast<unsigned char>(s[i]));
+            } else {
+                emit8(eval(s));
+            }
+        }
+        return;
+    }
+    if (op == "DW") {
+        for (const std::string& s : a) emit16(eval(s));
+        return;
+    }
+    if (op == "END") { ended_ = true; return; }
+
+    // ── Instructions ──
+    struct Fixed { const char* name; uint8_t code; };
+    static const Fixed implied[] = {
+        {"NOP", 0x00}, {"HLT", 0x76}, {"RLC", 0x07}, {"RRC", 0x0F}, {"RAL", 0x17},
+        {"RAR", 0x1F}, {"DAA", 0x27}, {"CMA", 0x2F}, {"STC", 0x37}, {"CMC", 0x3F},
+        {"RET", 0xC9}, {"XCHG", 0xEB}, {"XTHL", 0xE3}, {"SPHL", 0xF9}, {"PCHL", 0xE9},
+        {"EI", 0xFB}, {"DI", 0xF3},
+        {"RNZ", 0xC0}, {"RZ", 0xC8}, {"RNC", 0xD0}, {"RC", 0xD8},
+        {"RPO", 0xE0}, {"RPE", 0xE8}, {"RP", 0xF0}, {"RM", 0xF8},
+    };
+    static const Fixed alu_reg[] = {
+        {"ADD", 0x80}, {"ADC", 0x88}, {"SUB", 0x90}, {"SBB", 0x98},
+        {"ANA", 0xA0}, {"XRA", 0xA8}, {"ORA", 0xB0}, {"CMP", 0xB8},
+    };
+    static const Fixed imm8[] = {
+        {"ADI", 0xC6}, {"ACI", 0xCE}, {"SUI", 0xD6}, {"SBI", 0xDE},
+        {"ANI", 0xE6}, {"XRI", 0xEE}, {"ORI", 0xF6}, {"CPI", 0xFE},
+        {"IN", 0xDB}, {"OUT", 0xD3},
+    };
+    static const Fixed addr16[] = {
+        {"JMP", 0xC3}, {"JNZ", 0xC2}, {"JZ", 0xCA}, {"JNC", 0xD2}, {"JC", 0xDA},
+        {"JPO", 0xE2}, {"JPE", 0xEA}, {"JP", 0xF2}, {"JM", 0xFA},
+        {"CALL", 0xCD}, {"CNZ", 0xC4}, {"CZ", 0xCC}, {"CNC", 0xD4}, {"CC", 0xDC},
+        {"CPO", 0xE4}, {"CPE", 0xEC}, {"CP", 0xF4}, {"CM", 0xFC},
+        {"LDA", 0x3A}, {"STA", 0x32}, {"LHLD", 0x2A}, {"SHLD", 0x22},
+    };
+
+    for (const Fixed& f : implied)
+        if (op == f.name) { want_args(0); emit8(f.code); return; }
+    for (const Fixed& f : alu_reg)
+        if (op == f.name) { want_args(1); emit8(f.code | reg(a[0])); return; }
+    for (const Fixed& f : imm8)
+        if (op == f.name) { want_args(1); emit8(f.code); emit8(eval(a[0])); return; }
+    for (const Fixed& f : addr16)
+        if (op == f.name) { want_args(1); emit8(f.code); emit16(eval(a[0])); return; }
+
+    if (op == "MOV") {
+        want_args(2);
+        uint8_t d = reg(a[0]), s = reg(a[1]);
+        if (d == 6 && s == 6) fail("MOV M,M is HLT");
+        emit8(0x40 | (d << 3) | s);
+        return;
+    }
+    if (op == "MVI") { want_args(2); emit8(0x06 | (reg(a[0]) << 3)); emit8(eval(a[1])); return; }
+    if (op == "INR") { want_args(1); emit8(0x04 | (reg(a[0]) << 3)); return; }
+    if (op == "DCR") { want_args(1); emit8(0x05 | (reg(a[0]) << 3)); return; }
+    if (op == "LXI") { want_args(2); emit8(0x01 | (rp(a[0], false) << 4)); emit16(eval(a[1])); return; }
+    if (op == "DAD") { want_args(1); emit8(0x09 | (rp(a[0], false) << 4)); return; }
+    if (op == "INX") { want_args(1); emit8(0x03 | (rp(a[0], false) << 4)); return; }
+    if (op == "DCX") { want_args(1); emit8(0x0B | (rp(a[0], false) << 4)); return; }
+    if (op == "PUSH") { want_args(1); emit8(0xC5 | (rp(a[0], true) << 4)); return; }
+    if (op == "POP")  { want_args(1); emit8(0xC1 | (rp(a[0], true) << 4)); return; }
+    if (op == "LDAX" || op == "STAX") {
+        want_args(1);
+        uint8_t p = rp(a[0], false);
+        if (p > 1) fail(op + " only takes B or D");
+        emit8((op == "LDAX" ? 0x0A : 0x02) | (p << 4));
+        return;
+    }
+    if (op == "RST") {
+        want_args(1);
+        int32_t n = eval(a[0]);
+        if (n < 0 || n > 7) fail("RST vector must be 0-7");
+        emit8(0xC7 | (n << 3));
+        return;
+    }
+    fail("unknown mnemonic '" + op + "'");
+}
+
+std::vector<uint8_t> Assembler::assemble(uint16_t& origin) {
+    for (pass_ = 1; pass_ <= 2; ++pass_) {
+        pc_ = 0;
+        ended_ = false;
+        for (const Line& l : lines_) {
+            line(l);
+            if (ended_) break;
+        }
+    }
+    if (hi_ <= lo_) throw AsmError("no code generated");
+    origin = uint16_t(lo_);
+    return std::vector<uint8_t>(image_.begin() + lo_, image_.begin() + hi_);
+}
+
+void usage(const char* argv0) {
+    std::fprintf(stderr, "Usage: %s [-o output.com] [-s] input.asm\n", argv0);
+    std::fprintf(stderr, "  -o FILE  output image (default: input with .com extension)\n");
+    std::fprintf(stderr, "  -s       print the origin and size on stdout\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input, output;
+    bool summary = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) output = argv[++i];
+        else if (std::strcmp(argv[i], "-s") == 0) summary = true;
+        else if (argv[i][0] == '-' || !input.empty()) { usage(argv[0]); return 1; }
+        else input = argv[i];
+    }
+    if (input.empty()) { usage(argv[0]); return 1; }
+    if (output.empty()) {
+        size_t dot = input.find_last_of('.');
+        output = (dot == std::string::npos ? input : input.substr(0, dot)) + ".com";
+    }
+
+    try {
+        Assembler as;
+        as.load(input);
+        uint16_t origin = 0;
+        std::vector<uint8_t> image = as.assemble(origin);
+
+        std::FILE* f = std::fopen(output.c_str(), "wb");
+        if (!f) { std::perror(output.c_str()); return 1; }
+        std::fwrite(image.data(), 1, image.size(), f);
+        std::fclose(f);
+        if (summary)
+            std::printf("%s: %zu bytes at 0x%04X\n", output.c_str(), image.size(), origin);
+    } catch (const AsmError& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
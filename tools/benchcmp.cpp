@@ -0,0 +1,264 @@
+// ─── native8080_benchcmp ───────────────────────────────────────────────────────
+// Compares two benchmark result files written with `--json` by
+// native8080_bench or native8080_macrobench and flags performance regressions.
+//
+// Results are matched by (workload, engine) and compared on median
+// instructions per second.  A change only counts as significant when it
+// exceeds both a fixed relative threshold and a multiple of the measured
+// run-to-run noise:
+//
+//     noise     = sqrt(cv_base^2 + cv_current^2)   (cv = stddev / mean of samples)
+//     threshold = max(--threshold, --sigma * noise)
+//
+// Exit status: 0 = no significant regression, 1 = regression, 2 = error.
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// ─── Minimal JSON reader ──────────────────────────────────────────────────────
+// Just enough JSON for the result files: objects, arrays, strings, numbers,
+// booleans and null.
+struct Json {
+    enum Kind { Null, Bool, Number, String, Array, Object } kind = Null;
+    bool                        b = false;
+    double                      n = 0.0;
+    std::string                 s;
+    std::vector<Json>           a;
+    std::map<std::string, Json> o;
+
+    const Json* get(const std::string& key) const {
+        auto it = o.find(key);
+        return it == o.end() ? nullptr : &it->second;
+    }
+    double num(const std::string& key, double def = 0.0) const {
+        const Json* v = get(key);
+        return v && v->kind == Number ? v->n : def;
+    }
+    std::string str(const std::string& key) const {
+        const Json* v = get(key);
+        return v && v->kind == String ? v->s : std::string();
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : t_(text) {}
+
+    Json parse() {
+        Json v = value();
+        ws();
+        if (p_ != t_.size()) fail("trailing characters");
+        return v;
+    }
+
+private:
+    [[noreturn]] void fail(const char* what) {
+        throw std::runtime_error(std::string(what) + " at offset " + std::to_string(p_));
+    }
+    void ws() { while (p_ < t_.size() && std::isspace(static_cast<unsigned char>(t_[p_]))) ++p_; }
+    bool eat(char c) { ws(); if (p_ < t_.size() && t_[p_] == c) { ++p_; return true; } return false; }
+    void expect(char c) { if (!eat(c)) fail("unexpected character"); }
+
+    Json value() {
+        ws();
+        if (p_ >= t_.size()) fail("unexpected end of input");
+        Json v;
+        char c = t_[p_];
+        if (c == '{') {
+            v.kind = Json::Object;
+            ++p_;
+            if (eat('}')) return v;
+            do {
+                ws();
+                std::string key = string();
+                expect(':');
+                v.o[key] = value();
+            } while (eat(','));
+            expect('}');
+        } else if (c == '[') {
+            v.kind = Json::Array;
+            ++p_;
+            if (eat(']')) return v;
+            do { v.a.push_back(value()); } while (eat(','));
+            expect(']');
+        } else if (c == '"') {
+            v.kind = Json::String;
+            v.s = string();
+        } else if (t_.compare(p_, 4, "true") == 0)  { v.kind = Json::Bool; v.b = true;  p_ += 4; }
+        else if (t_.compare(p_, 5, "false") == 0)   { v.kind = Json::Bool; v.b = false; p_ += 5; }
+        else if (t_.compare(p_, 4, "null") == 0)    { p_ += 4; }
+        else {
+            const char* begin = t_.c_str() + p_;
+            char* end = nullptr;
+            v.kind = Json::Number;
+            v.n = std::strtod(begin, &end);
+            if (end == begin) fail("bad value");
+            p_ += size_t(end - begin);
+        }
+        return v;
+    }
+
+    std::string string() {
+        if (p_ >= t_.size() || t_[p_] != '"') fail("expected string");
+        ++p_;
+        std::string out;
+        while (p_ < t_.size() && t_[p_] != '"') {
+            char c = t_[p_++];
+            if (c != '\\') { out += c; continue; }
+            if (p_ >= t_.size()) break;
+            char e = t_[p_++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    if (p_ + 4 > t_.size()) fail("bad escape");
+                    unsigned long cp = std::strtoul(t_.substr(p_, 4).c_str(), nullptr, 16);
+                    out += cp < 0x80 ? char(cp) : '?';
+                    p_ += 4;
+                    break;
+                }
+                default: out += e; break;
+            }
+        }
+        if (p_ >= t_.size()) fail("unterminated string");
+        ++p_;
+        return out;
+    }
+
+    const std::string& t_;
+    size_t             p_ = 0;
+};
+
+Json load(const char* path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error(std::string("cannot open ") + path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    Json root = JsonParser(ss.str()).parse();
+    if (root.kind != Json::Object || !root.get("results") || root.get("results")->kind != Json::Array)
+        throw std::runtime_error(std::string(path) + ": not a benchmark result file");
+    return root;
+}
+
+// ─── Statistics ───────────────────────────────────────────────────────────────
+struct Entry {
+    double median = 0.0;
+    double cv     = 0.0;   // coefficient of variation of the samples
+};
+
+Entry summarize(const Json& r) {
+    Entry e;
+    e.median = r.num("instructions_per_sec");
+    const Json* s = r.get("samples");
+    if (!s || s->kind != Json::Array || s->a.size() < 2) return e;
+    double sum = 0.0, sq = 0.0;
+    for (const Json& v : s->a) { sum += v.n; sq += v.n * v.n; }
+    double n    = double(s->a.size());
+    double mean = sum / n;
+    double var  = std::max(0.0, (sq - sum * sum / n) / (n - 1));
+    e.cv = mean > 0.0 ? std::sqrt(var) / mean : 0.0;
+    return e;
+}
+
+std::map<std::string, Entry> index(const Json& root) {
+    std::map<std::string, Entry> out;
+    for (const Json& r : root.get("results")->a)
+        out[r.str("workload") + " [" + r.str("engine") + "]"] = summarize(r);
+    return out;
+}
+
+std::string field(const Json& root, const char* section, const char* key) {
+    const Json* s = root.get(section);
+    return s ? s->str(key) : std::string();
+}
+
+void usage(const char* argv0) {
+    std::fprintf(stderr, "Usage: %s [--threshold PCT] [--sigma K] baseline.json current.json\n", argv0);
+    std::fprintf(stderr, "  --threshold PCT  smallest relative change considered significant (default 5)\n");
+    std::fprintf(stderr, "  --sigma K        required multiple of the combined noise (default 3)\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double threshold = 0.05;
+    double sigma     = 3.0;
+    std::vector<const char*> files;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) threshold = std::strtod(argv[++i], nullptr) / 100.0;
+        else if (std::strcmp(argv[i], "--sigma") == 0 && i + 1 < argc) sigma = std::strtod(argv[++i], nullptr);
+        else if (argv[i][0] == '-') { usage(argv[0]); return 2; }
+        else files.push_back(argv[i]);
+    }
+    if (files.size() != 2) { usage(argv[0]); return 2; }
+
+    Json base, cur;
+    try {
+        base = load(files[0]);
+        cur  = load(files[1]);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "benchcmp: %s\n", e.what());
+        return 2;
+    }
+
+    // Comparisons across machines or build flags are legal but suspect.
+    static const char* const context[][2] = {
+        {"host", "cpu"}, {"build", "compiler"}, {"build", "build_type"}, {"build", "flags"},
+    };
+    for (const auto& c : context) {
+        std::string a = field(base, c[0], c[1]), b = field(cur, c[0], c[1]);
+        if (a != b)
+            std::fprintf(stderr, "note: %s.%s differs: \"%s\" vs \"%s\"\n", c[0], c[1], a.c_str(), b.c_str());
+    }
+
+    std::map<std::string, Entry> before = index(base);
+    std::map<std::string, Entry> after  = index(cur);
+
+    std::printf("%-28s %12s %12s %9s %9s  %s\n", "benchmark", "base MIPS", "cur MIPS", "change", "limit", "verdict");
+    int regressions = 0;
+    for (const auto& [name, b] : before) {
+        auto it = after.find(name);
+        if (it == after.end()) {
+            std::printf("%-28s %12.1f %12s %9s %9s  missing\n", name.c_str(), b.median / 1e6, "-", "-", "-");
+            continue;
+        }
+        const Entry& c = it->second;
+        if (b.median <= 0.0) continue;
+
+        double change = c.median / b.median - 1.0;
+        double noise  = std::sqrt(b.cv * b.cv + c.cv * c.cv);
+        double limit  = std::max(threshold, sigma * noise);
+
+        const char* verdict = "~";
+        if (change < -limit)      { verdict = "REGRESSION"; ++regressions; }
+        else if (change > limit)  { verdict = "faster"; }
+
+        std::printf("%-28s %12.1f %12.1f %+8.1f%% %8.1f%%  %s\n",
+                    name.c_str(), b.median / 1e6, c.median / 1e6, change * 100.0, limit * 100.0, verdict);
+    }
+    for (const auto& [name, c] : after)
+        if (!before.count(name))
+            std::printf("%-28s %12s %12.1f %9s %9s  new\n", name.c_str(), "-", c.median / 1e6, "-", "-");
+
+    if (regressions) {
+        std::printf("\n%d significant regression%s\n", regressions, regressions == 1 ? "" : "s");
+        return 1;
+    }
+    return 0;
+}